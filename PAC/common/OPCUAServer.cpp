@@ -198,6 +198,113 @@ void OPCUA_server::create_PAC_info()
     is_PAC_info_created = true;
     }
 
+void OPCUA_server::create_io_nodes_stat()
+    {
+    if ( !server ) return;
+    if ( is_io_nodes_stat_created ) return;
+
+    struct stat_var
+        {
+        const char* name;
+        const time_histogram io_manager::io_node::* hist;
+        u_int percent;
+        };
+    const stat_var VARS[] = {
+        { "recv_p50", &io_manager::io_node::recv_hist, 50 },
+        { "recv_p95", &io_manager::io_node::recv_hist, 95 },
+        { "recv_p99", &io_manager::io_node::recv_hist, 99 },
+        { "recv_max", &io_manager::io_node::recv_hist, 100 },
+        { "send_p99", &io_manager::io_node::send_hist, 99 },
+        { "send_max", &io_manager::io_node::send_hist, 100 },
+        { "connect_p99", &io_manager::io_node::connect_hist, 99 },
+        { "connect_max", &io_manager::io_node::connect_hist, 100 } };
+    const auto VARS_CNT = sizeof( VARS ) / sizeof( VARS[ 0 ] );
+
+    // Контексты переменных заполняются заранее, чтобы их адреса не менялись.
+    auto nodes_count = G_IO_MANAGER()->get_nodes_count();
+    io_nodes_stat.clear();
+    io_nodes_stat.reserve( nodes_count * VARS_CNT );
+    for ( u_int i = 0; i < nodes_count; i++ )
+        {
+        for ( const auto& var : VARS )
+            {
+            io_nodes_stat.push_back(
+                { G_IO_MANAGER()->get_node( i ), var.hist, var.percent } );
+            }
+        }
+
+    UA_NodeId nodes_root;
+    //Create root object node.
+    UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
+    oAttr.displayName = UA_LOCALIZEDTEXT_ALLOC( "en-US", "io_nodes" );
+    oAttr.description = UA_LOCALIZEDTEXT_ALLOC( "ru-ru", "io_nodes" );
+    UA_QualifiedName qn = UA_QUALIFIEDNAME_ALLOC( 1, "io_nodes" );
+    UA_Server_addObjectNode( server, UA_NODEID_NULL,
+        UA_NODEID_NUMERIC( 0, UA_NS0ID_OBJECTSFOLDER ),
+        UA_NODEID_NUMERIC( 0, UA_NS0ID_ORGANIZES ),
+        qn,
+        UA_NODEID_NUMERIC( 0, UA_NS0ID_BASEOBJECTTYPE ),
+        oAttr, nullptr, &nodes_root );
+    UA_ObjectAttributes_clear( &oAttr );
+    UA_QualifiedName_clear( &qn );
+
+    for ( u_int i = 0; i < nodes_count; i++ )
+        {
+        UA_NodeId nodeId;
+        auto node = G_IO_MANAGER()->get_node( i );
+
+        //Create object node.
+        oAttr.displayName = UA_LOCALIZEDTEXT_ALLOC( "en-US", node->name );
+        oAttr.description = UA_LOCALIZEDTEXT_ALLOC( "ru-ru", node->ip_address );
+        qn = UA_QUALIFIEDNAME_ALLOC( 1, node->name );
+        UA_Server_addObjectNode( server, UA_NODEID_NULL,
+            nodes_root,
+            UA_NODEID_NUMERIC( 0, UA_NS0ID_ORGANIZES ),
+            qn,
+            UA_NODEID_NUMERIC( 0, UA_NS0ID_BASEOBJECTTYPE ),
+            oAttr, nullptr, &nodeId );
+        UA_ObjectAttributes_clear( &oAttr );
+        UA_QualifiedName_clear( &qn );
+
+        for ( u_int j = 0; j < VARS_CNT; j++ )
+            {
+            //Creating statistics variable node (read only).
+            UA_VariableAttributes statAttr = UA_VariableAttributes_default;
+            statAttr.accessLevel = UA_ACCESSLEVELMASK_READ;
+            UA_UInt32 value = 0;
+            UA_Variant_setScalarCopy( &statAttr.value, &value,
+                &UA_TYPES[ UA_TYPES_UINT32 ] );
+
+            std::string node_name = "io_nodes.";
+            node_name += node->name;
+            node_name += ".";
+            node_name += VARS[ j ].name;
+
+            statAttr.displayName = UA_LOCALIZEDTEXT_ALLOC( "en-US", VARS[ j ].name );
+            statAttr.dataType = UA_TYPES[ UA_TYPES_UINT32 ].typeId;
+            UA_NodeId statNodeId = UA_NODEID_STRING_ALLOC( 0, node_name.c_str() );
+
+            qn = UA_QUALIFIEDNAME_ALLOC( 1, VARS[ j ].name );
+            UA_Server_addVariableNode( server, statNodeId, nodeId,
+                UA_NODEID_NUMERIC( 0, UA_NS0ID_HASCOMPONENT ),
+                qn,
+                UA_NODEID_NUMERIC( 0, UA_NS0ID_BASEDATAVARIABLETYPE ),
+                statAttr, &io_nodes_stat[ i * VARS_CNT + j ], nullptr );
+            UA_VariableAttributes_clear( &statAttr );
+            UA_QualifiedName_clear( &qn );
+
+            //Creating statistics variable read callback.
+            UA_DataSource statDataSource{ read_io_node_stat, nullptr };
+            UA_Server_setVariableNode_dataSource( server, statNodeId, statDataSource );
+            UA_NodeId_clear( &statNodeId );
+            }
+        UA_NodeId_clear( &nodeId );
+        }
+    UA_NodeId_clear( &nodes_root );
+
+    is_io_nodes_stat_created = true;
+    }
+
 UA_StatusCode OPCUA_server::start()
     {
     return UA_Server_run_startup( server );
@@ -213,6 +320,8 @@ void OPCUA_server::shutdown()
 
         is_dev_objects_created = false;
         is_PAC_info_created = false;
+        is_io_nodes_stat_created = false;
+        io_nodes_stat.clear();
         }
     }
 
@@ -313,6 +422,23 @@ UA_StatusCode OPCUA_server::read_PAC_info_value( UA_Server*, const UA_NodeId*, v
     return UA_STATUSCODE_GOOD;
     }
 
+UA_StatusCode OPCUA_server::read_io_node_stat( UA_Server*, const UA_NodeId*,
+    void*, const UA_NodeId*, void* nodeContext, UA_Boolean,
+    const UA_NumericRange*, UA_DataValue* dataValue )
+    {
+    if ( nodeContext != nullptr )
+        {
+        auto stat = static_cast<const io_node_stat*>( nodeContext );
+        const auto& hist = stat->node->*stat->hist;
+        UA_UInt32 value = hist.get_percentile( stat->percent );
+        UA_Variant_setScalarCopy( &dataValue->value, &value, &UA_TYPES[ UA_TYPES_UINT32 ] );
+        dataValue->hasValue = true;
+        return UA_STATUSCODE_GOOD;
+        }
+
+    return UA_STATUSCODE_BAD;
+    }
+
 UA_Server* OPCUA_server::get_server() const
     {
     return server;
@@ -5,9 +5,12 @@
 #include <open62541/server_config_default.h>
 #include <open62541/types_generated.h>
 
+#include <vector>
+
 #include "device/device.h"
 #include "device/manager.h"
 #include "tech_def.h"
+#include "bus_coupler_io.h"
 
 class OPCUA_server
     {
@@ -20,6 +23,10 @@ class OPCUA_server
 
         void create_PAC_info();
 
+        /// @brief Создание переменных статистики обмена с узлами I/O
+        /// (время ожидания ответа, отправки запроса и подключения, мкс).
+        void create_io_nodes_stat();
+
         UA_StatusCode start();
 
         void evaluate();
@@ -31,6 +38,7 @@ class OPCUA_server
             init();
             create_dev_objects();
             create_PAC_info();
+            create_io_nodes_stat();
 
             return start();
             }
@@ -64,6 +72,10 @@ class OPCUA_server
             const UA_NodeId*, void* nodeContext, UA_Boolean, const UA_NumericRange*,
             UA_DataValue* dataValue );
 
+        static UA_StatusCode read_io_node_stat( UA_Server*, const UA_NodeId*,
+            void*, const UA_NodeId*, void* nodeContext, UA_Boolean,
+            const UA_NumericRange*, UA_DataValue* dataValue );
+
         virtual ~OPCUA_server();
 
         //Explicitly delete the copy constructors.
@@ -83,6 +95,17 @@ class OPCUA_server
 
         bool is_dev_objects_created = false;
         bool is_PAC_info_created = false;
+
+        /// @brief Переменная статистики узла I/O (контекст узла OPC UA).
+        struct io_node_stat
+            {
+            const io_manager::io_node* node;
+            const time_histogram io_manager::io_node::* hist;
+            u_int percent;  ///< Процентиль (100 - максимум).
+            };
+
+        std::vector< io_node_stat > io_nodes_stat;
+        bool is_io_nodes_stat_created = false;
     };
 
 #define G_OPCUA_SERVER OPCUA_server::get_instance()
@@ -7734,7 +7734,8 @@ static int tolua_PAC_dev_io_manager_add_node00(lua_State* tolua_S)
      !tolua_isnumber(tolua_S,10,0,&tolua_err) ||
      !tolua_isnumber(tolua_S,11,0,&tolua_err) ||
      !tolua_isnumber(tolua_S,12,0,&tolua_err) ||
-     !tolua_isnoobj(tolua_S,13,&tolua_err)
+     !tolua_isnumber(tolua_S,13,1,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,14,&tolua_err)
  )
   goto tolua_lerror;
  else
@@ -7752,11 +7753,12 @@ static int tolua_PAC_dev_io_manager_add_node00(lua_State* tolua_S)
   int AO_size = ((int)  tolua_tonumber(tolua_S,10,0));
   int AI_cnt = ((int)  tolua_tonumber(tolua_S,11,0));
   int AI_size = ((int)  tolua_tonumber(tolua_S,12,0));
+  unsigned int poll_period = ((unsigned int)  tolua_tonumber(tolua_S,13,1));
 #ifndef TOLUA_RELEASE
   if (!self) tolua_error(tolua_S,"invalid 'self' in function 'add_node'", NULL);
 #endif
   {
-   io_manager::io_node* tolua_ret = (io_manager::io_node*)  self->add_node(index,ntype,address,IP_address,name,DO_cnt,DI_cnt,AO_cnt,AO_size,AI_cnt,AI_size);
+   io_manager::io_node* tolua_ret = (io_manager::io_node*)  self->add_node(index,ntype,address,IP_address,name,DO_cnt,DI_cnt,AO_cnt,AO_size,AI_cnt,AI_size,poll_period);
     tolua_pushusertype(tolua_S,(void*)tolua_ret,"io_manager::io_node");
   }
  }
@@ -7769,6 +7771,41 @@ static int tolua_PAC_dev_io_manager_add_node00(lua_State* tolua_S)
 }
 #endif //#ifndef TOLUA_DISABLE
 
+/* method: set_node_poll_period of class  io_manager */
+#ifndef TOLUA_DISABLE_tolua_PAC_dev_io_manager_set_node_poll_period00
+static int tolua_PAC_dev_io_manager_set_node_poll_period00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"io_manager",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  io_manager* self = (io_manager*)  tolua_tousertype(tolua_S,1,0);
+  unsigned int node_index = ((unsigned int)  tolua_tonumber(tolua_S,2,0));
+  unsigned int poll_period = ((unsigned int)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'set_node_poll_period'", NULL);
+#endif
+  {
+   self->set_node_poll_period(node_index,poll_period);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'set_node_poll_period'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
 /* method: init_node_AO of class  io_manager */
 #ifndef TOLUA_DISABLE_tolua_PAC_dev_io_manager_init_node_AO00
 static int tolua_PAC_dev_io_manager_init_node_AO00(lua_State* tolua_S)
@@ -15767,6 +15804,7 @@ TOLUA_API int tolua_PAC_dev_open (lua_State* tolua_S)
   tolua_beginmodule(tolua_S,"io_manager");
    tolua_function(tolua_S,"init",tolua_PAC_dev_io_manager_init00);
    tolua_function(tolua_S,"add_node",tolua_PAC_dev_io_manager_add_node00);
+   tolua_function(tolua_S,"set_node_poll_period",tolua_PAC_dev_io_manager_set_node_poll_period00);
    tolua_function(tolua_S,"init_node_AO",tolua_PAC_dev_io_manager_init_node_AO00);
    tolua_function(tolua_S,"init_node_AI",tolua_PAC_dev_io_manager_init_node_AI00);
   tolua_endmodule(tolua_S);
@@ -15838,6 +15876,22 @@ TOLUA_API int tolua_PAC_dev_open (lua_State* tolua_S)
    tolua_constant(tolua_S,"P_IS_OPC_UA_SERVER_ACTIVE",PAC_info::P_IS_OPC_UA_SERVER_ACTIVE);
    tolua_constant(tolua_S,"P_IS_OPC_UA_SERVER_CONTROL",PAC_info::P_IS_OPC_UA_SERVER_CONTROL);
    tolua_constant(tolua_S,"P_BK_ANSWER_MAX_WAIT_TIME",PAC_info::P_BK_ANSWER_MAX_WAIT_TIME);
+   tolua_constant(tolua_S,"P_IO_PIPELINED_EXCHANGE",PAC_info::P_IO_PIPELINED_EXCHANGE);
+   tolua_constant(tolua_S,"P_IO_THREAD",PAC_info::P_IO_THREAD);
+   tolua_constant(tolua_S,"P_IO_OUTPUTS_REFRESH_TIME",PAC_info::P_IO_OUTPUTS_REFRESH_TIME);
+   tolua_constant(tolua_S,"P_IO_COMBINED_EXCHANGE",PAC_info::P_IO_COMBINED_EXCHANGE);
+   tolua_constant(tolua_S,"P_MAIN_CYCLE_PERIOD",PAC_info::P_MAIN_CYCLE_PERIOD);
+   tolua_constant(tolua_S,"P_FAST_TASKS_PERIOD",PAC_info::P_FAST_TASKS_PERIOD);
+   tolua_constant(tolua_S,"P_NORMAL_TASKS_PERIOD",PAC_info::P_NORMAL_TASKS_PERIOD);
+   tolua_constant(tolua_S,"P_SLOW_TASKS_PERIOD",PAC_info::P_SLOW_TASKS_PERIOD);
+   tolua_constant(tolua_S,"P_COMM_THREAD",PAC_info::P_COMM_THREAD);
+   tolua_constant(tolua_S,"P_LUA_GC_ADAPTIVE",PAC_info::P_LUA_GC_ADAPTIVE);
+   tolua_constant(tolua_S,"P_LUA_GC_FULL_THRESHOLD",PAC_info::P_LUA_GC_FULL_THRESHOLD);
+   tolua_constant(tolua_S,"P_COMPRESSION_LEVEL",PAC_info::P_COMPRESSION_LEVEL);
+   tolua_constant(tolua_S,"P_COMPRESSION_STRATEGY",PAC_info::P_COMPRESSION_STRATEGY);
+   tolua_constant(tolua_S,"P_COMPRESSION_DICTIONARY",PAC_info::P_COMPRESSION_DICTIONARY);
+   tolua_constant(tolua_S,"P_TCP_MAX_OUT_QUEUE",PAC_info::P_TCP_MAX_OUT_QUEUE);
+   tolua_constant(tolua_S,"P_TCP_SLOW_CLIENT_TIMEOUT",PAC_info::P_TCP_SLOW_CLIENT_TIMEOUT);
    tolua_variable(tolua_S,"par",tolua_get_PAC_info_par,tolua_set_PAC_info_par);
    tolua_function(tolua_S,"set_cmd",tolua_PAC_dev_PAC_info_set_cmd00);
    tolua_function(tolua_S,"is_emulator",tolua_PAC_dev_PAC_info_is_emulator00);
@@ -8,6 +8,10 @@
 #include "lua_manager.h"
 #include "bus_coupler_io.h"
 #include "device/manager.h"
+#include "cycle_profiler.h"
+#include "cycle_scheduler.h"
+#include "lua_gc_controller.h"
+#include "tcp_cmctr.h"
 
 #include "OPCUAServer.h"
 
@@ -109,6 +113,23 @@ void PAC_info::reset_params()
     par[ P_STABLE_SAVE_DELAY_MS ] = 60'000;     // 1 minute.
     par[ P_MIN_SAVE_INTERVAL_MS ] = 3'600'000;  // 1 hour (60 * 60 * 1'000).
 
+    par[ P_IO_PIPELINED_EXCHANGE ] = 0;
+    par[ P_IO_THREAD ] = 0;
+    par[ P_IO_OUTPUTS_REFRESH_TIME ] = 0;
+    par[ P_IO_COMBINED_EXCHANGE ] = 0;
+    par[ P_MAIN_CYCLE_PERIOD ] = 0;
+    par[ P_FAST_TASKS_PERIOD ] = 0;
+    par[ P_NORMAL_TASKS_PERIOD ] = 0;
+    par[ P_SLOW_TASKS_PERIOD ] = 0;
+    par[ P_COMM_THREAD ] = 0;
+    par[ P_LUA_GC_ADAPTIVE ] = 0;
+    par[ P_LUA_GC_FULL_THRESHOLD ] = 0;
+    par[ P_COMPRESSION_LEVEL ] = 0;
+    par[ P_COMPRESSION_STRATEGY ] = 0;
+    par[ P_COMPRESSION_DICTIONARY ] = 0;
+    par[ P_TCP_MAX_OUT_QUEUE ] = 4096;
+    par[ P_TCP_SLOW_CLIENT_TIMEOUT ] = 10000;
+
     par.save_all();
     }
 //-----------------------------------------------------------------------------
@@ -131,6 +152,92 @@ int PAC_info::save_device( char* buff ) const
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
         "\tCYCLE_TIME={},\n", cycle_time ).size;
 
+    // Время основного цикла и его этапов (99-й процентиль, время этапов в
+    // самом долгом цикле), мкс.
+    auto profiler = G_CYCLE_PROFILER();
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_TIME_P99={},\n",
+        profiler->get_cycle_hist().get_percentile( 99 ) ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_TIME_MAX={},\n", profiler->get_cycle_hist().get_max() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_PHASE_P99 = \n\t{{\n\t" ).size;
+    for ( int i = 0; i < cycle_profiler::PHASES_COUNT; i++ )
+        {
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "{}, ",
+            profiler->get_phase_hist(
+            static_cast<cycle_profiler::PHASES>( i ) ).get_percentile( 99 ) ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_PHASE_WORST = \n\t{{\n\t" ).size;
+    for ( int i = 0; i < cycle_profiler::PHASES_COUNT; i++ )
+        {
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "{}, ",
+            profiler->get_worst_cycle_phase_time(
+            static_cast<cycle_profiler::PHASES>( i ) ) ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+
+    // Планировщик цикла: задержка пробуждения (мкс), превышения периода.
+    auto scheduler = G_CYCLE_SCHEDULER();
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_JITTER_P99={},\n",
+        scheduler->get_jitter_hist().get_percentile( 99 ) ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_JITTER_MAX={},\n", scheduler->get_jitter_hist().get_max() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_OVERRUNS={},\n", scheduler->get_overruns_count() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_OVERRUN_MAX={},\n", scheduler->get_max_overrun() ).size;
+
+    // Классы задач цикла: время выполнения (99-й процентиль, мкс),
+    // количество превышений периода.
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_TASK_P99 = \n\t{{\n\t" ).size;
+    for ( int i = 0; i < cycle_scheduler::TASK_CLASSES_COUNT; i++ )
+        {
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "{}, ",
+            profiler->get_task_hist( static_cast<cycle_scheduler::TASK_CLASSES>(
+            i ) ).get_percentile( 99 ) ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tCYCLE_TASK_OVERRUNS = \n\t{{\n\t" ).size;
+    for ( int i = 0; i < cycle_scheduler::TASK_CLASSES_COUNT; i++ )
+        {
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "{}, ",
+            scheduler->get_task_overruns_count(
+            static_cast<cycle_scheduler::TASK_CLASSES>( i ) ) ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+
+    // Сборщик мусора Lua: размер кучи (байт), шаг (Кб), время за цикл (мкс).
+    auto gc_controller = G_LUA_GC_CONTROLLER();
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tLUA_HEAP_SIZE={},\n", gc_controller->get_heap_size() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tLUA_GC_STEP={},\n", gc_controller->get_last_step() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tLUA_GC_TIME_P99={},\n",
+        gc_controller->get_gc_time_hist().get_percentile( 99 ) ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tLUA_GC_TIME_MAX={},\n",
+        gc_controller->get_gc_time_hist().get_max() ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tLUA_GC_FULL_COUNT={},\n",
+        gc_controller->get_full_collections_count() ).size;
+
+    // Обмен с сервером: закрытые соединения медленных клиентов, максимальный
+    // размер очереди передачи соединения (байт).
+    auto cmctr = G_CMMCTR;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tTCP_SLOW_CLIENTS={},\n",
+        cmctr ? cmctr->get_slow_clients_count() : 0 ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tTCP_OUT_QUEUE_MAX={},\n",
+        cmctr ? cmctr->get_max_out_queue_size() : 0 ).size;
+
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
         "\tWASH_VALVE_SEAT_PERIOD={},\n", par[ P_MIX_FLIP_PERIOD ] ).size;
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
@@ -186,6 +293,27 @@ int PAC_info::save_device( char* buff ) const
         }
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
 
+    // Время ожидания ответа узлов (99-й процентиль и максимум), мкс.
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tNODE_RECV_P99 = \n\t{{\n\t" ).size;
+    for ( unsigned int i = 0; i < nc; i++ )
+        {
+        auto wn = io_manager::get_instance()->get_node( i );
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+            "{}, ", wn->recv_hist.get_percentile( 99 ) ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tNODE_RECV_MAX = \n\t{{\n\t" ).size;
+    for ( unsigned int i = 0; i < nc; i++ )
+        {
+        auto wn = io_manager::get_instance()->get_node( i );
+        size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+            "{}, ", wn->recv_hist.get_max() ).size;
+        }
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE, "\n\t}},\n" ).size;
+
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
         "\tP_IS_OPC_UA_SERVER_ACTIVE={},\n", par[ P_IS_OPC_UA_SERVER_ACTIVE ] ).size;
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
@@ -193,6 +321,38 @@ int PAC_info::save_device( char* buff ) const
 
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
         "\tP_BK_ANSWER_MAX_WAIT_TIME={},\n", par[ P_BK_ANSWER_MAX_WAIT_TIME ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_IO_PIPELINED_EXCHANGE={},\n", par[ P_IO_PIPELINED_EXCHANGE ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_IO_THREAD={},\n", par[ P_IO_THREAD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_IO_OUTPUTS_REFRESH_TIME={},\n", par[ P_IO_OUTPUTS_REFRESH_TIME ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_IO_COMBINED_EXCHANGE={},\n", par[ P_IO_COMBINED_EXCHANGE ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_MAIN_CYCLE_PERIOD={},\n", par[ P_MAIN_CYCLE_PERIOD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_FAST_TASKS_PERIOD={},\n", par[ P_FAST_TASKS_PERIOD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_NORMAL_TASKS_PERIOD={},\n", par[ P_NORMAL_TASKS_PERIOD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_SLOW_TASKS_PERIOD={},\n", par[ P_SLOW_TASKS_PERIOD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_COMM_THREAD={},\n", par[ P_COMM_THREAD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_LUA_GC_ADAPTIVE={},\n", par[ P_LUA_GC_ADAPTIVE ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_LUA_GC_FULL_THRESHOLD={},\n", par[ P_LUA_GC_FULL_THRESHOLD ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_COMPRESSION_LEVEL={},\n", par[ P_COMPRESSION_LEVEL ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_COMPRESSION_STRATEGY={},\n", par[ P_COMPRESSION_STRATEGY ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_COMPRESSION_DICTIONARY={},\n", par[ P_COMPRESSION_DICTIONARY ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_TCP_MAX_OUT_QUEUE={},\n", par[ P_TCP_MAX_OUT_QUEUE ] ).size;
+    size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
+        "\tP_TCP_SLOW_CLIENT_TIMEOUT={},\n", par[ P_TCP_SLOW_CLIENT_TIMEOUT ] ).size;
 
     size += fmt::format_to_n( buff + size, MAX_COPY_SIZE,
         "\tNODES_COMM_ERROR={},\n", nodes_comm_error ).size;
@@ -268,6 +428,26 @@ int PAC_info::set_cmd( const char* prop, u_int idx, double val )
                 G_LOG->notice( "Force saving parameters (remote monitor "
                     "client command)." );
                 return params_manager::get_instance()->save_params();
+
+            case COMMANDS::RESET_IO_STAT:
+                {
+                G_LOG->notice( "Resetting I/O nodes statistics (remote "
+                    "monitor client command)." );
+                auto nc = io_manager::get_instance()->get_nodes_count();
+                for ( u_int i = 0; i < nc; i++ )
+                    {
+                    io_manager::get_instance()->get_node( i )->reset_stat();
+                    }
+                return 0;
+                }
+
+            case COMMANDS::RESET_CYCLE_PROFILE:
+                G_LOG->notice( "Resetting main cycle statistics (remote "
+                    "monitor client command)." );
+                G_CYCLE_PROFILER()->reset();
+                G_CYCLE_SCHEDULER()->reset();
+                G_LUA_GC_CONTROLLER()->reset();
+                return 0;
             }
 
         return 0;
@@ -431,6 +611,102 @@ int PAC_info::set_cmd( const char* prop, u_int idx, double val )
         return 0;
         }
 
+    if ( strcmp( prop, "P_IO_PIPELINED_EXCHANGE" ) == 0 )
+        {
+        par.save( P_IO_PIPELINED_EXCHANGE, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_IO_THREAD" ) == 0 )
+        {
+        par.save( P_IO_THREAD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_IO_OUTPUTS_REFRESH_TIME" ) == 0 )
+        {
+        par.save( P_IO_OUTPUTS_REFRESH_TIME, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_IO_COMBINED_EXCHANGE" ) == 0 )
+        {
+        par.save( P_IO_COMBINED_EXCHANGE, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_MAIN_CYCLE_PERIOD" ) == 0 )
+        {
+        par.save( P_MAIN_CYCLE_PERIOD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_FAST_TASKS_PERIOD" ) == 0 )
+        {
+        par.save( P_FAST_TASKS_PERIOD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_NORMAL_TASKS_PERIOD" ) == 0 )
+        {
+        par.save( P_NORMAL_TASKS_PERIOD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_SLOW_TASKS_PERIOD" ) == 0 )
+        {
+        par.save( P_SLOW_TASKS_PERIOD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_COMM_THREAD" ) == 0 )
+        {
+        par.save( P_COMM_THREAD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_LUA_GC_ADAPTIVE" ) == 0 )
+        {
+        par.save( P_LUA_GC_ADAPTIVE, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_LUA_GC_FULL_THRESHOLD" ) == 0 )
+        {
+        par.save( P_LUA_GC_FULL_THRESHOLD, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_COMPRESSION_LEVEL" ) == 0 )
+        {
+        par.save( P_COMPRESSION_LEVEL, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_COMPRESSION_STRATEGY" ) == 0 )
+        {
+        par.save( P_COMPRESSION_STRATEGY, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_COMPRESSION_DICTIONARY" ) == 0 )
+        {
+        par.save( P_COMPRESSION_DICTIONARY, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_TCP_MAX_OUT_QUEUE" ) == 0 )
+        {
+        par.save( P_TCP_MAX_OUT_QUEUE, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
+    if ( strcmp( prop, "P_TCP_SLOW_CLIENT_TIMEOUT" ) == 0 )
+        {
+        par.save( P_TCP_SLOW_CLIENT_TIMEOUT, static_cast<u_int_4>( val ) );
+        return 0;
+        }
+
     return 0;
     }
 
@@ -70,6 +70,72 @@ class PAC_info: public i_Lua_save_device
             ///< параметров.
             P_MIN_SAVE_INTERVAL_MS,
 
+            ///< Конвейерный (одновременный для всех узлов) обмен с узлами
+            ///< I/O, 0 - нет (последовательный обмен), 1 - да.
+            P_IO_PIPELINED_EXCHANGE,
+
+            ///< Обмен с узлами I/O в отдельном потоке, 0 - нет, 1 - да.
+            P_IO_THREAD,
+
+            ///< Период записи неизменившихся выходов узлов I/O, мсек.
+            ///< 0 - выходы записываются каждый цикл.
+            P_IO_OUTPUTS_REFRESH_TIME,
+
+            ///< Совмещенный обмен с узлами I/O Phoenix (чтение и запись одной
+            ///< транзакцией Modbus, функция 0x17), 0 - нет, 1 - да.
+            P_IO_COMBINED_EXCHANGE,
+
+            ///< Период основного цикла, мсек. 0 - фиксированное ожидание после
+            ///< этапов цикла (параметр командной строки sleep_time).
+            P_MAIN_CYCLE_PERIOD,
+
+            ///< Период выполнения быстрых задач основного цикла (обмен с узлами I/O,
+            ///< обработка устройств), мсек. 0 - каждый цикл.
+            P_FAST_TASKS_PERIOD,
+
+            ///< Период выполнения задач управления основного цикла (технологические
+            ///< объекты, обмен с сервером, OPC UA), мсек. 0 - каждый цикл.
+            P_NORMAL_TASKS_PERIOD,
+
+            ///< Период выполнения задач обслуживания основного цикла (сохранение
+            ///< параметров, обработка ошибок, PAC_info), мсек. 0 - каждый цикл.
+            P_SLOW_TASKS_PERIOD,
+
+            ///< Обмен с сервером в отдельном потоке (Linux), 0 - нет, 1 - да.
+            ///< Сервисы (состояние устройств, команды) при этом выполняются
+            ///< управляющим потоком при обмене (@ref tcp_communicator::evaluate).
+            P_COMM_THREAD,
+
+            ///< Адаптивный шаг сборщика мусора Lua (0 - фиксированный шаг,
+            ///< 1 - по скорости выделения памяти и свободному времени цикла).
+            P_LUA_GC_ADAPTIVE,
+
+            ///< Размер кучи Lua для полной сборки мусора, Кб (0 - не
+            ///< выполняется, только для адаптивного режима).
+            P_LUA_GC_FULL_THRESHOLD,
+
+            ///< Уровень сжатия ответов сервису устройств (0 - по умолчанию,
+            ///< 1..9 - уровень zlib).
+            P_COMPRESSION_LEVEL,
+
+            ///< Стратегия сжатия ответов сервису устройств (стратегия zlib:
+            ///< 0 - по умолчанию, 1 - Z_FILTERED, 2 - Z_HUFFMAN_ONLY, 3 - Z_RLE,
+            ///< 4 - Z_FIXED).
+            P_COMPRESSION_STRATEGY,
+
+            ///< Сжатие состояния устройств с предварительно заданным словарем
+            ///< (CMD_GET_COMPRESSION_DICTIONARY).
+            P_COMPRESSION_DICTIONARY,
+
+            ///< Максимальный размер очереди передачи соединения сервера, Кб
+            ///< (0 - не ограничен). При превышении соединение закрывается.
+            P_TCP_MAX_OUT_QUEUE,
+
+            ///< Время без передачи данных из непустой очереди передачи, после
+            ///< которого соединение закрывается (медленный клиент), мсек (0 - не
+            ///< ограничено).
+            P_TCP_SLOW_CLIENT_TIMEOUT,
+
             ///< Количество параметров.
             P_PARAMS_COUNT
             };
@@ -110,6 +176,8 @@ class PAC_info: public i_Lua_save_device
             RELOAD_RESTRICTIONS = 100,
             RESET_PARAMS = 101,
             FORCE_SAVE_PARAMS = 102,
+            RESET_IO_STAT = 103,    ///< Сброс статистики обмена с узлами I/O.
+            RESET_CYCLE_PROFILE = 104,  ///< Сброс статистики основного цикла.
             };
 
 #ifdef PTUSA_TEST
@@ -477,6 +477,11 @@ int PID::save_device_ex( char* buff ) const
     return answer_size;
     }
 //-----------------------------------------------------------------------------
+void PID::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_float( "Z", set_value );
+    }
+//-----------------------------------------------------------------------------
 int PID::save_device( char *buff ) const
     {
     int answer_size = 0;
@@ -112,6 +112,7 @@ class PID : public device
         void set_used_par ( int par_n );
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
         int save_device( char *buff ) const override;
 
         const char* get_name_in_Lua() const override;
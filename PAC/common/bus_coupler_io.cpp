@@ -1233,12 +1233,14 @@ u_int io_manager::get_nodes_count()
 io_manager::io_node* io_manager::add_node( u_int index, int ntype, int address,
     const char* IP_address, const char *name,
     int DO_cnt, int DI_cnt,
-    int AO_cnt, int AO_size, int AI_cnt, int AI_size )
+    int AO_cnt, int AO_size, int AI_cnt, int AI_size,
+    u_int poll_period /*= 1*/ )
     {
     if ( index < nodes_count )
         {
         nodes[ index ] = new io_node( ntype, address, IP_address, name, DO_cnt,
             DI_cnt, AO_cnt, AO_size, AI_cnt, AI_size );
+        set_node_poll_period( index, poll_period );
 
         return nodes[ index ];
         }
@@ -1246,6 +1248,28 @@ io_manager::io_node* io_manager::add_node( u_int index, int ntype, int address,
     return nullptr;
     }
 //-----------------------------------------------------------------------------
+void io_manager::set_node_poll_period( u_int node_index, u_int poll_period )
+    {
+    if ( node_index >= nodes_count || !nodes[ node_index ] )
+        {
+        return;
+        }
+
+    auto nd = nodes[ node_index ];
+    nd->poll_period = poll_period ? poll_period : 1;
+
+    // Сдвиг - порядковый номер узла среди узлов с таким же периодом.
+    u_int same_period_cnt = 0;
+    for ( u_int i = 0; i < node_index; i++ )
+        {
+        if ( nodes[ i ] && nodes[ i ]->poll_period == nd->poll_period )
+            {
+            same_period_cnt++;
+            }
+        }
+    nd->poll_phase = same_period_cnt % nd->poll_period;
+    }
+//-----------------------------------------------------------------------------
 void io_manager::init_node_AO( u_int node_index, u_int AO_index,
                                 u_int type, u_int offset )
     {
@@ -1266,6 +1290,76 @@ void io_manager::init_node_AI( u_int node_index, u_int AI_index,
         }
     }
 //-----------------------------------------------------------------------------
+namespace
+    {
+    /// Значения битов байта (по байту на бит, младший бит - первый).
+    struct unpack_table
+        {
+        u_char values[ 256 ][ 8 ];
+
+        constexpr unpack_table() : values()
+            {
+            for ( int b = 0; b < 256; b++ )
+                {
+                for ( int k = 0; k < 8; k++ )
+                    {
+                    values[ b ][ k ] = static_cast<u_char>( ( b >> k ) & 1 );
+                    }
+                }
+            }
+        };
+
+    constexpr unpack_table UNPACK_TABLE;
+    }
+//-----------------------------------------------------------------------------
+void io_manager::unpack_bits( const u_char* src, u_char* dst, u_int cnt )
+    {
+    u_int full_bytes = cnt / 8;
+    for ( u_int i = 0; i < full_bytes; i++ )
+        {
+        memcpy( dst + i * 8, UNPACK_TABLE.values[ src[ i ] ], 8 );
+        }
+
+    if ( auto rest = cnt % 8; rest )
+        {
+        memcpy( dst + full_bytes * 8, UNPACK_TABLE.values[ src[ full_bytes ] ],
+            rest );
+        }
+    }
+//-----------------------------------------------------------------------------
+void io_manager::pack_bits( const u_char* src, u_char* dst, u_int cnt )
+    {
+    u_int full_bytes = cnt / 8;
+    for ( u_int i = 0; i < full_bytes; i++ )
+        {
+#if defined( _MSC_VER ) || \
+    ( defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ )
+        // Младшие биты 8 значений собираются в старшем байте произведения.
+        uint64_t v;
+        memcpy( &v, src + i * 8, 8 );
+        v &= 0x0101010101010101ULL;
+        dst[ i ] = static_cast<u_char>( ( v * 0x0102040810204080ULL ) >> 56 );
+#else
+        u_char b = 0;
+        for ( u_int k = 0; k < 8; k++ )
+            {
+            b |= static_cast<u_char>( ( src[ i * 8 + k ] & 1 ) << k );
+            }
+        dst[ i ] = b;
+#endif
+        }
+
+    if ( auto rest = cnt % 8; rest )
+        {
+        u_char b = 0;
+        for ( u_int k = 0; k < rest; k++ )
+            {
+            b |= static_cast<u_char>( ( src[ full_bytes * 8 + k ] & 1 ) << k );
+            }
+        dst[ full_bytes ] = b;
+        }
+    }
+//-----------------------------------------------------------------------------
 #ifdef PTUSA_TEST
 void io_manager::clear_nodes()
     {
@@ -1421,6 +1515,22 @@ io_manager::io_node::DISPLAY_STATES io_manager::io_node::get_display_state() con
     return io_node::DISPLAY_STATES::DST_OK;
     }
 //-----------------------------------------------------------------------------
+void io_manager::io_node::reset_stat()
+    {
+    stat_reset_request++;
+    }
+//-----------------------------------------------------------------------------
+void io_manager::io_node::check_stat_reset()
+    {
+    if ( stat_reset_done != stat_reset_request )
+        {
+        connect_hist.clear();
+        send_hist.clear();
+        recv_hist.clear();
+        stat_reset_done = stat_reset_request;
+        }
+    }
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 io_manager* G_IO_MANAGER()
     {
@@ -385,6 +385,7 @@ class io_manager
 				{
 				ST_NO_CONNECT = 0,
 				ST_OK = 1,
+				ST_CONNECTING = 2, ///< Выполняется подключение.
 				};
 
             enum class DISPLAY_STATES  ///< Отображение работы с узлом.
@@ -447,12 +448,70 @@ class io_manager
             ///< Время последней попытки подключиться, мсек.
             uint32_t last_init_time{};
 
+            ///< Время начала текущего подключения, мсек.
+            uint32_t connect_start_time{};
+
             ///< Время ожидания до попытки подключиться, мсек.
             uint32_t delay_time{ W_CONST::C_INITIAL_RECONNECT_DELAY };
 
 			stat_time recv_stat;  ///< Статистика работы с сокетом.
 			stat_time send_stat;  ///< Статистика работы с сокетом.
 
+            time_histogram connect_hist;  ///< Время подключения, мкс.
+            time_histogram send_hist;     ///< Время отправки запроса, мкс.
+            time_histogram recv_hist;     ///< Время ожидания ответа, мкс.
+
+            ///< Время начала текущего подключения, мкс.
+            uint64_t connect_start_time_us{};
+
+            ///< Счетчики запросов сброса статистики и выполненных сбросов
+            ///< (при обмене в отдельном потоке сброс выполняется потоком
+            ///< обмена).
+            u_int stat_reset_request{};
+            u_int stat_reset_done{};
+
+            /// @brief Сброс статистики (гистограмм времени) обмена.
+            ///
+            /// Выполняется при следующем обмене с узлом.
+            void reset_stat();
+
+            /// @brief Выполнение запрошенного сброса статистики.
+            void check_stat_reset();
+
+            ///< Время последней записи всех выходов (в том числе
+            ///< неизменившихся), мсек.
+            uint32_t last_outputs_refresh_time{};
+
+            ///< Требуется запись всех выходов (например, после
+            ///< переподключения к узлу).
+            bool is_outputs_refresh_forced{ true };
+
+            ///< Запись всех выходов в текущем цикле обмена.
+            bool is_outputs_refresh{ true };
+
+            ///< Период опроса (чтения входов) узла, циклов обмена. Для
+            ///< медленных узлов (температура, IO-Link и т.д.) задается
+            ///< больше 1.
+            u_int poll_period{ 1 };
+
+            ///< Сдвиг цикла опроса узла относительно других узлов с тем же
+            ///< периодом (для равномерного распределения нагрузки).
+            u_int poll_phase{};
+
+            ///< Время последнего цикла, в котором узел опрашивался, мсек.
+            uint32_t last_poll_cycle_time{ get_millisec() };
+
+            ///< Интервал между циклами опроса узла, мсек. Учитывается при
+            ///< контроле связи с узлом.
+            uint32_t poll_interval{};
+
+            ///< Узел не поддерживает чтение/запись регистров одной
+            ///< транзакцией (функция Modbus 0x17).
+            bool is_rw_registers_unsupported{ false };
+
+            ///< Чтение входов в текущем цикле совмещенного обмена.
+            bool is_combined_read{ false };
+
             bool flag_error_read_message{ false }; ///< Флаг для вывода сообщений об ошибке чтения.
             bool flag_error_write_message{ false }; ///< Флаг для вывода сообщений об ошибке записи.
 
@@ -509,10 +568,24 @@ class io_manager
         /// @brief Инициализация модуля.
         ///
         /// Вызывается из Lua.
+        ///
+        /// @param poll_period - период опроса узла, циклов обмена.
         io_manager::io_node* add_node( u_int index, int ntype, int address,
             const char* IP_address, const char *name,
             int DO_cnt, int DI_cnt,
-            int AO_cnt, int AO_size, int AI_cnt, int AI_size );
+            int AO_cnt, int AO_size, int AI_cnt, int AI_size,
+            u_int poll_period = 1 );
+
+        /// @brief Установка периода опроса узла.
+        ///
+        /// Узлы с одинаковым периодом распределяются по разным циклам
+        /// обмена.
+        ///
+        /// Вызывается из Lua.
+        ///
+        /// @param node_index  - индекс узла.
+        /// @param poll_period - период опроса узла, циклов обмена.
+        void set_node_poll_period( u_int node_index, u_int poll_period );
 
         /// @brief Инициализация параметров канала аналогового вывода.
         ///
@@ -529,6 +602,23 @@ class io_manager
 		/// @brief Завершает соединение с узлом
 		virtual void disconnect(io_node *node) = 0;
 
+        /// @brief Распаковка битов (младший бит байта - первый) в массив
+        /// байтов со значениями 0/1 (по 8 байт за шаг, по таблице).
+        ///
+        /// @param src - упакованные биты.
+        /// @param dst - значения (@a cnt байт).
+        /// @param cnt - количество битов.
+        static void unpack_bits( const u_char* src, u_char* dst, u_int cnt );
+
+        /// @brief Упаковка значений (учитывается младший бит) в биты
+        /// (младший бит байта - первый, по 8 значений за шаг). Неиспользуемые
+        /// биты последнего байта обнуляются.
+        ///
+        /// @param src - значения (@a cnt байт).
+        /// @param dst - упакованные биты.
+        /// @param cnt - количество битов.
+        static void pack_bits( const u_char* src, u_char* dst, u_int cnt );
+
         inline static io_node io_node_stub{ io_manager::io_node::PHOENIX_BK_ETH,
             1, "127.0.0.1", "Axxx", 0, 0, 0, 0, 0, 0 };
         inline static const io_node IO_NODE_STUB{ io_manager::io_node::PHOENIX_BK_ETH,
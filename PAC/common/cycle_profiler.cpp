@@ -0,0 +1,226 @@
+#include <algorithm>
+
+#include "fmt/format.h"
+
+#include "cycle_profiler.h"
+
+auto_smart_ptr < cycle_profiler > cycle_profiler::instance;
+//-----------------------------------------------------------------------------
+cycle_profiler* cycle_profiler::get_instance()
+    {
+    if ( instance.is_null() )
+        {
+        instance = new cycle_profiler();
+        }
+
+    return instance;
+    }
+//-----------------------------------------------------------------------------
+void cycle_profiler::start_cycle()
+    {
+    cycle_start_time = get_microsec();
+    phase_start_time = cycle_start_time;
+    std::fill( phase_time, phase_time + PHASES_COUNT, 0 );
+    is_cycle_started = true;
+    }
+//-----------------------------------------------------------------------------
+void cycle_profiler::end_phase( PHASES phase )
+    {
+    auto now = get_microsec();
+    phase_time[ phase ] += static_cast<uint32_t>( now - phase_start_time );
+    phase_start_time = now;
+    }
+//-----------------------------------------------------------------------------
+void cycle_profiler::end_cycle()
+    {
+    if ( !is_cycle_started )
+        {
+        return;
+        }
+    is_cycle_started = false;
+
+    auto cycle_time = static_cast<uint32_t>( get_microsec() - cycle_start_time );
+    cycle_hist.add( cycle_time );
+    last_cycle_work_time = cycle_time > phase_time[ PH_SLEEP ] ?
+        cycle_time - phase_time[ PH_SLEEP ] : 0;
+    uint32_t task_time[ cycle_scheduler::TASK_CLASSES_COUNT ]{};
+    for ( int i = 0; i < PHASES_COUNT; i++ )
+        {
+        phases_hist[ i ].add( phase_time[ i ] );
+
+        auto task_class = get_phase_task_class( static_cast<PHASES>( i ) );
+        if ( task_class < cycle_scheduler::TASK_CLASSES_COUNT )
+            {
+            task_time[ task_class ] += phase_time[ i ];
+            }
+        }
+
+    auto scheduler = G_CYCLE_SCHEDULER();
+    for ( int i = 0; i < cycle_scheduler::TASK_CLASSES_COUNT; i++ )
+        {
+        if ( scheduler->is_task_executed(
+            static_cast<cycle_scheduler::TASK_CLASSES>( i ) ) )
+            {
+            tasks_hist[ i ].add( task_time[ i ] );
+            }
+        }
+
+    if ( cycle_time > worst_cycle_time )
+        {
+        worst_cycle_time = cycle_time;
+        std::copy( phase_time, phase_time + PHASES_COUNT, worst_phase_time );
+        std::copy( task_time, task_time + cycle_scheduler::TASK_CLASSES_COUNT,
+            worst_task_time );
+        }
+    }
+//-----------------------------------------------------------------------------
+void cycle_profiler::reset()
+    {
+    for ( auto& hist : phases_hist )
+        {
+        hist.clear();
+        }
+    cycle_hist.clear();
+
+    worst_cycle_time = 0;
+    std::fill( worst_phase_time, worst_phase_time + PHASES_COUNT, 0 );
+
+    for ( auto& hist : tasks_hist )
+        {
+        hist.clear();
+        }
+    std::fill( worst_task_time,
+        worst_task_time + cycle_scheduler::TASK_CLASSES_COUNT, 0 );
+    }
+//-----------------------------------------------------------------------------
+const time_histogram& cycle_profiler::get_phase_hist( PHASES phase ) const
+    {
+    return phases_hist[ phase ];
+    }
+//-----------------------------------------------------------------------------
+const time_histogram& cycle_profiler::get_cycle_hist() const
+    {
+    return cycle_hist;
+    }
+//-----------------------------------------------------------------------------
+uint32_t cycle_profiler::get_worst_cycle_phase_time( PHASES phase ) const
+    {
+    return worst_phase_time[ phase ];
+    }
+//-----------------------------------------------------------------------------
+uint32_t cycle_profiler::get_last_cycle_work_time() const
+    {
+    return last_cycle_work_time;
+    }
+//-----------------------------------------------------------------------------
+const char* cycle_profiler::get_phase_name( PHASES phase )
+    {
+    switch ( phase )
+        {
+        case PH_LUA_GC:         return "LUA_GC";
+        case PH_READ_INPUTS:    return "READ_INPUTS";
+        case PH_EVALUATE_IO:    return "EVALUATE_IO";
+        case PH_VALVES:         return "VALVES";
+        case PH_TECH_OBJECTS:   return "TECH_OBJECTS";
+        case PH_WRITE_OUTPUTS:  return "WRITE_OUTPUTS";
+        case PH_COMMUNICATION:  return "COMMUNICATION";
+        case PH_PARAMS:         return "PARAMS";
+        case PH_OPC_UA:         return "OPC_UA";
+        case PH_IOT:            return "IOT";
+        case PH_ERRORS:         return "ERRORS";
+        case PH_SLEEP:          return "SLEEP";
+
+        default:
+            return "?";
+        }
+    }
+//-----------------------------------------------------------------------------
+cycle_scheduler::TASK_CLASSES cycle_profiler::get_phase_task_class(
+    PHASES phase )
+    {
+    switch ( phase )
+        {
+        case PH_READ_INPUTS:
+        case PH_EVALUATE_IO:
+        case PH_VALVES:
+        case PH_WRITE_OUTPUTS:
+            return cycle_scheduler::TC_FAST;
+
+        case PH_LUA_GC:
+        case PH_TECH_OBJECTS:
+        case PH_COMMUNICATION:
+        case PH_OPC_UA:
+        case PH_IOT:
+            return cycle_scheduler::TC_NORMAL;
+
+        case PH_PARAMS:
+        case PH_ERRORS:
+            return cycle_scheduler::TC_SLOW;
+
+        default:
+            return cycle_scheduler::TASK_CLASSES_COUNT;
+        }
+    }
+//-----------------------------------------------------------------------------
+const time_histogram& cycle_profiler::get_task_hist(
+    cycle_scheduler::TASK_CLASSES task_class ) const
+    {
+    return tasks_hist[ task_class ];
+    }
+//-----------------------------------------------------------------------------
+uint32_t cycle_profiler::get_worst_cycle_task_time(
+    cycle_scheduler::TASK_CLASSES task_class ) const
+    {
+    return worst_task_time[ task_class ];
+    }
+//-----------------------------------------------------------------------------
+int cycle_profiler::save_as_Lua_str( char* buff, int max_size ) const
+    {
+    auto save_hist = [ &buff, max_size ]( int size, const char* name,
+        const time_histogram& hist, uint32_t worst_time )
+        {
+        auto res = fmt::format_to_n( buff + size, max_size - size - 1,
+            "\t{}={{P50={}, P95={}, P99={}, MAX={}, AVG={}, WORST={}}},\n",
+            name, hist.get_percentile( 50 ), hist.get_percentile( 95 ),
+            hist.get_percentile( 99 ), hist.get_max(), hist.get_avg(),
+            worst_time );
+        return std::min( static_cast<int>( res.size ), max_size - size - 1 );
+        };
+
+    if ( max_size < 1 )
+        {
+        return 0;
+        }
+
+    auto res = fmt::format_to_n( buff, max_size - 1,
+        "t.CYCLE_PROFILE = \n\t{{\n\tCYCLES={},\n", cycle_hist.get_count() );
+    int size = std::min( static_cast<int>( res.size ), max_size - 1 );
+
+    size += save_hist( size, "CYCLE", cycle_hist, worst_cycle_time );
+    for ( int i = 0; i < PHASES_COUNT; i++ )
+        {
+        auto phase = static_cast<PHASES>( i );
+        size += save_hist( size, get_phase_name( phase ), phases_hist[ i ],
+            worst_phase_time[ i ] );
+        }
+    for ( int i = 0; i < cycle_scheduler::TASK_CLASSES_COUNT; i++ )
+        {
+        auto task_class = static_cast<cycle_scheduler::TASK_CLASSES>( i );
+        auto name = fmt::format( "TASK_{}",
+            cycle_scheduler::get_task_class_name( task_class ) );
+        size += save_hist( size, name.c_str(), tasks_hist[ i ],
+            worst_task_time[ i ] );
+        }
+
+    res = fmt::format_to_n( buff + size, max_size - size - 1, "\t}}\n" );
+    size += std::min( static_cast<int>( res.size ), max_size - size - 1 );
+    buff[ size ] = '\0';
+
+    return size;
+    }
+//-----------------------------------------------------------------------------
+cycle_profiler* G_CYCLE_PROFILER()
+    {
+    return cycle_profiler::get_instance();
+    }
+//-----------------------------------------------------------------------------
@@ -0,0 +1,110 @@
+/// @file cycle_profiler.h
+/// @brief Профилирование основного цикла программы по этапам.
+
+#pragma once
+
+#include "smart_ptr.h"
+#include "dtime.h"
+#include "cycle_scheduler.h"
+
+//-----------------------------------------------------------------------------
+/// @brief Профилировщик основного цикла программы.
+///
+/// Время каждого этапа цикла (от предыдущей отметки) и всего цикла
+/// накапливается в гистограммах (мкс). Для самого долгого цикла
+/// сохраняется время его этапов - это позволяет определить, какой этап
+/// вызвал превышение времени цикла. Накладные расходы - одно чтение
+/// времени на этап.
+///
+/// Время класса задач (@ref cycle_scheduler::TASK_CLASSES) - сумма времени
+/// его этапов, учитывается только в циклах, в которых класс выполнялся.
+class cycle_profiler
+    {
+    public:
+        enum PHASES           ///< Этапы основного цикла.
+            {
+            PH_LUA_GC = 0,    ///< Шаг сборщика мусора Lua.
+            PH_READ_INPUTS,   ///< Чтение входов узлов I/O.
+            PH_EVALUATE_IO,   ///< Обработка устройств.
+            PH_VALVES,        ///< Обработка клапанов.
+            PH_TECH_OBJECTS,  ///< Обработка технологических объектов.
+            PH_WRITE_OUTPUTS, ///< Запись выходов узлов I/O.
+            PH_COMMUNICATION, ///< Обмен с сервером.
+            PH_PARAMS,        ///< Сохранение параметров.
+            PH_OPC_UA,        ///< Сервер OPC UA.
+            PH_IOT,           ///< Дополнительные устройства.
+            PH_ERRORS,        ///< Обработка ошибок, PAC_info.
+            PH_SLEEP,         ///< Ожидание (sleep_ms).
+
+            PHASES_COUNT
+            };
+
+        static cycle_profiler* get_instance();
+
+        /// @brief Начало цикла.
+        void start_cycle();
+
+        /// @brief Окончание этапа (время отсчитывается от предыдущей
+        /// отметки). Этап может встречаться в цикле несколько раз.
+        void end_phase( PHASES phase );
+
+        /// @brief Окончание цикла - добавление времени в гистограммы.
+        void end_cycle();
+
+        /// @brief Сброс статистики.
+        void reset();
+
+        const time_histogram& get_phase_hist( PHASES phase ) const;
+
+        const time_histogram& get_cycle_hist() const;
+
+        /// @brief Время этапа в самом долгом цикле, мкс.
+        uint32_t get_worst_cycle_phase_time( PHASES phase ) const;
+
+        /// @brief Время работы (без ожидания) предыдущего цикла, мкс.
+        uint32_t get_last_cycle_work_time() const;
+
+        static const char* get_phase_name( PHASES phase );
+
+        /// @brief Класс задач этапа (для ожидания - TASK_CLASSES_COUNT).
+        static cycle_scheduler::TASK_CLASSES get_phase_task_class(
+            PHASES phase );
+
+        const time_histogram& get_task_hist(
+            cycle_scheduler::TASK_CLASSES task_class ) const;
+
+        /// @brief Время класса задач в самом долгом цикле, мкс.
+        uint32_t get_worst_cycle_task_time(
+            cycle_scheduler::TASK_CLASSES task_class ) const;
+
+        /// @brief Сохранение статистики в виде скрипта Lua.
+        ///
+        /// @param buff     - буфер.
+        /// @param max_size - размер буфера.
+        ///
+        /// @return - размер записанной строки (без завершающего \0).
+        int save_as_Lua_str( char* buff, int max_size ) const;
+
+    private:
+        cycle_profiler() = default;
+
+        uint64_t cycle_start_time{};  ///< Время начала цикла, мкс.
+        uint64_t phase_start_time{};  ///< Время начала этапа, мкс.
+        bool is_cycle_started{ false };
+
+        uint32_t phase_time[ PHASES_COUNT ]{};  ///< Время этапов цикла, мкс.
+
+        time_histogram phases_hist[ PHASES_COUNT ];
+        time_histogram cycle_hist;
+
+        uint32_t worst_cycle_time{};
+        uint32_t last_cycle_work_time{};
+        uint32_t worst_phase_time[ PHASES_COUNT ]{};
+
+        time_histogram tasks_hist[ cycle_scheduler::TASK_CLASSES_COUNT ];
+        uint32_t worst_task_time[ cycle_scheduler::TASK_CLASSES_COUNT ]{};
+
+        static auto_smart_ptr < cycle_profiler > instance;
+    };
+//-----------------------------------------------------------------------------
+cycle_profiler* G_CYCLE_PROFILER();
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <thread>
+
+#if defined LINUX_OS
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#endif // defined LINUX_OS
+
+#include "log.h"
+
+#include "cycle_scheduler.h"
+
+auto_smart_ptr < cycle_scheduler > cycle_scheduler::instance;
+//-----------------------------------------------------------------------------
+cycle_scheduler* cycle_scheduler::get_instance()
+    {
+    if ( instance.is_null() )
+        {
+        instance = new cycle_scheduler();
+        }
+
+    return instance;
+    }
+//-----------------------------------------------------------------------------
+void cycle_scheduler::set_period( u_int new_period_ms )
+    {
+    if ( new_period_ms == period_ms )
+        {
+        return;
+        }
+
+    period_ms = new_period_ms;
+    period = std::chrono::milliseconds( period_ms );
+    is_started = false;
+    }
+//-----------------------------------------------------------------------------
+u_int cycle_scheduler::get_period() const
+    {
+    return period_ms;
+    }
+//-----------------------------------------------------------------------------
+bool cycle_scheduler::is_active() const
+    {
+    return period_ms > 0;
+    }
+//-----------------------------------------------------------------------------
+void cycle_scheduler::wait_next_cycle()
+    {
+    if ( !is_active() )
+        {
+        return;
+        }
+
+    auto now = clock::now();
+    if ( !is_started )
+        {
+        is_started = true;
+        next_deadline = now + period;
+        }
+
+    if ( now >= next_deadline )
+        {
+        // Цикл опоздал - ожидание не выполняется.
+        auto late = static_cast<uint32_t>( std::chrono::duration_cast<
+            std::chrono::microseconds>( now - next_deadline ).count() );
+        overruns_count++;
+        max_overrun = std::max( max_overrun, late );
+
+        if ( now - next_deadline >= period )
+            {
+            // Пропущен целый период - сдвигаем расписание.
+            next_deadline = now;
+            }
+        next_deadline += period;
+        return;
+        }
+
+    sleep_until( next_deadline );
+    jitter_hist.add( static_cast<uint32_t>( std::chrono::duration_cast<
+        std::chrono::microseconds>( clock::now() - next_deadline ).count() ) );
+    next_deadline += period;
+    }
+//-----------------------------------------------------------------------------
+void cycle_scheduler::reset()
+    {
+    jitter_hist.clear();
+    overruns_count = 0;
+    max_overrun = 0;
+
+    for ( auto& task : tasks )
+        {
+        task.runs_count = 0;
+        task.overruns_count = 0;
+        }
+    }
+//-----------------------------------------------------------------------------
+const time_histogram& cycle_scheduler::get_jitter_hist() const
+    {
+    return jitter_hist;
+    }
+//-----------------------------------------------------------------------------
+u_int cycle_scheduler::get_overruns_count() const
+    {
+    return overruns_count;
+    }
+//-----------------------------------------------------------------------------
+uint32_t cycle_scheduler::get_max_overrun() const
+    {
+    return max_overrun;
+    }
+//-----------------------------------------------------------------------------
+void cycle_scheduler::set_task_period( TASK_CLASSES task_class,
+    u_int period_ms )
+    {
+    auto& task = tasks[ task_class ];
+    clock::duration new_period = std::chrono::milliseconds( period_ms );
+    if ( new_period == task.period )
+        {
+        return;
+        }
+
+    task.period = new_period;
+    task.is_started = false;
+    }
+//-----------------------------------------------------------------------------
+bool cycle_scheduler::is_task_due( TASK_CLASSES task_class )
+    {
+    auto& task = tasks[ task_class ];
+    task.is_executed = false;
+
+    if ( task.period.count() > 0 )
+        {
+        auto now = clock::now();
+        if ( !task.is_started )
+            {
+            task.is_started = true;
+            task.next_run = now;
+            }
+
+        if ( now < task.next_run )
+            {
+            return false;
+            }
+
+        if ( now - task.next_run >= task.period )
+            {
+            // Пропущен целый период класса - сдвигаем расписание.
+            task.overruns_count++;
+            task.next_run = now;
+            }
+        task.next_run += task.period;
+        }
+
+    task.is_executed = true;
+    task.runs_count++;
+    return true;
+    }
+//-----------------------------------------------------------------------------
+bool cycle_scheduler::is_task_executed( TASK_CLASSES task_class ) const
+    {
+    return tasks[ task_class ].is_executed;
+    }
+//-----------------------------------------------------------------------------
+u_int cycle_scheduler::get_task_runs_count( TASK_CLASSES task_class ) const
+    {
+    return tasks[ task_class ].runs_count;
+    }
+//-----------------------------------------------------------------------------
+u_int cycle_scheduler::get_task_overruns_count( TASK_CLASSES task_class ) const
+    {
+    return tasks[ task_class ].overruns_count;
+    }
+//-----------------------------------------------------------------------------
+const char* cycle_scheduler::get_task_class_name( TASK_CLASSES task_class )
+    {
+    switch ( task_class )
+        {
+        case TC_FAST:   return "FAST";
+        case TC_NORMAL: return "NORMAL";
+        case TC_SLOW:   return "SLOW";
+
+        default:
+            return "?";
+        }
+    }
+//-----------------------------------------------------------------------------
+void cycle_scheduler::sleep_until( clock::time_point deadline )
+    {
+#if defined LINUX_OS
+    // std::chrono::steady_clock в Linux - CLOCK_MONOTONIC, ожидание до
+    // абсолютного момента не накапливает ошибку при прерываниях сигналами.
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline.time_since_epoch() ).count();
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>( ns / 1'000'000'000 );
+    ts.tv_nsec = static_cast<long>( ns % 1'000'000'000 );
+    while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+        nullptr ) == EINTR )
+        {
+        }
+#else
+    std::this_thread::sleep_until( deadline );
+#endif // defined LINUX_OS
+    }
+//-----------------------------------------------------------------------------
+int cycle_scheduler::setup_current_thread( int cpu_core, int rt_priority )
+    {
+    auto res = 0;
+#if defined LINUX_OS
+    if ( cpu_core >= 0 )
+        {
+        cpu_set_t cpuset;
+        CPU_ZERO( &cpuset );
+        CPU_SET( cpu_core, &cpuset );
+        if ( auto err = pthread_setaffinity_np( pthread_self(),
+            sizeof( cpuset ), &cpuset ); err )
+            {
+            G_LOG->warning( "Can't bind main thread to CPU core %d: %s.",
+                cpu_core, strerror( err ) );
+            res = 1;
+            }
+        else
+            {
+            G_LOG->info( "Main thread is bound to CPU core %d.", cpu_core );
+            }
+        }
+
+    if ( rt_priority > 0 )
+        {
+        sched_param param{};
+        param.sched_priority = rt_priority;
+        if ( auto err = pthread_setschedparam( pthread_self(), SCHED_FIFO,
+            &param ); err )
+            {
+            G_LOG->warning( "Can't set real-time priority %d (SCHED_FIFO): %s.",
+                rt_priority, strerror( err ) );
+            res = 1;
+            }
+        else
+            {
+            G_LOG->info( "Main thread real-time priority is %d (SCHED_FIFO).",
+                rt_priority );
+            }
+        }
+#else
+    if ( cpu_core >= 0 || rt_priority > 0 )
+        {
+        G_LOG->warning( "CPU core binding and real-time priority are "
+            "supported only on Linux." );
+        res = 1;
+        }
+#endif // defined LINUX_OS
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+cycle_scheduler* G_CYCLE_SCHEDULER()
+    {
+    return cycle_scheduler::get_instance();
+    }
+//-----------------------------------------------------------------------------
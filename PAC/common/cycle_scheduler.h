@@ -0,0 +1,134 @@
+/// @file cycle_scheduler.h
+/// @brief Планировщик основного цикла программы с фиксированным периодом.
+
+#pragma once
+
+#include <chrono>
+
+#include "smart_ptr.h"
+#include "dtime.h"
+
+//-----------------------------------------------------------------------------
+/// @brief Планировщик основного цикла с фиксированным периодом.
+///
+/// Вместо ожидания фиксированного времени (sleep_ms) после каждого этапа
+/// цикла выполняется ожидание до абсолютного момента начала следующего
+/// цикла (монотонное время), поэтому период не зависит от нагрузки. Если
+/// цикл опоздал, ожидание пропускается; при опоздании больше чем на период
+/// расписание сдвигается (пропущенные циклы не выполняются подряд).
+/// Собирается статистика: задержка пробуждения (джиттер, мкс), количество
+/// и максимальная длительность превышений периода.
+///
+/// Задачи цикла разделены на классы (@ref TASK_CLASSES) с собственным
+/// периодом выполнения (0 - каждый цикл): редко нужные задачи не занимают
+/// время каждого цикла.
+class cycle_scheduler
+    {
+    public:
+        enum TASK_CLASSES   ///< Классы задач основного цикла.
+            {
+            TC_FAST = 0,    ///< Обмен с узлами I/O, обработка устройств.
+            TC_NORMAL,      ///< Управление (технологические объекты, Lua),
+                            ///< обмен с сервером, OPC UA.
+            TC_SLOW,        ///< Обслуживание (параметры, ошибки, PAC_info).
+
+            TASK_CLASSES_COUNT
+            };
+
+        static cycle_scheduler* get_instance();
+
+        /// @brief Установка периода цикла.
+        ///
+        /// @param period_ms - период, мсек (0 - планировщик отключен).
+        void set_period( u_int period_ms );
+
+        u_int get_period() const;
+
+        /// @brief Признак работы планировщика (период задан).
+        bool is_active() const;
+
+        /// @brief Ожидание начала следующего цикла.
+        void wait_next_cycle();
+
+        /// @brief Сброс статистики.
+        void reset();
+
+        /// @brief Задержка пробуждения относительно заданного момента, мкс.
+        const time_histogram& get_jitter_hist() const;
+
+        /// @brief Количество циклов, превысивших период.
+        u_int get_overruns_count() const;
+
+        /// @brief Максимальное превышение периода, мкс.
+        uint32_t get_max_overrun() const;
+
+        /// @brief Установка периода выполнения класса задач.
+        ///
+        /// @param task_class - класс задач.
+        /// @param period_ms  - период, мсек (0 - каждый цикл).
+        void set_task_period( TASK_CLASSES task_class, u_int period_ms );
+
+        /// @brief Проверка необходимости выполнения класса задач в текущем
+        /// цикле. Вызывается один раз за цикл для каждого класса.
+        ///
+        /// Если класс задач опоздал больше чем на свой период (время цикла
+        /// больше периода класса), учитывается превышение, расписание
+        /// класса сдвигается.
+        ///
+        /// @return - true - задачи класса необходимо выполнить.
+        bool is_task_due( TASK_CLASSES task_class );
+
+        /// @brief Признак выполнения класса задач в текущем цикле.
+        bool is_task_executed( TASK_CLASSES task_class ) const;
+
+        /// @brief Количество выполнений класса задач.
+        u_int get_task_runs_count( TASK_CLASSES task_class ) const;
+
+        /// @brief Количество превышений периода класса задач.
+        u_int get_task_overruns_count( TASK_CLASSES task_class ) const;
+
+        static const char* get_task_class_name( TASK_CLASSES task_class );
+
+        /// @brief Привязка текущего потока к ядру процессора и установка
+        /// приоритета реального времени (только Linux).
+        ///
+        /// @param cpu_core    - номер ядра (-1 - без привязки).
+        /// @param rt_priority - приоритет SCHED_FIFO (0 - без изменения).
+        ///
+        /// @return - 0 - ок, 1 - ошибка (подробности выводятся в лог).
+        static int setup_current_thread( int cpu_core, int rt_priority );
+
+    private:
+        cycle_scheduler() = default;
+
+        using clock = std::chrono::steady_clock;
+
+        /// @brief Ожидание до заданного момента.
+        static void sleep_until( clock::time_point deadline );
+
+        u_int period_ms{};
+        clock::duration period{};
+        clock::time_point next_deadline;
+        bool is_started{ false };
+
+        time_histogram jitter_hist;
+        u_int overruns_count{};
+        uint32_t max_overrun{};
+
+        struct task_state
+            {
+            clock::duration period{};
+            clock::time_point next_run;
+            bool is_started{ false };
+            bool is_executed{ false };
+
+            u_int runs_count{};
+            u_int overruns_count{};
+            };
+
+        task_state tasks[ TASK_CLASSES_COUNT ];
+
+        static auto_smart_ptr < cycle_scheduler > instance;
+    };
+//-----------------------------------------------------------------------------
+cycle_scheduler* G_CYCLE_SCHEDULER();
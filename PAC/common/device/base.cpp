@@ -263,6 +263,36 @@ void device::set_string_property( const char* field, const char* new_value )
 //-----------------------------------------------------------------------------
 int device::save_device( char* buff ) const
     {
+    auto st = type != DT_AO ? get_state() : 0;
+    auto val = is_value_saved() ? get_value() : .0f;
+    char ex_buff[ MAX_COPY_SIZE + 1 ];
+    auto ex_size = save_device_ex( ex_buff );
+
+    // Ключ - данные, из которых формируется строка устройства. Если они не
+    // изменились, строка не формируется заново (копируется сохраненная).
+    static thread_local std::string key;
+    key.clear();
+    key.append( reinterpret_cast<const char*>( &is_manual_mode ),
+        sizeof( is_manual_mode ) );
+    key.append( reinterpret_cast<const char*>( &st ), sizeof( st ) );
+    key.append( reinterpret_cast<const char*>( &val ), sizeof( val ) );
+    key.append( ex_buff, ex_size );
+    if ( par )
+        {
+        for ( u_int i = 1; i <= par->get_count(); i++ )
+            {
+            const auto& p = par[ 0 ][ i ];
+            key.append( reinterpret_cast<const char*>( &p ), sizeof( p ) );
+            key += par_name[ i - 1 ] ? '1' : '0';
+            }
+        }
+
+    if ( key == cached_key )
+        {
+        memcpy( buff, cached_fragment.data(), cached_fragment.size() );
+        return static_cast<int>( cached_fragment.size() );
+        }
+
     // LCOV_EXCL_START
     auto res = static_cast<int>( fmt::format_to_n( buff, MAX_COPY_SIZE,
         "{}={{M={:d}, ", name, is_manual_mode ).size );
@@ -271,30 +301,19 @@ int device::save_device( char* buff ) const
     if ( type != DT_AO )
         {
         res += fmt::format_to_n( buff + res, MAX_COPY_SIZE, "ST={}, ",
-            get_state() ).size;
+            st ).size;
         }
 
-    if ( type != DT_V &&
-
-        type != DT_FS &&
-        type != DT_GS &&
-
-        type != DT_HA &&
-        type != DT_HL &&
-        type != DT_SB &&
-        !( type == DT_LS && ( sub_type == DST_LS_MAX || sub_type == DST_LS_MIN ) ) &&
-
-        type != DT_DI &&
-        type != DT_DO )
+    if ( is_value_saved() )
         {
-        auto val = get_value();
         double tmp;
         int precision = modf( val, &tmp ) == 0 ? 0 : 2;
         res += fmt::format_to_n( buff + res, MAX_COPY_SIZE, "V={:.{}f}, ",
             val, precision ).size;
         }
 
-    res += save_device_ex( buff + res );
+    memcpy( buff + res, ex_buff, ex_size );
+    res += ex_size;
     res += par_device::save_device( buff + res );
 
     if ( const auto extra_symbols_length = 2;
@@ -303,9 +322,65 @@ int device::save_device( char* buff ) const
         res -= extra_symbols_length;
         }
     res += fmt::format_to_n( buff + res, MAX_COPY_SIZE, "}},\n" ).size;
+
+    cached_key = key;
+    cached_fragment.assign( buff, res );
     return res;
     }
 //-----------------------------------------------------------------------------
+void device::save_device_binary( binary_state_writer& writer ) const
+    {
+    writer.write_uint( "M", is_manual_mode );
+    if ( type != DT_AO )
+        {
+        writer.write_int( "ST", get_state() );
+        }
+    if ( is_value_saved() )
+        {
+        writer.write_float( "V", get_value() );
+        }
+
+    save_device_ex_binary( writer );
+
+    if ( par )
+        {
+        for ( u_int i = 0; i < par->get_count(); i++ )
+            {
+            if ( par_name[ i ] )
+                {
+                writer.write_float( par_name[ i ], par[ 0 ][ i + 1 ] );
+                }
+            }
+        }
+    }
+//-----------------------------------------------------------------------------
+void device::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    char ex_buff[ MAX_COPY_SIZE + 1 ];
+    auto size = save_device_ex( ex_buff );
+    if ( size > 0 )
+        {
+        ex_buff[ size ] = '\0';
+        writer.write_Lua_fields( ex_buff );
+        }
+    }
+//-----------------------------------------------------------------------------
+bool device::is_value_saved() const
+    {
+    return type != DT_V &&
+
+        type != DT_FS &&
+        type != DT_GS &&
+
+        type != DT_HA &&
+        type != DT_HL &&
+        type != DT_SB &&
+        !( type == DT_LS && ( sub_type == DST_LS_MAX || sub_type == DST_LS_MIN ) ) &&
+
+        type != DT_DI &&
+        type != DT_DO;
+    }
+//-----------------------------------------------------------------------------
 void device::evaluate_io()
     {
     //Do nothing by default.
@@ -728,6 +803,12 @@ int virtual_counter::save_device_ex( char* buff ) const
     return res;
     }
 
+void virtual_counter::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_uint( "ABS_V", get_abs_quantity() );
+    writer.write_float( "F", get_flow() );
+    }
+
 u_long virtual_counter::get_pump_dt() const
     {
     return 0;
@@ -870,6 +951,11 @@ int level::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void level::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_int( "CLEVEL", get_volume() );
+    }
+//-----------------------------------------------------------------------------
 float level::get_max_val() const
     {
     return 100;
@@ -1107,6 +1193,19 @@ int signal_column::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void signal_column::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_bool( "L_GREEN",
+        green.step == STEP::on || green.step == STEP::blink_on );
+    writer.write_bool( "L_YELLOW",
+        yellow.step == STEP::on || yellow.step == STEP::blink_on );
+    writer.write_bool( "L_RED",
+        red.step == STEP::on || red.step == STEP::blink_on );
+    writer.write_bool( "L_BLUE",
+        blue.step == STEP::on || blue.step == STEP::blink_on );
+    writer.write_bool( "L_SIREN", siren_step == STEP::on );
+    }
+//-----------------------------------------------------------------------------
 void signal_column::evaluate_io()
     {
     //Так как колонну могут использовать несколько аппаратов
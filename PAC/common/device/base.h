@@ -6,12 +6,14 @@
 
 #pragma once
 #include <array>
+#include <string>
 
 #include "s_types.h"
 #include "param_ex.h"
 #include "analog_emulator.h"
 #include "bus_coupler_io.h"
 #include "i_base.h"
+#include "binary_state.h"
 
 class PID;
 
@@ -138,6 +140,12 @@ class device : public i_DO_AO_device, public par_device
         /// @param buff [out] - буфер записи строки.
         int save_device( char* buff ) const override;
 
+        /// @brief Сохранение состояния устройства в двоичном виде - те же
+        /// поля, что и в @ref save_device.
+        ///
+        /// @param writer - запись состояния.
+        virtual void save_device_binary( binary_state_writer& writer ) const;
+
         /// @brief Расчет состояния на основе текущих данных от I/O.
         virtual void evaluate_io();
 
@@ -516,6 +524,14 @@ class device : public i_DO_AO_device, public par_device
             return 0;
             }
 
+        /// @brief Сохранение дополнительных данных устройства (те же поля,
+        /// что и в @ref save_device_ex) в двоичном виде.
+        ///
+        /// По умолчанию разбирается строка @ref save_device_ex.
+        ///
+        /// @param writer - запись состояния.
+        virtual void save_device_ex_binary( binary_state_writer& writer ) const;
+
         bool get_manual_mode() const override
             {
             return is_manual_mode;
@@ -550,6 +566,9 @@ class device : public i_DO_AO_device, public par_device
             }
 
     private:
+        /// @brief Признак передачи значения устройства (поле V).
+        bool is_value_saved() const;
+
         u_int_4 s_number = 0;        ///< Последовательный номер устройства.
 
         DEVICE_TYPE     type;        ///< Тип устройства.
@@ -568,6 +587,11 @@ class device : public i_DO_AO_device, public par_device
         int state = 0;      ///< Состояние устройства.
         float value = .0f;  ///< Значение устройства.
 
+        /// @brief Строка устройства (@ref save_device) и данные, из которых
+        /// она получена.
+        mutable std::string cached_fragment;
+        mutable std::string cached_key;
+
         int prev_error_state = 0; //< Значение ошибки.
     };
 //-----------------------------------------------------------------------------
@@ -602,6 +626,7 @@ class analog_io_device : public device, public io_device
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         float get_value() const override;
     };
@@ -703,6 +728,7 @@ class virtual_counter : public device, public i_counter
 
         //Lua.
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         u_long get_pump_dt() const override;
         float get_min_flow() const override;
@@ -768,6 +794,7 @@ class level : public AI1
         virtual int calc_volume() const;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         float get_max_val() const override;
         float get_min_val() const override;
@@ -873,6 +900,7 @@ class signal_column : public device, public io_device
         int get_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
 #ifdef _MSC_VER
 #pragma region Сигнализация о событиях
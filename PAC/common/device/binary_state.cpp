@@ -0,0 +1,234 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "binary_state.h"
+
+//-----------------------------------------------------------------------------
+binary_state_writer::binary_state_writer( char* buff,
+    std::vector< std::string >* fields ) : buff( buff ), fields( fields )
+    {
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_uint( const char* name, uint32_t value )
+    {
+    size += write_varint( buff + size, value );
+    add_field( name, strlen( name ), 'u' );
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_int( const char* name, int32_t value )
+    {
+    put_int( value );
+    add_field( name, strlen( name ), 'i' );
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_float( const char* name, float value )
+    {
+    put_float( value );
+    add_field( name, strlen( name ), 'f' );
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_bool( const char* name, bool value )
+    {
+    write_uint( name, value ? 1 : 0 );
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_ints( const char* name,
+    std::initializer_list< int32_t > values )
+    {
+    auto name_len = strlen( name );
+    auto i = 1;
+    for ( auto value : values )
+        {
+        put_int( value );
+        add_field( name, name_len, 'i', i++ );
+        }
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_floats( const char* name,
+    std::initializer_list< float > values )
+    {
+    auto name_len = strlen( name );
+    auto i = 1;
+    for ( auto value : values )
+        {
+        put_float( value );
+        add_field( name, name_len, 'f', i++ );
+        }
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::write_Lua_fields( const char* str )
+    {
+    const char* end = str + strlen( str );
+    const char* pos = str;
+    while ( pos < end )
+        {
+        // Имя поля.
+        while ( pos < end && ( *pos == ' ' || *pos == ',' ) ) pos++;
+        auto name = pos;
+        while ( pos < end && *pos != '=' ) pos++;
+        if ( pos >= end )
+            {
+            break;
+            }
+        auto name_len = static_cast<size_t>( pos - name );
+        pos++;
+
+        if ( *pos == '{' )
+            {
+            pos++;
+            for ( int i = 1; pos < end && *pos != '}'; )
+                {
+                char* num_end;
+                auto value = strtof( pos, &num_end );
+                if ( num_end == pos )
+                    {
+                    // Не число - элемент пропускается.
+                    pos = skip_value( pos, end );
+                    }
+                else
+                    {
+                    pos = num_end;
+                    put_float( value );
+                    add_field( name, name_len, 'f', i++ );
+                    }
+                while ( pos < end && ( *pos == ',' || *pos == ' ' ) ) pos++;
+                }
+            pos++;
+            continue;
+            }
+
+        if ( strncmp( pos, "true", 4 ) == 0 || strncmp( pos, "false", 5 ) == 0 )
+            {
+            auto value = *pos == 't';
+            size += write_varint( buff + size, value ? 1 : 0 );
+            add_field( name, name_len, 'u' );
+            pos += value ? 4 : 5;
+            continue;
+            }
+
+        char* num_end;
+        auto value = strtof( pos, &num_end );
+        if ( num_end == pos )
+            {
+            // Строка или другое значение - пропускается.
+            pos = skip_value( pos, end );
+            continue;
+            }
+        pos = num_end;
+
+        put_float( value );
+        add_field( name, name_len, 'f' );
+        }
+    }
+//-----------------------------------------------------------------------------
+int binary_state_writer::get_size() const
+    {
+    return size;
+    }
+//-----------------------------------------------------------------------------
+int binary_state_writer::get_fields_count() const
+    {
+    return fields_count;
+    }
+//-----------------------------------------------------------------------------
+int binary_state_writer::write_varint( char* buff, uint32_t value )
+    {
+    auto res = 0;
+    while ( value >= 0x80 )
+        {
+        buff[ res++ ] = static_cast<char>( value | 0x80 );
+        value >>= 7;
+        }
+    buff[ res++ ] = static_cast<char>( value );
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+int binary_state_writer::read_varint( const char* buff, uint32_t& value )
+    {
+    value = 0;
+    auto res = 0;
+    for ( int shift = 0; shift < 35; shift += 7 )
+        {
+        auto b = static_cast<uint8_t>( buff[ res++ ] );
+        value |= static_cast<uint32_t>( b & 0x7F ) << shift;
+        if ( !( b & 0x80 ) )
+            {
+            break;
+            }
+        }
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::put_int( int32_t value )
+    {
+    // Zigzag - небольшие по модулю отрицательные числа занимают мало байт.
+    auto zigzag = ( static_cast<uint32_t>( value ) << 1 ) ^
+        static_cast<uint32_t>( value >> 31 );
+    size += write_varint( buff + size, zigzag );
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::put_float( float value )
+    {
+    uint32_t bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+    for ( int i = 0; i < 4; i++ )
+        {
+        buff[ size++ ] = static_cast<char>( bits >> ( 8 * i ) );
+        }
+    }
+//-----------------------------------------------------------------------------
+const char* binary_state_writer::skip_value( const char* pos,
+    const char* end )
+    {
+    auto depth = 0;
+    while ( pos < end )
+        {
+        switch ( *pos )
+            {
+            case '\'':
+            case '"':
+                {
+                auto quote = *pos++;
+                while ( pos < end && *pos != quote ) pos++;
+                break;
+                }
+
+            case '{':
+                depth++;
+                break;
+
+            case '}':
+                if ( 0 == depth ) return pos;
+                depth--;
+                break;
+
+            case ',':
+                if ( 0 == depth ) return pos;
+                break;
+
+            default:
+                break;
+            }
+        pos++;
+        }
+
+    return end;
+    }
+//-----------------------------------------------------------------------------
+void binary_state_writer::add_field( const char* name, size_t name_len,
+    char type, int item )
+    {
+    fields_count++;
+    if ( fields )
+        {
+        fields->emplace_back( name, name_len );
+        if ( item > 0 )
+            {
+            fields->back() += "[" + std::to_string( item ) + "]";
+            }
+        fields->back() += ':';
+        fields->back() += type;
+        }
+    }
@@ -0,0 +1,86 @@
+/// @file binary_state.h
+/// @brief Компактное двоичное представление состояния устройств.
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+/// @brief Запись состояния устройства в компактном двоичном виде (вместо
+/// скрипта Lua).
+///
+/// Беззнаковые целые записываются как varint, знаковые - как zigzag varint,
+/// дробные - как float32 (little endian). Имена и типы полей в ответе не
+/// передаются - они образуют схему, которая передается один раз: если задан
+/// список полей, в него добавляются описания записанных полей в виде
+/// "ИМЯ:ТИП" (u - беззнаковое и логическое, i - знаковое, f - дробное).
+/// Элементы массивов записываются как поля "ИМЯ[1]", "ИМЯ[2]", ...
+class binary_state_writer
+    {
+    public:
+        /// @param buff   - буфер записи.
+        /// @param fields - список полей (схема), nullptr - не формируется.
+        explicit binary_state_writer( char* buff,
+            std::vector< std::string >* fields = nullptr );
+
+        void write_uint( const char* name, uint32_t value );
+
+        void write_int( const char* name, int32_t value );
+
+        void write_float( const char* name, float value );
+
+        void write_bool( const char* name, bool value );
+
+        void write_ints( const char* name,
+            std::initializer_list< int32_t > values );
+
+        void write_floats( const char* name,
+            std::initializer_list< float > values );
+
+        /// @brief Запись полей из строки скрипта Lua (для устройств без
+        /// записи в двоичном виде).
+        ///
+        /// Поля вида "ИМЯ=число, " записываются как дробные, "ИМЯ=true" и
+        /// "ИМЯ=false" - как логические, массивы ("ИМЯ={число,число}") -
+        /// поэлементно. Строки и другие значения пропускаются.
+        ///
+        /// @param str - строка (с завершающим \0).
+        void write_Lua_fields( const char* str );
+
+        /// @brief Размер записанных данных, байт.
+        int get_size() const;
+
+        /// @brief Количество записанных полей.
+        int get_fields_count() const;
+
+        /// @brief Запись varint.
+        ///
+        /// @return - количество записанных байт.
+        static int write_varint( char* buff, uint32_t value );
+
+        /// @brief Чтение varint.
+        ///
+        /// @return - количество прочитанных байт.
+        static int read_varint( const char* buff, uint32_t& value );
+
+    private:
+        void put_int( int32_t value );
+
+        void put_float( float value );
+
+        /// @brief Пропуск значения поля (до ',' или '}' вне вложенных
+        /// таблиц и строк).
+        static const char* skip_value( const char* pos, const char* end );
+
+        /// @param item - номер элемента массива (0 - не массив).
+        void add_field( const char* name, size_t name_len, char type,
+            int item = 0 );
+
+        char* buff;
+        int size = 0;
+        int fields_count = 0;
+        std::vector< std::string >* fields;
+    };
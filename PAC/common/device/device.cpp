@@ -243,6 +243,12 @@ int camera::save_device_ex( char* buff ) const
     return res;
     }
 
+void camera::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_int( "RESULT", get_result() );
+    writer.write_bool( "READY", is_cam_ready );
+    }
+
 int camera::set_cmd( const char* prop, u_int idx, double val )
     {
     if ( strcmp( prop, "RESULT" ) == 0 )
@@ -857,6 +863,34 @@ int power_unit::save_device_ex( char* buff ) const
     return size;
     }
 //-----------------------------------------------------------------------------
+void power_unit::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_floats( "NOMINAL_CURRENT_CH", {
+        decode_nominal_current( p_data_in.nominal_current_ch1 ),
+        decode_nominal_current( p_data_in.nominal_current_ch2 ),
+        decode_nominal_current( p_data_in.nominal_current_ch3 ),
+        decode_nominal_current( p_data_in.nominal_current_ch4 ),
+        decode_nominal_current( p_data_in.nominal_current_ch5 ),
+        decode_nominal_current( p_data_in.nominal_current_ch6 ),
+        decode_nominal_current( p_data_in.nominal_current_ch7 ),
+        decode_nominal_current( p_data_in.nominal_current_ch8 ) } );
+    writer.write_floats( "LOAD_CURRENT_CH", {
+        .1f * p_data_in.load_current_ch1, .1f * p_data_in.load_current_ch2,
+        .1f * p_data_in.load_current_ch3, .1f * p_data_in.load_current_ch4,
+        .1f * p_data_in.load_current_ch5, .1f * p_data_in.load_current_ch6,
+        .1f * p_data_in.load_current_ch7, .1f * p_data_in.load_current_ch8 } );
+    writer.write_ints( "ST_CH", {
+        p_data_in.status_ch1, p_data_in.status_ch2,
+        p_data_in.status_ch3, p_data_in.status_ch4,
+        p_data_in.status_ch5, p_data_in.status_ch6,
+        p_data_in.status_ch7, p_data_in.status_ch8 } );
+    writer.write_float( "SUM_CURRENTS", v );
+    writer.write_float( "VOLTAGE", .1f * static_cast<float>(
+        ( ( p_data_in.out_voltage_2 << 8 ) + p_data_in.out_voltage ) ) );
+    writer.write_bool( "OUT_POWER_90", p_data_in.out_power_90 );
+    writer.write_int( "ERR", err );
+    }
+//-----------------------------------------------------------------------------
 void power_unit::direct_on()
     {
     p_data_out->switch_ch1 = true;
@@ -1418,6 +1452,15 @@ int base_counter::save_device_ex( char* buff ) const
     // LCOV_EXCL_STOP
     }
 //-----------------------------------------------------------------------------
+void base_counter::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_uint( "ABS_V", get_abs_quantity() );
+    writer.write_float( "DAY_T1", day_t1_value );
+    writer.write_float( "PREV_DAY_T1", prev_day_t1_value );
+    writer.write_float( "DAY_T2", day_t2_value );
+    writer.write_float( "PREV_DAY_T2", prev_day_t2_value );
+    }
+//-----------------------------------------------------------------------------
 const char* base_counter::get_error_description()
     {
     if ( auto err_id = get_error_id(); err_id < 0 )
@@ -1538,6 +1581,12 @@ int counter_f::save_device_ex( char *buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void counter_f::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    counter::save_device_ex_binary( writer );
+    writer.write_float( "F", get_flow() );
+    }
+//-----------------------------------------------------------------------------
 u_long counter_f::get_pump_dt() const
     {
     return static_cast<u_long>( get_par( P_DT, 0 ) );
@@ -1663,6 +1712,13 @@ int counter_iolink::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void counter_iolink::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    base_counter::save_device_ex_binary( writer );
+    writer.write_float( "F", get_flow() );
+    writer.write_float( "T", get_temperature() );
+    }
+//-----------------------------------------------------------------------------
 int counter_iolink::set_cmd( const char* prop, u_int idx, double val )
     {
     switch ( prop[ 0 ] )
@@ -2441,6 +2497,11 @@ int wages::save_device_ex( char* buff ) const
         get_value() ).size );
     }
 //-----------------------------------------------------------------------------
+void wages::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_float( "W", get_value() );
+    }
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 level_e::level_e( const char* dev_name ) : level(
     dev_name, DST_LT, 0 )
@@ -2940,6 +3001,30 @@ int motor::save_device_ex( char *buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void motor::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    if ( G_PAC_INFO()->is_emulator() )
+        {
+        writer.write_int( "R", 0 );
+        writer.write_int( "ERRT", 0 );
+        return;
+        }
+
+    if ( auto sub_type = get_sub_type();
+        sub_type == device::DST_M_REV || sub_type == device::DST_M_REV_FREQ ||
+        sub_type == device::DST_M_REV_2 || sub_type == device::DST_M_REV_FREQ_2 ||
+        sub_type == device::M_REV_2_ERROR ||
+        sub_type == device::DST_M_REV_FREQ_2_ERROR )
+        {
+        writer.write_int( "R", get_DO( DO_INDEX_REVERSE ) );
+        if ( sub_type == device::M_REV_2_ERROR ||
+            sub_type == device::DST_M_REV_FREQ_2_ERROR )
+            {
+            writer.write_int( "ERRT", get_DI( DI_INDEX_ERROR ) );
+            }
+        }
+    }
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 bool level_s::is_active()
     {
@@ -3563,6 +3648,22 @@ int circuit_breaker::save_device_ex( char *buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void circuit_breaker::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    writer.write_int( "ERR", err );
+    writer.write_int( "M", m );
+    writer.write_ints( "NOMINAL_CURRENT_CH", {
+        in_info.nominal_current_ch1, in_info.nominal_current_ch2,
+        in_info.nominal_current_ch3, in_info.nominal_current_ch4 } );
+    writer.write_floats( "LOAD_CURRENT_CH", {
+        .1f * in_info.load_current_ch1, .1f * in_info.load_current_ch2,
+        .1f * in_info.load_current_ch3, .1f * in_info.load_current_ch4 } );
+    writer.write_ints( "ST_CH", {
+        in_info.st_ch1, in_info.st_ch2, in_info.st_ch3, in_info.st_ch4 } );
+    writer.write_ints( "ERR_CH", {
+        in_info.err_ch1, in_info.err_ch2, in_info.err_ch3, in_info.err_ch4 } );
+    }
+//-----------------------------------------------------------------------------
 int circuit_breaker::set_cmd( const char *prop, u_int idx, double val )
     {
     if (G_DEBUG)
@@ -3799,6 +3900,13 @@ int concentration_e_ok::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void concentration_e_ok::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_int( "OK",
+        G_PAC_INFO()->is_emulator() ? 1 : get_DI( DI_INDEX ) );
+    }
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 concentration_e_iolink::concentration_e_iolink( const char* dev_name ) :
     analog_io_device( dev_name,
@@ -3823,6 +3931,12 @@ int concentration_e_iolink::save_device_ex( char *buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void concentration_e_iolink::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_float( "T", get_temperature() );
+    }
+//-----------------------------------------------------------------------------
 float concentration_e_iolink::get_temperature() const
     {
     return .1f * info->temperature;
@@ -3964,6 +4078,14 @@ int analog_io_device::save_device_ex( char* buff ) const
     return static_cast<int>( res.size );
     }
 //-----------------------------------------------------------------------------
+void analog_io_device::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_bool( "E", is_emulation() );
+    writer.write_float( "M_EXP", get_emulator().get_m_expec() );
+    writer.write_float( "S_DEV", get_emulator().get_st_deviation() );
+    }
+//-----------------------------------------------------------------------------
 float analog_io_device::get_value() const
     {
     if ( is_emulation() ) return get_emulator().get_value();
@@ -4218,6 +4340,28 @@ int motor_altivar::save_device_ex(char * buff) const
     return res;
     }
 
+void motor_altivar::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    if ( G_PAC_INFO()->is_emulator() )
+        {
+        writer.write_int( "R", reverse );
+        writer.write_float( "FRQ", freq );
+        writer.write_int( "RPM", rpm );
+        writer.write_int( "EST", est );
+        writer.write_float( "AMP", amperage );
+        writer.write_float( "MAX_FRQ", 0 );
+        }
+    else
+        {
+        writer.write_int( "R", atv->reverse );
+        writer.write_float( "FRQ", atv->frq_value );
+        writer.write_int( "RPM", atv->rpm_value );
+        writer.write_int( "EST", atv->remote_state );
+        writer.write_float( "AMP", atv->amperage );
+        writer.write_float( "MAX_FRQ", atv->frq_max );
+        }
+    }
+
 float motor_altivar::get_value() const
     {
     if ( G_PAC_INFO()->is_emulator() ) return freq;
@@ -4535,6 +4679,13 @@ int converter_iolink_ao::save_device_ex( char* buff ) const
     return res.size + l;
     }
 
+void converter_iolink_ao::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    analog_io_device::save_device_ex_binary( writer );
+    writer.write_floats( "CH", { v1, v2 } );
+    }
+
 int converter_iolink_ao::set_cmd( const char* prop, u_int idx, double val )
     {
     if ( strcmp( prop, "CH" ) == 0 )
@@ -431,6 +431,7 @@ class circuit_breaker : public analog_io_device
         explicit circuit_breaker(const char* dev_name);
 
         int save_device_ex(char* buff) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int set_cmd(const char* prop, u_int idx, double val) override;
 
@@ -577,6 +578,7 @@ class concentration_e_ok : public concentration_e
         int get_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
     private:
         enum CONSTANTS
@@ -594,6 +596,7 @@ class concentration_e_iolink : public analog_io_device
         ~concentration_e_iolink() override;
 
         int save_device_ex( char *buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         float get_temperature() const;
 
@@ -848,6 +851,7 @@ class wages : public analog_io_device, public i_wages
         int get_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
     private:
         mutable float weight = 0.f;
@@ -986,6 +990,7 @@ class motor : public i_motor, public io_device
         motor( const char* dev_name, device::DEVICE_SUB_TYPE sub_type );
 
         int save_device_ex( char *buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         float get_value() const override;
 
@@ -1032,6 +1037,7 @@ public:
         u_int par_cnt = 0 );
 
     int save_device_ex(char *buff) const override;
+    void save_device_ex_binary( binary_state_writer& writer ) const override;
 
     float get_value() const override;
 
@@ -1347,6 +1353,7 @@ class base_counter: public i_counter, public device, public io_device
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         const char* get_error_description() override;
 
@@ -1436,6 +1443,7 @@ class counter_f : public counter
         float get_flow() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
@@ -1469,6 +1477,7 @@ class counter_iolink : public base_counter
         float get_temperature() const;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int get_state() const override;
 
@@ -1602,6 +1611,7 @@ class camera : public i_camera, public device, public io_device
         void direct_on() override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
@@ -1785,6 +1795,7 @@ class power_unit : public analog_io_device
         void evaluate_io() override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
@@ -1937,6 +1948,7 @@ class converter_iolink_ao : public analog_io_device
         void evaluate_io() override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
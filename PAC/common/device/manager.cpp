@@ -356,6 +356,11 @@ size_t device_manager::get_device_count() const
     return project_devices.size();
     }
 //-----------------------------------------------------------------------------
+u_int device_manager::get_config_version() const
+    {
+    return config_version;
+    }
+//-----------------------------------------------------------------------------
 const char* device_manager::get_name_in_Lua() const
     {
     return "Device manager";
@@ -1471,6 +1476,7 @@ io_device* device_manager::add_io_device( int dev_type, int dev_sub_type,
 
     u_int new_dev_index = project_devices.size();
     project_devices.push_back( new_device );
+    config_version++;
     new_device->set_serial_n( new_dev_index );
     new_device->set_article( article );
 
@@ -1503,6 +1509,7 @@ void device_manager::clear_io_devices()
         }
 
     project_devices.clear();
+    config_version++;
 
     valve::clear_switching_off_queue();
     valve::clear_v_bistable();
@@ -1535,6 +1542,7 @@ int device_manager::add_device( device* new_device, device::DEVICE_TYPE dev_type
     {
     u_int new_dev_index = project_devices.size();
     project_devices.push_back( new_device );
+    config_version++;
     new_device->set_serial_n( new_dev_index );
 
     if ( dev_type >= 0 && dev_type < device::C_DEVICE_TYPE_CNT )
@@ -1562,6 +1570,7 @@ int device_manager::add_device( device* new_device, device::DEVICE_TYPE dev_type
 int device_manager::remove_device( u_int idx )
     {
     project_devices.erase( project_devices.begin() + idx );
+    config_version++;
     return 0;
     }
 #endif
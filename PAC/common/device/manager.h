@@ -349,6 +349,10 @@ class device_manager : public i_Lua_save_device
         ///@brief Получение количества всех устройств.
         size_t get_device_count() const;
 
+        /// @brief Номер версии состава устройств - изменяется при
+        /// добавлении и удалении устройств.
+        u_int get_config_version() const;
+
         /// @brief Отладочная печать объекта в консоль.
         void print() const;
 
@@ -393,6 +397,7 @@ class device_manager : public i_Lua_save_device
         int get_device_n( const char* dev_name );
 
         std::vector< device* > project_devices; ///< Все устройства.
+        u_int config_version = 0;
 
         /// @brief Единственный экземпляр класса.
         static auto_smart_ptr < device_manager > instance;
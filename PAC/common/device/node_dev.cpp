@@ -418,20 +418,65 @@ int node_dev::set_cmd( const char* prop, u_int idx, double val )
         return 0;
         }
 
+    else if ( strcmp( prop, "STAT_RESET" ) == 0 )
+        {
+        if ( !node )
+            {
+            G_LOG->warning( "Node '%s' is not initialized.", get_name() );
+            return 1;
+            }
+
+        node->reset_stat();
+        return 0;
+        }
+
     return device::set_cmd( prop, idx, val );
     }
 //-----------------------------------------------------------------------------
 int node_dev::save_device( char* buff ) const
     {
+    // Статистика обмена с узлом, мкс.
+    static const time_histogram EMPTY_HIST;
+    const auto& recv = node ? node->recv_hist : EMPTY_HIST;
+    const auto& send = node ? node->send_hist : EMPTY_HIST;
+    const auto& connect = node ? node->connect_hist : EMPTY_HIST;
+
     // LCOV_EXCL_START
     auto res_n = fmt::format_to_n( buff, MAX_COPY_SIZE,
-        "{}={{ST={}, WEB={}, STARTUP={}, IP='{}'}},\n",
-        get_name(), get_state(), web_value, startup_value, get_ip() );
+        "{}={{ST={}, WEB={}, STARTUP={}, IP='{}', "
+        "RECV_P50={}, RECV_P95={}, RECV_P99={}, RECV_MAX={}, "
+        "SEND_P99={}, SEND_MAX={}, CONNECT_P99={}, CONNECT_MAX={}}},\n",
+        get_name(), get_state(), web_value, startup_value, get_ip(),
+        recv.get_percentile( 50 ), recv.get_percentile( 95 ),
+        recv.get_percentile( 99 ), recv.get_max(),
+        send.get_percentile( 99 ), send.get_max(),
+        connect.get_percentile( 99 ), connect.get_max() );
     // LCOV_EXCL_STOP
 
     return static_cast<int>( res_n.size );
     }
 //-----------------------------------------------------------------------------
+void node_dev::save_device_binary( binary_state_writer& writer ) const
+    {
+    // Те же поля, что и в save_device() (IP-адрес - строка, не передается).
+    static const time_histogram EMPTY_HIST;
+    const auto& recv = node ? node->recv_hist : EMPTY_HIST;
+    const auto& send = node ? node->send_hist : EMPTY_HIST;
+    const auto& connect = node ? node->connect_hist : EMPTY_HIST;
+
+    writer.write_int( "ST", get_state() );
+    writer.write_int( "WEB", web_value );
+    writer.write_int( "STARTUP", startup_value );
+    writer.write_uint( "RECV_P50", recv.get_percentile( 50 ) );
+    writer.write_uint( "RECV_P95", recv.get_percentile( 95 ) );
+    writer.write_uint( "RECV_P99", recv.get_percentile( 99 ) );
+    writer.write_uint( "RECV_MAX", recv.get_max() );
+    writer.write_uint( "SEND_P99", send.get_percentile( 99 ) );
+    writer.write_uint( "SEND_MAX", send.get_max() );
+    writer.write_uint( "CONNECT_P99", connect.get_percentile( 99 ) );
+    writer.write_uint( "CONNECT_MAX", connect.get_max() );
+    }
+//-----------------------------------------------------------------------------
 const char* node_dev::get_name_in_Lua() const
     {
     return "node_dev";
@@ -31,6 +31,8 @@ class node_dev : public device
 
         int save_device( char* buff ) const override;
 
+        void save_device_binary( binary_state_writer& writer ) const override;
+
         int set_cmd( const char* prop, u_int idx, double val ) override;
 
 		const char* get_name_in_Lua() const override;
@@ -93,6 +93,18 @@ int valve::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void valve::save_device_ex_binary( binary_state_writer& writer ) const
+    {
+    if ( is_on_fb )
+        {
+        writer.write_int( "FB_ON_ST", get_on_fb_value() );
+        }
+    if ( is_off_fb )
+        {
+        writer.write_int( "FB_OFF_ST", get_off_fb_value() );
+        }
+    }
+//-----------------------------------------------------------------------------
 int valve::get_state() const
     {
     if ( G_PAC_INFO()->is_emulator() ) return digital_io_device::get_state();
@@ -1326,6 +1338,17 @@ int valve_iolink_mix_proof::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void valve_iolink_mix_proof::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    valve::save_device_ex_binary( writer );
+
+    writer.write_bool( "BLINK", blink );
+    writer.write_bool( "CS", out_info->sv1 || out_info->sv2 || out_info->sv3 );
+    writer.write_int( "ERR", in_info.err );
+    writer.write_float( "V", get_value() );
+    }
+//-----------------------------------------------------------------------------
 bool valve_iolink_mix_proof::get_fb_state() const
     {
     if ( G_PAC_INFO()->is_emulator() ) return valve::get_fb_state();
@@ -1629,6 +1652,15 @@ int valve_iolink_shut_off_sorio::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void valve_iolink_shut_off_sorio::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_bool( "BLINK", blink );
+    writer.write_bool( "CS", out_info->sv1 );
+    writer.write_int( "ERR", in_info.status );
+    writer.write_float( "V", get_value() );
+    }
+//-----------------------------------------------------------------------------
 float valve_iolink_shut_off_sorio::get_value() const
     {
     return 0.1f * in_info.pos;
@@ -1772,6 +1804,18 @@ int valve_iolink_gea_tvis_a15::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void valve_iolink_gea_tvis_a15::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    valve::save_device_ex_binary( writer );
+
+    writer.write_int( "CS",
+        in_info.pv_y1_on || in_info.pv_y2_on || in_info.pv_y3_on );
+    writer.write_int( "SUP", in_info.SUP );
+    writer.write_int( "ERR", in_info.error_on );
+    writer.write_float( "V", get_value() );
+    }
+//-----------------------------------------------------------------------------
 void valve_iolink_gea_tvis_a15::evaluate_io()
     {
     auto data = get_AO_write_data( static_cast<u_int>( CONSTANTS::C_AI_INDEX ) );
@@ -2117,6 +2161,15 @@ int valve_iolink_shut_off_thinktop::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void valve_iolink_shut_off_thinktop::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_bool( "BLINK", blink );
+    writer.write_bool( "CS", out_info->sv1 );
+    writer.write_int( "ERR", in_info.err );
+    writer.write_float( "V", get_value() );
+    }
+//-----------------------------------------------------------------------------
 bool valve_iolink_shut_off_thinktop::get_fb_state() const
     {
     if ( G_PAC_INFO()->is_emulator() ) return valve::get_fb_state();
@@ -2751,6 +2804,15 @@ int analog_valve_iolink::save_device_ex( char* buff ) const
     return res;
     }
 //-----------------------------------------------------------------------------
+void analog_valve_iolink::save_device_ex_binary(
+    binary_state_writer& writer ) const
+    {
+    writer.write_uint( "NAMUR_ST", in_info.namur_state );
+    writer.write_bool( "OPENED", in_info.opened );
+    writer.write_bool( "CLOSED", in_info.closed );
+    writer.write_bool( "BLINK", blink );
+    }
+//-----------------------------------------------------------------------------
 void analog_valve_iolink::direct_on()
     {
     if ( G_PAC_INFO()->is_emulator() ) return AO1::direct_on();
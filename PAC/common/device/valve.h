@@ -59,6 +59,7 @@ class valve : public digital_io_device
 
         /// @brief Сохранение дополнительных данных.
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         //Состояния клапана (расширенное).
         enum VALVE_STATE_EX
@@ -716,6 +717,7 @@ class valve_iolink_mix_proof : public i_mix_proof, public valve
         VALVE_STATE get_valve_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         void evaluate_io() override;
 
@@ -772,6 +774,7 @@ class valve_iolink_shut_off_thinktop : public valve
         VALVE_STATE get_valve_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         void evaluate_io() override;
 
@@ -828,6 +831,7 @@ class valve_iolink_shut_off_sorio : public valve
         VALVE_STATE get_valve_state() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         void evaluate_io() override;
 
@@ -888,6 +892,7 @@ class valve_iolink_gea_tvis_a15 : public valve
             device::DEVICE_SUB_TYPE device_sub_type );
 
         int save_device_ex( char* buff ) const final;
+        void save_device_ex_binary( binary_state_writer& writer ) const final;
         void evaluate_io() final;
         float get_value() const final;
 
@@ -1190,6 +1195,7 @@ class analog_valve_iolink : public AO1
         float get_max_value() const override;
 
         int save_device_ex( char* buff ) const override;
+        void save_device_ex_binary( binary_state_writer& writer ) const override;
 
         enum class CONSTANTS
             {
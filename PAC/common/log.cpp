@@ -12,6 +12,11 @@ auto_smart_ptr < log_mngr > log_mngr::instance;
 //-----------------------------------------------------------------------------
 i_log* log_mngr::get_log()
     {
+    if ( thread_lg )
+        {
+        return thread_lg;
+        }
+
     if ( instance.is_null() )
         {
         instance = new log_mngr();
@@ -20,15 +25,35 @@ i_log* log_mngr::get_log()
     return instance->lg;
     }
 //-----------------------------------------------------------------------------
-log_mngr::log_mngr(): lg( nullptr )
+log_mngr::log_mngr(): lg( create_log() )
+    {
+    }
+//-----------------------------------------------------------------------------
+i_log* log_mngr::create_log()
     {
 #if defined WIN_OS
-    lg = new w_log();
+    return new w_log();
 #elif defined LINUX_OS
-    lg = new l_log();
+    return new l_log();
+#else
+    return nullptr;
 #endif
     }
 //-----------------------------------------------------------------------------
+void log_mngr::init_thread_log()
+    {
+    if ( !thread_lg )
+        {
+        thread_lg = create_log();
+        }
+    }
+//-----------------------------------------------------------------------------
+void log_mngr::free_thread_log()
+    {
+    delete thread_lg;
+    thread_lg = nullptr;
+    }
+//-----------------------------------------------------------------------------
 log_mngr::~log_mngr()
     {
     delete lg;
@@ -77,6 +77,15 @@ class log_mngr
     public:
         static i_log* get_log();
 
+        /// @brief Создание журнала для текущего (дополнительного) потока.
+        ///
+        /// Буфер сообщения @ref i_log::msg принадлежит журналу, поэтому
+        /// каждый дополнительный поток должен использовать свой журнал.
+        static void init_thread_log();
+
+        /// @brief Удаление журнала текущего потока.
+        static void free_thread_log();
+
         ~log_mngr();
 
     protected:
@@ -86,7 +95,12 @@ class log_mngr
     private:
         log_mngr();
 
+        static i_log* create_log();
+
         i_log* lg;
+
+        /// Журнал текущего потока (для основного потока не задан).
+        inline static thread_local i_log* thread_lg = nullptr;
     };
 //-----------------------------------------------------------------------------
 #define G_LOG log_mngr::get_log()
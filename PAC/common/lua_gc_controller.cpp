@@ -0,0 +1,123 @@
+#include <algorithm>
+
+#include "PAC_info.h"
+
+#include "lua_gc_controller.h"
+
+auto_smart_ptr < lua_gc_controller > lua_gc_controller::instance;
+//-----------------------------------------------------------------------------
+lua_gc_controller* lua_gc_controller::get_instance()
+    {
+    if ( instance.is_null() )
+        {
+        instance = new lua_gc_controller();
+        }
+
+    return instance;
+    }
+//-----------------------------------------------------------------------------
+void lua_gc_controller::step( lua_State* L, uint32_t slack_us )
+    {
+    auto start_time = get_microsec();
+    auto& par = G_PAC_INFO()->par;
+
+    if ( !par[ PAC_info::P_LUA_GC_ADAPTIVE ] )
+        {
+        last_step = C_DEFAULT_STEP_KB;
+        lua_gc( L, LUA_GCSTEP, last_step );
+        }
+    else
+        {
+        uint64_t full_threshold = par[ PAC_info::P_LUA_GC_FULL_THRESHOLD ];
+        full_threshold *= 1024;
+        // Порог отсчитывается от живого объема кучи после последней полной
+        // сборки, иначе при большом живом объеме полная сборка выполнялась
+        // бы каждый цикл.
+        if ( full_threshold &&
+            read_heap_size( L ) > full_threshold + heap_after_full )
+            {
+            // Инкрементальная сборка не успевает - полная сборка мусора.
+            last_step = 0;
+            full_collections_count++;
+            lua_gc( L, LUA_GCCOLLECT, 0 );
+            heap_after_full = read_heap_size( L );
+            }
+        else
+            {
+            auto heap_before_step = read_heap_size( L );
+            auto alloc_size = heap_before_step > heap_after_step ?
+                heap_before_step - heap_after_step : 0;
+            last_step = get_adaptive_step( alloc_size / 1024, slack_us );
+
+            lua_gc( L, LUA_GCSTEP, last_step );
+
+            // Стоимость шага - скользящее среднее.
+            auto cost = static_cast<double>( get_microsec() - start_time ) /
+                last_step;
+            step_cost = step_cost > 0 ? 0.9 * step_cost + 0.1 * cost : cost;
+            }
+        }
+
+    heap_after_step = heap_size = read_heap_size( L );
+    gc_time_hist.add( static_cast<uint32_t>( get_microsec() - start_time ) );
+    }
+//-----------------------------------------------------------------------------
+u_int lua_gc_controller::get_adaptive_step( uint32_t alloc_size_kb,
+    uint32_t slack_us ) const
+    {
+    auto step_size = std::clamp<uint64_t>(
+        static_cast<uint64_t>( C_ALLOC_GAIN ) * alloc_size_kb,
+        C_MIN_STEP_KB, C_MAX_STEP_KB );
+
+    if ( slack_us != NO_SLACK_LIMIT && step_cost > 0 )
+        {
+        // Шаг не должен занимать больше заданной доли свободного времени.
+        auto max_step = static_cast<uint64_t>( static_cast<double>( slack_us ) *
+            C_SLACK_SHARE_PERCENT / 100 / step_cost );
+        step_size = std::max<uint64_t>( C_MIN_STEP_KB,
+            std::min( step_size, max_step ) );
+        }
+
+    return static_cast<u_int>( step_size );
+    }
+//-----------------------------------------------------------------------------
+void lua_gc_controller::reset()
+    {
+    heap_size = 0;
+    heap_after_full = 0;
+    last_step = 0;
+    gc_time_hist.clear();
+    full_collections_count = 0;
+    }
+//-----------------------------------------------------------------------------
+uint32_t lua_gc_controller::get_heap_size() const
+    {
+    return heap_size;
+    }
+//-----------------------------------------------------------------------------
+u_int lua_gc_controller::get_last_step() const
+    {
+    return last_step;
+    }
+//-----------------------------------------------------------------------------
+const time_histogram& lua_gc_controller::get_gc_time_hist() const
+    {
+    return gc_time_hist;
+    }
+//-----------------------------------------------------------------------------
+u_int lua_gc_controller::get_full_collections_count() const
+    {
+    return full_collections_count;
+    }
+//-----------------------------------------------------------------------------
+uint32_t lua_gc_controller::read_heap_size( lua_State* L )
+    {
+    return static_cast<uint32_t>( lua_gc( L, LUA_GCCOUNT, 0 ) ) * 1024 +
+        static_cast<uint32_t>( lua_gc( L, LUA_GCCOUNTB, 0 ) );
+    }
+//-----------------------------------------------------------------------------
+lua_gc_controller* G_LUA_GC_CONTROLLER()
+    {
+    return lua_gc_controller::get_instance();
+    }
+//-----------------------------------------------------------------------------
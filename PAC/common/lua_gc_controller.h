@@ -0,0 +1,85 @@
+/// @file lua_gc_controller.h
+/// @brief Адаптивное управление инкрементальным сборщиком мусора Lua.
+
+#pragma once
+
+#include "lua.h"
+
+#include "smart_ptr.h"
+#include "dtime.h"
+
+//-----------------------------------------------------------------------------
+/// @brief Управление шагом сборщика мусора Lua в основном цикле.
+///
+/// Вместо фиксированного шага (@ref C_DEFAULT_STEP_KB) размер шага
+/// определяется скоростью выделения памяти (прирост кучи Lua с предыдущего
+/// шага) и ограничивается свободным временем цикла (исходя из измеренной
+/// стоимости 1 Кб шага). Если куча превысила порог (сверх живого объема
+/// после предыдущей полной сборки), выполняется полная сборка мусора. Учитывается размер кучи и время сборки мусора за цикл.
+///
+/// Адаптивный режим включается параметром PAC_info::P_LUA_GC_ADAPTIVE,
+/// порог полной сборки - PAC_info::P_LUA_GC_FULL_THRESHOLD.
+class lua_gc_controller
+    {
+    public:
+        enum CONSTANTS
+            {
+            C_DEFAULT_STEP_KB = 200,    ///< Шаг без адаптивного режима.
+            C_MIN_STEP_KB = 10,         ///< Минимальный шаг.
+            C_MAX_STEP_KB = 2000,       ///< Максимальный шаг.
+            C_ALLOC_GAIN = 2,           ///< Отношение шага к приросту кучи.
+            C_SLACK_SHARE_PERCENT = 50, ///< Доля свободного времени цикла.
+            };
+
+        static const uint32_t NO_SLACK_LIMIT = UINT32_MAX;
+
+        static lua_gc_controller* get_instance();
+
+        /// @brief Шаг сборщика мусора.
+        ///
+        /// @param L        - состояние Lua.
+        /// @param slack_us - свободное время цикла, мкс (NO_SLACK_LIMIT -
+        /// без ограничения).
+        void step( lua_State* L, uint32_t slack_us = NO_SLACK_LIMIT );
+
+        /// @brief Сброс статистики.
+        void reset();
+
+        /// @brief Размер кучи Lua после последнего шага, байт.
+        uint32_t get_heap_size() const;
+
+        /// @brief Размер последнего шага, Кб (0 - полная сборка).
+        u_int get_last_step() const;
+
+        /// @brief Время сборки мусора за цикл, мкс.
+        const time_histogram& get_gc_time_hist() const;
+
+        /// @brief Количество полных сборок мусора (превышение порога).
+        u_int get_full_collections_count() const;
+
+        /// @brief Размер кучи Lua, байт.
+        static uint32_t read_heap_size( lua_State* L );
+
+    private:
+        lua_gc_controller() = default;
+
+        /// @brief Размер адаптивного шага, Кб.
+        ///
+        /// @param alloc_size_kb - прирост кучи с предыдущего шага, Кб.
+        /// @param slack_us      - свободное время цикла, мкс.
+        u_int get_adaptive_step( uint32_t alloc_size_kb,
+            uint32_t slack_us ) const;
+
+        uint32_t heap_size{};
+        uint32_t heap_after_step{};     ///< Размер кучи после шага, байт.
+        uint32_t heap_after_full{};     ///< Размер кучи после полной сборки.
+        double step_cost{};             ///< Стоимость 1 Кб шага, мкс.
+        u_int last_step{};
+
+        time_histogram gc_time_hist;
+        u_int full_collections_count{};
+
+        static auto_smart_ptr < lua_gc_controller > instance;
+    };
+//-----------------------------------------------------------------------------
+lua_gc_controller* G_LUA_GC_CONTROLLER();
@@ -11,6 +11,9 @@ char ModbusServ::updatePrgFlag[11] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
 
 extern int isMsa;
 
+std::unordered_map< uint32_t, device* > ModbusServ::devices_map;
+std::vector< uintptr_t > ModbusServ::devices_map_key;
+
 unsigned char ModbusServ::UTable[128][2] =
 	{
 		{0x4,0x2},
@@ -147,6 +150,11 @@ long ModbusServ::ModbusService( long len, unsigned char *data,unsigned char *out
 	{
 	lua_State* L = lua_manager::get_instance()->get_Lua();
 
+	if ( isMsa )
+		{
+		update_devices_map();
+		}
+
 	switch ( data[1] ) //Modbus command
 		{
 
@@ -687,6 +695,8 @@ long ModbusServ::ModbusService( long len, unsigned char *data,unsigned char *out
 
 		case 0x05: //Write Single Coil
 			{
+			// Запись изменяет состояние - сохраненные ответы устарели.
+			device_communicator::clear_answers_cache();
 			unsigned int startingAddress = data[ 2 ] * 256 + data[ 3 ];
 			unsigned int coilgroup       = data[ 0 ];
 			int value                    = data[ 4 ] > 0 ? 1 : 0;
@@ -801,6 +811,8 @@ long ModbusServ::ModbusService( long len, unsigned char *data,unsigned char *out
 
 		case 0x10: //Force Multiply Registers
 			{
+			// Запись изменяет состояние - сохраненные ответы устарели.
+			device_communicator::clear_answers_cache();
 			unsigned int startingAddress  = data[2] * 256 + data[3];
 			unsigned int numberofElements = data[4] * 256 + data[5];
 			unsigned int coilgroup        = data[ 0 ];
@@ -1319,22 +1331,24 @@ device* ModbusServ::get_device( unsigned int group, unsigned int number )
 	unsigned int line;
 	device* ret = G_DEVICE_MANAGER()->get_stub_device();
 	line = number / 100;
-	char devname[20] = {0};
 	switch (group)
 		{
 		case C_V:
-			if (line > 0 && line <= (unsigned int)cipline_tech_object::MdlsCNT && number % 100 < 14)
-			{
-			if (cipline_tech_object::Mdls[line - 1]->is_old_definition)
-				{
-				sprintf(devname, "LINE%dV%d", line, number);
-				}
-			else
+		case C_PUMPS:
+		case C_LINE1VALVES:
+		case C_LINE2VALVES:
+		case C_LINE3VALVES:
+		case C_LINE4VALVES:
+		case C_LINE5VALVES:
+		case C_LINE6VALVES:
+		case C_LINE7VALVES:
+		case C_LINE8VALVES:
+		case C_LINE9VALVES:
+			if ( auto it = devices_map.find( get_devices_map_key( group, number ) );
+				it != devices_map.end() )
 				{
-				sprintf(devname, "LINE%dV%d", line, number % 100);
+				ret = it->second;
 				}
-			ret = (device*)V(devname);
-			}
 			break;
 		case C_M:
 		case C_N:
@@ -1463,31 +1477,70 @@ device* ModbusServ::get_device( unsigned int group, unsigned int number )
 					}
 				}
 			break;
-		case C_PUMPS:
-			line = number / 1000;
-			if (line > 0 && line <= (unsigned int)cipline_tech_object::MdlsCNT && (number % 1000 == 1))
-				{
-				sprintf(devname, "LINE%dM%d", line, number % 1000 + 1000);
-				ret = (device*)M(devname);
-				}
-			break;
-		case C_LINE1VALVES:
-		case C_LINE2VALVES:
-		case C_LINE3VALVES:
-		case C_LINE4VALVES:
-		case C_LINE5VALVES:
-		case C_LINE6VALVES:
-		case C_LINE7VALVES:
-		case C_LINE8VALVES:
-		case C_LINE9VALVES:
-			line = group - C_LINE1VALVES + 1;
-			if (line > 0 && line <= (unsigned int)cipline_tech_object::MdlsCNT && (number == 1001 || number == 1002 || 1004 == number || 1006 == number ||
-				(number / 1000 == 1 && (number - 1000) % 10 <= 2 && (number - 1000) / 10 <= 4 )))
+		}
+		return ret;
+	}
+
+void ModbusServ::update_devices_map()
+	{
+	// Карта перестраивается при изменении состава устройств, количества
+	// линий или способа именования их клапанов.
+	std::vector< uintptr_t > key;
+	key.reserve( 2 + 2 * cipline_tech_object::MdlsCNT );
+	key.push_back( G_DEVICE_MANAGER()->get_config_version() );
+	key.push_back( cipline_tech_object::MdlsCNT );
+	for ( int i = 0; i < cipline_tech_object::MdlsCNT && i < 10; i++ )
+		{
+		auto mdl = cipline_tech_object::Mdls[ i ];
+		key.push_back( reinterpret_cast<uintptr_t>( mdl ) );
+		key.push_back( mdl ? mdl->is_old_definition : 0 );
+		}
+	if ( key == devices_map_key )
+		{
+		return;
+		}
+	devices_map_key.swap( key );
+	devices_map.clear();
+
+	// Регистры, не найденные в карте, соответствуют заглушке (как и
+	// отсутствующие устройства) - сообщения об ошибках не выводятся.
+	G_DEVICE_MANAGER()->disable_error_logging = true;
+	char devname[20] = {0};
+	for ( int line = 1; line <= cipline_tech_object::MdlsCNT && line <= 10; line++ )
+		{
+		auto mdl = cipline_tech_object::Mdls[ line - 1 ];
+		if ( !mdl )
+			{
+			continue;
+			}
+
+		for ( int n = 0; n < 14; n++ )
+			{
+			int number = line * 100 + n;
+			sprintf( devname, "LINE%dV%d", line,
+				mdl->is_old_definition ? number : n );
+			devices_map[ get_devices_map_key( C_V, number ) ] =
+				(device*)V( devname );
+			}
+
+		sprintf( devname, "LINE%dM%d", line, 1001 );
+		devices_map[ get_devices_map_key( C_PUMPS, line * 1000 + 1 ) ] =
+			(device*)M( devname );
+
+		if ( line > C_LINE9VALVES - C_LINE1VALVES + 1 )
+			{
+			continue;
+			}
+		unsigned int group = C_LINE1VALVES + line - 1;
+		for ( int number = 1000; number < 1050; number++ )
+			{
+			if ( ( number - 1000 ) % 10 <= 2 || 1004 == number || 1006 == number )
 				{
-				sprintf(devname, "LINE%dV%d", line, number);
-				ret = (device*)V(devname);
+				sprintf( devname, "LINE%dV%d", line, number );
+				devices_map[ get_devices_map_key( group, number ) ] =
+					(device*)V( devname );
 				}
-			break;
+			}
 		}
-		return ret;
+	G_DEVICE_MANAGER()->disable_error_logging = false;
 	}
@@ -6,6 +6,9 @@
 #include "g_device.h"
 #include "dtime.h"
 
+#include <unordered_map>
+#include <vector>
+
 #define MAX_UPDATE_CONFIRMS 10
 
 enum CoilGroups
@@ -152,7 +155,30 @@ class ModbusServ
             return UnpackWord( Buf + offset );
             }
 
+		/// @brief Устройство регистра.
+		///
+		/// Устройства, определяемые по имени (клапаны и насосы линий),
+		/// берутся из карты регистров (@ref update_devices_map).
 		static device* get_device(unsigned int group, unsigned int number);
+
+		/// @brief Построение карты регистров при изменении конфигурации
+		/// линий мойки или состава устройств. Вызывается при обработке
+		/// запроса.
+		static void update_devices_map();
+
+	private:
+		/// @brief Карта регистров: (группа, номер) - устройство. Без поиска
+		/// устройства по имени для каждого регистра запроса.
+		static std::unordered_map< uint32_t, device* > devices_map;
+
+		/// @brief Конфигурация, для которой построена карта регистров.
+		static std::vector< uintptr_t > devices_map_key;
+
+		static uint32_t get_devices_map_key( unsigned int group,
+			unsigned int number )
+			{
+			return ( group << 24 ) | ( number & 0xFFFFFF );
+			}
 	};
 
 #endif // modbus_serv_h__
@@ -101,7 +101,8 @@ int ParamsRecipeManager::parseDriverCmd( const char *buff )
 
     std::string cmd = buff;
     G_LOG->debug(cmd.c_str());
-    std::regex rmCommand( R"lit(__RECMAN\[(\d+)\]:set_cmd\( "(\w+)", (\d+), ((?:"(.*)")|([\d\.]+)) \))lit" );
+    // Выражение компилируется один раз.
+    static const std::regex rmCommand( R"lit(__RECMAN\[(\d+)\]:set_cmd\( "(\w+)", (\d+), ((?:"(.*)")|([\d\.]+)) \))lit" );
     if ( std::smatch rmMatch; std::regex_match( cmd, rmMatch, rmCommand ))
         {
         auto recMgrIdx = std::stoi( rmMatch[ 1 ].str( ));
@@ -73,6 +73,10 @@ int project_manager::proc_main_params( int argc, const char* argv[] )
             cxxopts::value<std::string>()->default_value( "./dairy-sys" ) )
         ( "sleep_time", "Sleep time, ms",
             cxxopts::value<unsigned int>()->default_value( "2" ) )
+        ( "cpu_core", "Main thread CPU core",
+            cxxopts::value<int>()->default_value( "-1" ) )
+        ( "rt_priority", "Main thread RT priority",
+            cxxopts::value<int>()->default_value( "0" ) )
 
         ( "script", "The script file to execute",
             cxxopts::value<std::string>()  );
@@ -154,6 +158,8 @@ int project_manager::proc_main_params( int argc, const char* argv[] )
         }
 
     sleep_time_ms = result[ "sleep_time" ].as<unsigned int>();
+    cpu_core = result[ "cpu_core" ].as<int>();
+    rt_priority = result[ "rt_priority" ].as<int>();
 
     // Нормализуем пути и гарантируем слеш на конце через /= "".
     auto p_norm = std::filesystem::path(
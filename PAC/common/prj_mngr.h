@@ -68,6 +68,8 @@ class project_manager
         std::string extra_paths = "";//Дополнительный путь к user-скриптам Lua.
 
         unsigned int sleep_time_ms = 0;
+        int cpu_core = -1;      //Ядро процессора основного потока (-1 - любое).
+        int rt_priority = 0;    //Приоритет реального времени основного потока.
 
     protected:
         void log_opc_mode() const;
@@ -1,5 +1,6 @@
 #include "dtime.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 
@@ -66,3 +67,97 @@ uint32_t get_delta_millisec( uint32_t time1 )
     // modular arithmetic.
     return now - time1;
     }
+//-----------------------------------------------------------------------------
+uint64_t get_microsec()
+    {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        get_duration() ).count();
+
+    return static_cast<uint64_t>( us );
+    }
+//-----------------------------------------------------------------------------
+u_int time_histogram::get_bucket( uint32_t value )
+    {
+    if ( value < C_SUB_BUCKETS_CNT )
+        {
+        return value;
+        }
+
+    // Номер старшего бита (2..31) и два следующих за ним бита.
+    u_int msb = 31;
+    while ( !( value & ( 1u << msb ) ) ) msb--;
+    u_int sub = ( value >> ( msb - 2 ) ) & ( C_SUB_BUCKETS_CNT - 1 );
+
+    return ( msb - 1 ) * C_SUB_BUCKETS_CNT + sub;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_bucket_max( u_int bucket )
+    {
+    if ( bucket < C_SUB_BUCKETS_CNT )
+        {
+        return bucket;
+        }
+
+    u_int msb = bucket / C_SUB_BUCKETS_CNT + 1;
+    u_int sub = bucket % C_SUB_BUCKETS_CNT;
+    uint64_t lower = uint64_t( C_SUB_BUCKETS_CNT + sub ) << ( msb - 2 );
+
+    return static_cast<uint32_t>( lower + ( uint64_t( 1 ) << ( msb - 2 ) ) - 1 );
+    }
+//-----------------------------------------------------------------------------
+void time_histogram::add( uint32_t value )
+    {
+    buckets[ get_bucket( value ) ]++;
+    if ( 0 == count || value < min ) min = value;
+    if ( value > max ) max = value;
+    sum += value;
+    count++;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_percentile( u_int percent ) const
+    {
+    if ( 0 == count )
+        {
+        return 0;
+        }
+
+    // Количество значений, не превышающих процентиль (не меньше 1).
+    auto rank = std::max<uint64_t>( 1,
+        ( uint64_t( count ) * std::min( percent, 100u ) + 99 ) / 100 );
+    uint64_t cnt = 0;
+    for ( u_int i = 0; i < C_BUCKETS_CNT; i++ )
+        {
+        cnt += buckets[ i ];
+        if ( cnt >= rank )
+            {
+            return std::max( min, std::min( max, get_bucket_max( i ) ) );
+            }
+        }
+
+    return max;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_count() const
+    {
+    return count;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_min() const
+    {
+    return min;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_max() const
+    {
+    return max;
+    }
+//-----------------------------------------------------------------------------
+uint32_t time_histogram::get_avg() const
+    {
+    return count ? static_cast<uint32_t>( sum / count ) : 0;
+    }
+//-----------------------------------------------------------------------------
+void time_histogram::clear()
+    {
+    *this = time_histogram();
+    }
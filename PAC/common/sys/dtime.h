@@ -50,6 +50,11 @@ uint32_t get_millisec();
 /// @return Разность времени в миллисекундах.
 uint32_t get_delta_millisec( uint32_t time1 );
 //-----------------------------------------------------------------------------
+/// @brief Получение времени в микросекундах (для измерения длительности).
+///
+/// @return Время с момента запуска steady_clock (зависит от реализации).
+uint64_t get_microsec();
+//-----------------------------------------------------------------------------
 /// @brief Ожидание заданное время.
 ///
 /// @param ms - время ожидания, мс.
@@ -92,6 +97,59 @@ struct stat_time
         }
     };
 
+//-----------------------------------------------------------------------------
+/// @brief Гистограмма времени (логарифмическая шкала).
+///
+/// Интервал [2^n, 2^(n+1)) делится на 4 равных отрезка, поэтому
+/// погрешность процентилей не превышает 25% при постоянном размере
+/// (около 500 байт) и времени добавления значения. Диапазон значений - весь
+/// uint32_t (в мкс - более 70 мин).
+class time_histogram
+    {
+    public:
+        /// @brief Добавление значения.
+        ///
+        /// @param value - значение (обычно время, мкс).
+        void add( uint32_t value );
+
+        /// @brief Получение процентиля.
+        ///
+        /// @param percent - процентиль (0..100).
+        ///
+        /// @return - верхняя граница интервала, в который попадает
+        /// процентиль (не больше максимального значения), 0 - нет значений.
+        uint32_t get_percentile( u_int percent ) const;
+
+        uint32_t get_count() const;
+
+        uint32_t get_min() const;
+
+        uint32_t get_max() const;
+
+        uint32_t get_avg() const;
+
+        void clear();
+
+        enum CONSTANTS
+            {
+            C_SUB_BUCKETS_CNT = 4,
+            C_BUCKETS_CNT = 124,    ///< 4 линейных + 4 * 30 логарифмических.
+            };
+
+        /// @brief Номер интервала для значения.
+        static u_int get_bucket( uint32_t value );
+
+        /// @brief Верхняя граница интервала.
+        static uint32_t get_bucket_max( u_int bucket );
+
+    private:
+        uint32_t buckets[ C_BUCKETS_CNT ]{};
+        uint32_t count{};
+        uint32_t min{};
+        uint32_t max{};
+        uint64_t sum{};
+    };
+//-----------------------------------------------------------------------------
 #ifdef PTUSA_TEST
 tm get_time_next_hour();
 
@@ -78,6 +78,32 @@ void tcp_communicator::_AknOK()
     in_buffer_count = 5;
     }
 //------------------------------------------------------------------------------
+int tcp_communicator::push( u_int connection_id, u_char srv_id,
+    const u_char* data, u_int size )
+    {
+    return PUSH_NO_CONNECTION;
+    }
+//------------------------------------------------------------------------------
+bool tcp_communicator::is_push_busy( u_int connection_id ) const
+    {
+    return false;
+    }
+//------------------------------------------------------------------------------
+u_int tcp_communicator::get_slow_clients_count() const
+    {
+    return 0;
+    }
+//------------------------------------------------------------------------------
+size_t tcp_communicator::get_max_out_queue_size() const
+    {
+    return 0;
+    }
+//------------------------------------------------------------------------------
+u_int tcp_communicator::get_service_connection_id() const
+    {
+    return service_connection_id;
+    }
+//------------------------------------------------------------------------------
 tcp_communicator* tcp_communicator::get_instance()
     {
     return instance;
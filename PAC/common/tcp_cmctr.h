@@ -75,6 +75,51 @@ class tcp_communicator
         /// @return - сетевое имя PAC на английском языке.
         char* get_host_name_eng();
 
+        /// @brief Результат передачи данных по инициативе PAC.
+        enum PUSH_RESULT
+            {
+            PUSH_NO_CONNECTION = -1, ///< Соединение закрыто (не поддерживается).
+            PUSH_OK = 0,             ///< Данные поставлены в очередь.
+            PUSH_BUSY,               ///< Предыдущие данные еще не переданы.
+            };
+
+        /// @brief Передача данных клиенту по инициативе PAC (без запроса).
+        ///
+        /// Данные передаются кадром PUSH_DATA: net_id, PUSH_DATA, номер
+        /// сервиса, размер данных (4 байта, старший байт первый), данные.
+        /// Передача выполняется при обработке сокетов; пока предыдущие
+        /// данные соединения не переданы, новые не принимаются.
+        ///
+        /// @param connection_id - идентификатор соединения
+        /// (@ref get_service_connection_id).
+        /// @param srv_id        - номер сервиса.
+        /// @param data          - данные.
+        /// @param size          - размер данных.
+        ///
+        /// @return - @ref PUSH_RESULT.
+        virtual int push( u_int connection_id, u_char srv_id,
+            const u_char* data, u_int size );
+
+        /// @brief Предыдущие данные соединения, переданные по инициативе PAC
+        /// (@ref push), еще не переданы (@ref PUSH_BUSY).
+        ///
+        /// @param connection_id - идентификатор соединения.
+        virtual bool is_push_busy( u_int connection_id ) const;
+
+        /// @brief Количество соединений, закрытых из-за переполнения
+        /// очереди передачи или отсутствия передачи (медленные клиенты).
+        virtual u_int get_slow_clients_count() const;
+
+        /// @brief Максимальный размер очереди передачи соединения, байт.
+        virtual size_t get_max_out_queue_size() const;
+
+        /// @brief Идентификатор соединения, запрос которого выполняется
+        /// сервисом.
+        ///
+        /// @return - идентификатор соединения (0 - вне сервиса или
+        /// передача по инициативе PAC не поддерживается).
+        u_int get_service_connection_id() const;
+
         virtual int add_async_client(tcp_client* client);
         virtual int remove_async_client(tcp_client* client);
 
@@ -130,8 +175,12 @@ class tcp_communicator
             AKN_ERR      = 7,
             AKN_DATA     = 8,
             AKN_OK       = 12,
+            PUSH_DATA    = 14, ///< Данные по инициативе PAC.
             };
 
+        /// Идентификатор соединения, запрос которого выполняется сервисом.
+        u_int service_connection_id = 0;
+
         static auto_smart_ptr < tcp_communicator > instance;///< Экземпляр класса.
 
         srv_ptr services[ TC_MAX_SERVICE_NUMBER ];  ///< Массив сервисов.
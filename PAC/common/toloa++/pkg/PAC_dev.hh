@@ -1569,7 +1569,13 @@ class io_manager
         io_manager::io_node* add_node( unsigned int index, int ntype,
             int address, char* IP_address, char *name,
             int DO_cnt, int DI_cnt, int AO_cnt, int AO_size,
-            int AI_cnt, int AI_size );
+            int AI_cnt, int AI_size, unsigned int poll_period = 1 );
+
+        /// @brief Установка периода опроса узла, циклов обмена.
+        ///
+        /// Вызывается из Lua.
+        void set_node_poll_period( unsigned int node_index,
+            unsigned int poll_period );
 
         /// @brief Инициализация параметров канала аналогового вывода.
         ///
@@ -1755,6 +1761,54 @@ class PAC_info: public i_Lua_save_device
 
             ///< Время до установки ошибки связи с сетевым узлом, мсек.
             P_BK_ANSWER_MAX_WAIT_TIME,
+
+            ///< Конвейерный обмен с узлами I/O, 0 - нет, 1 - да.
+            P_IO_PIPELINED_EXCHANGE,
+
+            ///< Обмен с узлами I/O в отдельном потоке, 0 - нет, 1 - да.
+            P_IO_THREAD,
+
+            ///< Период записи неизменившихся выходов узлов I/O, мсек.
+            P_IO_OUTPUTS_REFRESH_TIME,
+
+            ///< Совмещенный обмен с узлами I/O Phoenix, 0 - нет, 1 - да.
+            P_IO_COMBINED_EXCHANGE,
+
+            ///< Период основного цикла, мсек (0 - ожидание sleep_time).
+            P_MAIN_CYCLE_PERIOD,
+
+            ///< Период быстрых задач (I/O, устройства), мсек (0 - каждый цикл).
+            P_FAST_TASKS_PERIOD,
+
+            ///< Период задач управления, мсек (0 - каждый цикл).
+            P_NORMAL_TASKS_PERIOD,
+
+            ///< Период задач обслуживания, мсек (0 - каждый цикл).
+            P_SLOW_TASKS_PERIOD,
+
+            ///< Обмен с сервером в отдельном потоке (Linux), 0 - нет, 1 - да.
+            P_COMM_THREAD,
+
+            ///< Адаптивный шаг сборщика мусора Lua.
+            P_LUA_GC_ADAPTIVE,
+
+            ///< Порог полной сборки мусора Lua, Кб.
+            P_LUA_GC_FULL_THRESHOLD,
+
+            ///< Уровень сжатия ответов (zlib).
+            P_COMPRESSION_LEVEL,
+
+            ///< Стратегия сжатия ответов (zlib).
+            P_COMPRESSION_STRATEGY,
+
+            ///< Сжатие состояния устройств со словарем.
+            P_COMPRESSION_DICTIONARY,
+
+            ///< Максимальный размер очереди передачи соединения сервера, Кб.
+            P_TCP_MAX_OUT_QUEUE,
+
+            ///< Время без передачи данных медленному клиенту, мсек.
+            P_TCP_SLOW_CLIENT_TIMEOUT,
             };
 
         saved_params_u_int_4 par;
@@ -4,6 +4,7 @@
 #include "log.h"
 
 #include "fmt/format.h"
+#include <algorithm>
 #include <cstring>
 
 #ifdef WIN_OS
@@ -14,6 +15,16 @@ extern int errno;
 
 //-----------------------------------------------------------------------------
 int uni_io_manager::net_init( io_node* node ) const
+    {
+    if ( auto res = net_init_start( node ); res != 0 )
+        {
+        return res;
+        }
+
+    return net_init_check( node, true );
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::net_init_start( io_node* node ) const
     {
     if ( node == nullptr )
         {
@@ -62,11 +73,10 @@ int uni_io_manager::net_init( io_node* node ) const
 
     // Адресация мастер-сокета.
     struct sockaddr_in socket_remote_server;
-    const int PORT = 502;
     memset( &socket_remote_server, 0, sizeof( socket_remote_server ) );
     socket_remote_server.sin_family = AF_INET;
     socket_remote_server.sin_addr.s_addr = inet_addr( node->ip_address );
-    socket_remote_server.sin_port = htons( PORT );
+    socket_remote_server.sin_port = htons( static_cast<uint16_t>( port ) );
 
 #ifdef WIN_OS
     unsigned long timeout = io_node::C_CNT_TIMEOUT_US;
@@ -139,18 +149,34 @@ int uni_io_manager::net_init( io_node* node ) const
     std::memcpy( &s_address, &socket_remote_server, sizeof( socket_remote_server ) );
     connect( sock, &s_address, sizeof( socket_remote_server ) );
 
+    node->sock = sock;
+    node->state = io_node::ST_CONNECTING;
+    node->connect_start_time = get_millisec();
+    node->connect_start_time_us = get_microsec();
+
+    return 0;
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::net_init_check( io_node* node, bool is_wait ) const
+    {
+    int sock = node->sock;
+
     fd_set rdevents;
     struct timeval tv;
     FD_ZERO( &rdevents );
     FD_SET( sock, &rdevents );
 
+    // Без ожидания - только проверка завершения подключения.
     tv.tv_sec = 0;
-    tv.tv_usec = io_node::C_CNT_TIMEOUT_US;
+    tv.tv_usec = is_wait ? io_node::C_CNT_TIMEOUT_US : 0;
 
-    static uint32_t st_time;
-    st_time = get_millisec();
+    auto err = select( sock + 1, nullptr, &rdevents, nullptr, &tv );
 
-    err = select( sock + 1, nullptr, &rdevents, nullptr, &tv );
+    if ( 0 == err && !is_wait && get_delta_millisec( node->connect_start_time ) <
+        io_node::C_CNT_TIMEOUT_US / 1000 )
+        {
+        return C_CONNECT_IN_PROGRESS;
+        }
 
     if ( err <= 0 )
         {
@@ -186,6 +212,8 @@ int uni_io_manager::net_init( io_node* node ) const
 #else
         close( sock );
 #endif // WIN_OS
+        node->sock = 0;
+        node->state = io_node::ST_NO_CONNECT;
         return 6;
         }
 
@@ -227,18 +255,20 @@ int uni_io_manager::net_init( io_node* node ) const
 #else
             close( sock );
 #endif // WIN_OS
+            node->sock = 0;
+            node->state = io_node::ST_NO_CONNECT;
             return 7;
             }
         }
 
-    static u_long connect_time = 0;
-    connect_time = get_delta_millisec( st_time );
+    u_long connect_time = get_delta_millisec( node->connect_start_time );
 
     G_LOG->debug( "uni_io_manager:net_init() : socket %d is successfully "
-        R"(connected to "%s":"%s":%d (%lu ms).)",
-        sock, node->name, node->ip_address, PORT, connect_time );
+        R"(connected to "%s":"%s":%u (%lu ms).)",
+        sock, node->name, node->ip_address, port, connect_time );
 
-    node->sock = sock;
+    node->connect_hist.add( static_cast<uint32_t>(
+        get_microsec() - node->connect_start_time_us ) );
     node->state = io_node::ST_OK;
 
     return 0;
@@ -251,320 +281,116 @@ int uni_io_manager::write_outputs()
         return 0;
         }
 
-    int res = 0;
-
-    for ( u_int i = 0; i < nodes_count; i++ )
+    if ( check_io_thread() )
         {
-        io_node* nd = nodes[ i ];
-        if ( nd->type == io_node::WAGO_750_XXX_ETHERNET )
+        std::unique_lock<std::mutex> lock( io_mutex );
+        for ( u_int i = 0; i < nodes_count; i++ )
             {
-            if ( !nd->is_active )
-                {
-                continue;
-                }
-
-            if ( nd->read_io_error_flag )
-                {
-                res = 1;
-                continue;
-                }
-
-            if ( nd->DO_cnt > 0 )
-                {
-                u_int bytes_cnt = nd->DO_cnt / 8 + ( nd->DO_cnt % 8 > 0 ? 1 : 0 );
-
-                buff[ 0 ] = 's';
-                buff[ 1 ] = 's';
-                buff[ 2 ] = 0;
-                buff[ 3 ] = 0;
-                buff[ 4 ] = 0;
-                buff[ 5 ] = static_cast <unsigned char>( 7u + bytes_cnt );
-                buff[ 6 ] = 0; //nodes[ i ]->number;
-                buff[ 7 ] = 0x0F;
-                buff[ 8 ] = 0;
-                buff[ 9 ] = 0;
-                buff[ 10 ] = (unsigned char)nd->DO_cnt >> 7 >> 1;
-                buff[ 11 ] = (unsigned char)nd->DO_cnt & 0xFF;
-                buff[ 12 ] = static_cast <unsigned char>( bytes_cnt );
-
-                for ( u_int j = 0, idx = 0; j < bytes_cnt; j++ )
-                    {
-                    u_char b = 0;
-                    for ( u_int k = 0; k < 8; k++ )
-                        {
-                        if ( idx < nd->DO_cnt )
-                            {
-                            b = b | static_cast <unsigned char>( ( nd->DO_[ idx ] & 1 ) << k );
-                            idx++;
-                            }
-                        }
-                    buff[ j + 13 ] = b;
-                    }
-
-                if ( e_communicate( nd, bytes_cnt + 13, 12 ) == 0 )
-                    {
-                    if ( buff[ 7 ] == 0x0F )
-                        {
-                        memcpy( nd->DO, nd->DO_, nd->DO_cnt );
-                        nd->flag_error_write_message = false;
-                        }
-                    else
-                        {
-                        if ( !nd->flag_error_write_message )
-                            {
-                            // Есть какая-то ошибка на прикладном уровне.
-                            add_err_to_log( "Write DO", nd->name, nd->ip_address,
-                                static_cast<int>( buff[ 7 ] ), 0x0F,
-                                static_cast<int>( buff[ 8 ] ), bytes_cnt );
-                            res = 1;
-                            nd->flag_error_write_message = true;
-                            }
-                        continue;
-                        }
-                    }
-                else
-                    {
-                    // Была какая-то сетевая ошибка.
-                    res = 1;
-                    continue;
-                    }
+            copy_outputs( nodes[ i ], shared_nodes[ i ] );
+            }
+        is_outputs_updated = true;
+        auto res = io_thread_write_res;
+        lock.unlock();
 
-                }// if ( nd->DO_cnt > 0 )
+        io_cv.notify_one();
+        return res;
+        }
 
-            if ( nd->AO_cnt > 0 )
-                {
-                u_int bytes_cnt = nd->AO_size;
+    return exchange_nodes( nodes, nodes_count, false );
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::exchange_nodes( io_node* const* nds, u_int cnt,
+    bool is_read )
+    {
+    for ( u_int i = 0; i < cnt; i++ )
+        {
+        nds[ i ]->check_stat_reset();
+        }
 
-                buff[ 0 ] = 's';
-                buff[ 1 ] = 's';
-                buff[ 2 ] = 0;
-                buff[ 3 ] = 0;
-                buff[ 4 ] = 0;
-                buff[ 5 ] = static_cast <unsigned char>( 7u + bytes_cnt );
-                buff[ 6 ] = 0; //nodes[ i ]->number;
-                buff[ 7 ] = 0x10;
-                buff[ 8 ] = 0;
-                buff[ 9 ] = 0;
-                buff[ 10 ] = static_cast <unsigned char>( bytes_cnt / 2 >> 8 );
-                buff[ 11 ] = bytes_cnt / 2 & 0xFF;
-                buff[ 12 ] = static_cast <unsigned char>( bytes_cnt );
+    start_connections( nds, cnt );
 
-                for ( unsigned int idx = 0, l = 0; idx < nd->AO_cnt; idx++ )
-                    {
-                    switch ( nd->AO_types[ idx ] )
-                        {
-                        case 638:
-                            buff[ 13 + l ] = 0;
-                            buff[ 13 + l + 1 ] = 0;
-                            buff[ 13 + l + 2 ] = 0;
-                            buff[ 13 + l + 3 ] = 0;
-                            l += 4;
-                            break;
+    int res = 0;
+    if ( G_PAC_INFO()->par[ PAC_info::P_IO_PIPELINED_EXCHANGE ] )
+        {
+        res = pipelined_exchange( nds, cnt, is_read );
+        }
+    else
+        {
+        res = serial_exchange( nds, cnt, is_read );
+        }
 
-                        default:
-                            buff[ 13 + l ] = (u_char)( ( nd->AO_[ idx ] >> 8 ) & 0xFF );
-                            buff[ 13 + l + 1 ] = (u_char)( nd->AO_[ idx ] & 0xFF );
-                            l += 2;
-                            break;
-                        }
-                    }
+    if ( is_read )
+        {
+        poll_cycle++;
+        }
 
-                if ( e_communicate( nd, bytes_cnt + 13, 12 ) == 0 )
-                    {
-                    if ( buff[ 7 ] == 0x10 )
-                        {
-                        memcpy( nd->AO, nd->AO_, sizeof( nd->AO ) );
-                        nd->flag_error_write_message = false;
-                        }
-                    else
-                        {
-                        if ( !nd->flag_error_write_message )
-                            {
-                            add_err_to_log( "Write AO", nd->name, nd->ip_address,
-                                static_cast<int>( buff[ 7 ] ), 0x10,
-                                static_cast<int>( buff[ 8 ] ), bytes_cnt );
-                            }
-                        continue;
-                        }
-                    }
-                else
-                    {
-                    continue;
-                    }
-                }// if ( nd->AO_cnt > 0 )
-            }// if ( nd->type == io_node::T_750_341 || ...
-        }// for ( u_int i = 0; i < nodes_count; i++ )
+    return res;
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::serial_exchange( io_node* const* nds, u_int cnt,
+    bool is_read )
+    {
+    int res = 0;
 
-    for ( u_int i = 0; i < nodes_count; i++ )
+    // Сначала обмен с узлами WAGO, затем - с узлами Phoenix.
+    for ( auto type : { io_node::WAGO_750_XXX_ETHERNET, io_node::PHOENIX_BK_ETH } )
         {
-        io_node* nd = nodes[ i ];
-        u_int ao_module_type = 0;
-        u_int ao_module_offset = 0;
-
-        if ( nd->type == io_node::PHOENIX_BK_ETH )
+        for ( u_int i = 0; i < cnt; i++ )
             {
-            if ( !nd->is_active )
+            io_node* nd = nds[ i ];
+            if ( nd->type != type || !nd->is_active )
                 {
                 continue;
                 }
 
-            if ( nd->read_io_error_flag )
+            if ( is_combined_exchange( nd ) )
+                {
+                // Входы узла читаются вместе с записью выходов.
+                if ( is_read ) continue;
+                }
+            else if ( !is_read && nd->read_io_error_flag )
                 {
                 res = 1;
                 continue;
                 }
 
-            if ( nd->AO_cnt > 0 )
+            if ( is_read && !check_poll_time( nd ) )
                 {
-                unsigned int start_register = 0;
-                unsigned int start_write_address = PHOENIX_HOLDINGREGISTERS_STARTADDRESS;
-                unsigned int registers_count;
-
-                if (nd->AO_cnt > MAX_MODBUS_REGISTERS_PER_QUERY)
-                    {
-                    registers_count = MAX_MODBUS_REGISTERS_PER_QUERY;
-                    }
-                else
-                    {
-                    registers_count = nd->AO_cnt;
-                    }
-
-                int bit_src = 0;
-
-                do
-                    {
-                    for (u_int j = 0; j < registers_count * 2; j++)
-                        {
-                        u_char b = 0;
-                        for (u_int k = 0; k < 8; k++)
-                            {
-                            b = b | static_cast <unsigned char>( (nd->DO_[bit_src] & 1) << k );
-                            bit_src++;
-                            }
-                        writebuff[j] = b;
-                        }
-
-                    for (unsigned int idx = start_register, l = 0; idx < start_register + registers_count; idx++)
-                        {
-                        if (nd->AO_types[idx] != ao_module_type)
-                            {
-                            ao_module_type = nd->AO_types[idx];
-                            ao_module_offset = 0;
-                            }
-                        else
-                            {
-                            ao_module_offset++;
-                            }
-
-                        switch (ao_module_type)
-                            {
-                            case 1027843:           //AXL F IOL8
-                            case 1088132:           //AXL SE IOL4
-                                ao_module_offset %= 32;	   //if there are same modules one after other on bus
-                                if (ao_module_offset > 2)  //first 3 words (bytes 0-5) are reserved, 2nd byte is used for trigger discrete outputs.
-                                    {
-                                    memcpy(&writebuff[l], &nd->AO_[idx], 2);
-                                    }
-                                l += 2;
-                                break;
-
-                            case 2688093:			//CNT2 INC2
-                                ao_module_offset %= 14;	   //if there are same modules one after other on bus
-                                if (0 == ao_module_offset) //assign start command and positive increment for both counters
-                                    {
-                                    writebuff[l] = 0x5;
-                                    writebuff[l + 1] = 0x5;
-                                    }
-                                else
-                                    {
-                                    writebuff[l] = 0;
-                                    writebuff[l + 1] = 0;
-                                    }
-                                l += 2;
-                                break;
-
-                            case 2688527:       //AXL F AO4 1H
-                            case 2702072:       //AXL F AI2 AO2 1H
-                            case 1088123:       //AXL SE AO4 I 4-20
-                            case 2688666:       //AXL F RS UNI XC
-                                writebuff[l] = (u_char)((nd->AO_[idx] >> 8) & 0xFF);
-                                writebuff[l + 1] = (u_char)(nd->AO_[idx] & 0xFF);
-                                l += 2;
-                                break;
-
-                            default:
-                                l += 2;
-                                break;
-                            }
-                        }
-
-                    if (write_holding_registers(nd, start_write_address + start_register, registers_count) >= 0)
-                        {
-                        if (buff[7] == 0x10)
-                            {
-                            memcpy(&(nd->AO[start_register]), &(nd->AO_[start_register]), registers_count * 2);
-                            memcpy(&(nd->DO[start_register * 16]), &(nd->DO_[start_register * 16]), registers_count * 16);
-                            nd->flag_error_write_message = false;
-                            }
-                        else
-                            {
-                            if (!nd->flag_error_write_message)
-                                {
-                                add_err_to_log( "Write AO", nd->name, nd->ip_address,
-                                    static_cast<int>( buff[ 7 ] ), 0x10,
-                                    static_cast<int>( buff[ 8 ] ), registers_count );
-
-                                nd->flag_error_write_message = true;
-                                }
-                            res = 1;
-                            }
-                        }
-                    else
-                        {
-                        res = 1;
-                        }
-
-                    start_register += registers_count;
-                    registers_count = nd->AO_cnt - start_register;
-                    if (registers_count > MAX_MODBUS_REGISTERS_PER_QUERY)
-                        {
-                        registers_count = MAX_MODBUS_REGISTERS_PER_QUERY;
-                        }
-
-                    } while (start_register < nd->AO_cnt);
-
-
-                }// if ( nd->AO_cnt > 0 )
+                continue;
+                }
 
-            }// if ( nd->type == io_node::T_750_341 || ...
-        }// for ( u_int i = 0; i < nodes_count; i++ )
+            if ( exchange( nd, is_read ) )
+                {
+                res = 1;
+                }
+            }
+        }
 
     return res;
     }
 //-----------------------------------------------------------------------------
-int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
-    int bytes_to_receive )
+int uni_io_manager::check_connection( io_node* node )
     {
-    // Проверка связи с узлом I/O.
+    // Проверка связи с узлом I/O. Для узлов, опрашиваемых не каждый
+    // цикл, допустимое время без ответа увеличивается на интервал между
+    // циклами их опроса.
     if ( get_delta_millisec( node->last_poll_time ) >=
-        G_PAC_INFO()->par[ PAC_info::P_BK_ANSWER_MAX_WAIT_TIME ] )
+        G_PAC_INFO()->par[ PAC_info::P_BK_ANSWER_MAX_WAIT_TIME ] +
+        node->poll_interval )
         {
         // Если связь была, но сейчас пропала, то выставляем ошибку связи.
         if ( false == node->is_set_err )
             {
             node->is_set_err = true;
-            PAC_critical_errors_manager::get_instance()->set_global_error(
-                PAC_critical_errors_manager::AC_NO_CONNECTION,
-                PAC_critical_errors_manager::AS_IO_COUPLER, node->number );
+            set_node_alarm( PAC_critical_errors_manager::AC_NO_CONNECTION,
+                node->number, true );
             }
 
         // Reset PP mode alarm on communication loss.
         if ( node->is_err_mode_alarm_set )
             {
-            PAC_critical_errors_manager::get_instance()->reset_global_error(
-                PAC_critical_errors_manager::AC_PP_MODE,
-                PAC_critical_errors_manager::AS_IO_COUPLER, node->number,
-                false );
+            set_node_alarm( PAC_critical_errors_manager::AC_PP_MODE,
+                node->number, false, false );
 
             // Reset PP-mode tracking state so a new transition is detected
             // after reconnect.
@@ -577,29 +403,39 @@ int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
         if ( node->is_set_err )
             {
             node->is_set_err = false;
-            PAC_critical_errors_manager::get_instance()->reset_global_error(
-                PAC_critical_errors_manager::AC_NO_CONNECTION,
-                PAC_critical_errors_manager::AS_IO_COUPLER, node->number );
+            set_node_alarm( PAC_critical_errors_manager::AC_NO_CONNECTION,
+                node->number, false );
             }
         }
     // Проверка связи с узлом I/O.-!>
 
-    // Инициализация сетевого соединения, при необходимости.
-    if ( node->state != io_node::ST_OK )
+    // Инициализация сетевого соединения, при необходимости. Подключение
+    // асинхронное - цикл обмена не ожидает его завершения.
+    if ( node->state == io_node::ST_NO_CONNECT )
         {
-        if ( get_delta_millisec( node->last_init_time ) < node->delay_time )
+        if ( !is_reconnect_time( node ) )
             {
             return 1;
             }
 
-        net_init( node );
-        if ( node->state != io_node::ST_OK )
+        if ( net_init_start( node ) )
             {
-            node->last_init_time = get_millisec();
-            if ( node->delay_time < io_node::C_MAX_DELAY )
-                {
-                node->delay_time += node->delay_time;
-                }
+            set_connect_error( node );
+            return -100;
+            }
+        }
+
+    if ( node->state == io_node::ST_CONNECTING )
+        {
+        auto res = net_init_check( node, false );
+        if ( C_CONNECT_IN_PROGRESS == res )
+            {
+            return 1;
+            }
+
+        if ( res )
+            {
+            set_connect_error( node );
             return -100;
             }
         }
@@ -607,7 +443,60 @@ int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
 
     node->delay_time = io_node::C_INITIAL_RECONNECT_DELAY;
 
-    // Посылка данных.
+    return 0;
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::check_poll_time( io_node* node )
+    {
+    if ( node->poll_period > 1 &&
+        poll_cycle % node->poll_period != node->poll_phase )
+        {
+        return false;
+        }
+
+    node->poll_interval = node->poll_period > 1 ?
+        get_delta_millisec( node->last_poll_cycle_time ) : 0;
+    node->last_poll_cycle_time = get_millisec();
+
+    return true;
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::is_reconnect_time( const io_node* node )
+    {
+    return get_delta_millisec( node->last_init_time ) >= node->delay_time;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::set_connect_error( io_node* node )
+    {
+    node->last_init_time = get_millisec();
+    if ( node->delay_time < io_node::C_MAX_DELAY )
+        {
+        node->delay_time += node->delay_time;
+        }
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::start_connections( io_node* const* nds, u_int cnt )
+    {
+    for ( u_int i = 0; i < cnt; i++ )
+        {
+        io_node* nd = nds[ i ];
+        if ( !nd->is_active || nd->state != io_node::ST_NO_CONNECT ||
+            ( nd->type != io_node::WAGO_750_XXX_ETHERNET &&
+            nd->type != io_node::PHOENIX_BK_ETH ) || !is_reconnect_time( nd ) )
+            {
+            continue;
+            }
+
+        if ( net_init_start( nd ) )
+            {
+            set_connect_error( nd );
+            }
+        }
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::send_request( io_node* node, int bytes_to_send )
+    {
+    auto start_time = get_microsec();
 #ifdef WIN_OS
     int res = send( node->sock, reinterpret_cast<char*>( buff ), bytes_to_send, 0 );
 #else
@@ -615,6 +504,7 @@ int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
         bytes_to_send, 0, io_node::C_RCV_TIMEOUT_US, node->ip_address,
         node->name, &node->send_stat );
 #endif // WIN_OS
+    node->send_hist.add( static_cast<uint32_t>( get_microsec() - start_time ) );
 
     if ( res < 0 )
         {
@@ -622,10 +512,29 @@ int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
         return -101;
         }
 
+    return 0;
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
+    int bytes_to_receive )
+    {
+    if ( auto res = check_connection( node ); res != 0 )
+        {
+        return res;
+        }
+
+    // Посылка данных.
+    if ( auto res = send_request( node, bytes_to_send ); res != 0 )
+        {
+        return res;
+        }
+
     // Получение данных.
-    res = tcp_communicator::recvtimeout( node->sock, buff, bytes_to_receive,
+    auto start_time = get_microsec();
+    auto res = tcp_communicator::recvtimeout( node->sock, buff, bytes_to_receive,
         io_node::C_RCV_TIMEOUT_SEC, io_node::C_RCV_TIMEOUT_US,
         node->ip_address, node->name, &node->recv_stat );
+    node->recv_hist.add( static_cast<uint32_t>( get_microsec() - start_time ) );
 
     if ( res <= 0 ) /* read error */
         {
@@ -636,9 +545,9 @@ int uni_io_manager::e_communicate( io_node* node, int bytes_to_send,
 
     return 0;
     }
-
-int uni_io_manager::read_input_registers(io_node* node, unsigned int address,
-    unsigned int quantity, unsigned char station /*= 0*/)
+//-----------------------------------------------------------------------------
+void uni_io_manager::make_read_input_registers_request( unsigned int address,
+    unsigned int quantity, unsigned char station /*= 0*/ )
     {
     buff[0] = 's';
     buff[1] = 's';
@@ -652,6 +561,12 @@ int uni_io_manager::read_input_registers(io_node* node, unsigned int address,
     buff[9] = (u_int_2)address & 0xFF;
     buff[10] = (u_int_2)quantity >> 8;
     buff[11] = (u_int_2)quantity & 0xFF;
+    }
+
+int uni_io_manager::read_input_registers(io_node* node, unsigned int address,
+    unsigned int quantity, unsigned char station /*= 0*/)
+    {
+    make_read_input_registers_request( address, quantity, station );
     unsigned int bytes_cnt = quantity * 2;
     if (e_communicate(node, 12, bytes_cnt + 9) == 0)
         {
@@ -668,8 +583,8 @@ int uni_io_manager::read_input_registers(io_node* node, unsigned int address,
     return -1;
     }
 
-int uni_io_manager::write_holding_registers(io_node* node,
-    unsigned int address, unsigned int quantity, unsigned char station)
+void uni_io_manager::make_write_holding_registers_request(
+    unsigned int address, unsigned int quantity, unsigned char station )
     {
     unsigned int bytes_cnt = quantity * 2;
     buff[0] = 's';
@@ -685,7 +600,13 @@ int uni_io_manager::write_holding_registers(io_node* node,
     buff[10] = (u_int_2)quantity >> 8;
     buff[11] = (u_int_2)quantity & 0xFF;
     buff[12] = static_cast <unsigned char>( bytes_cnt );
-    if (e_communicate(node, bytes_cnt + 13, 12) == 0)
+    }
+
+int uni_io_manager::write_holding_registers(io_node* node,
+    unsigned int address, unsigned int quantity, unsigned char station)
+    {
+    make_write_holding_registers_request( address, quantity, station );
+    if (e_communicate(node, quantity * 2 + 13, 12) == 0)
         {
         if (buff[7] == 0x10)
             {
@@ -712,288 +633,1096 @@ void uni_io_manager::add_err_to_log( const char* cmd,
     G_LOG->write_log( i_log::P_ERR );
     };
 //-----------------------------------------------------------------------------
-int uni_io_manager::read_inputs()
+u_int uni_io_manager::get_queries_count( u_int registers_count )
     {
-    if ( 0 == nodes_count )
+    return ( registers_count + MAX_MODBUS_REGISTERS_PER_QUERY - 1 ) /
+        MAX_MODBUS_REGISTERS_PER_QUERY;
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::make_request( io_node* nd, bool is_read, u_int& step,
+    int& bytes_to_send, int& bytes_to_receive )
+    {
+    if ( !is_read && is_combined_exchange( nd ) )
         {
-        return 0;
+        return make_combined_request( nd, step, bytes_to_send,
+            bytes_to_receive );
         }
 
-    auto res = 0;
-    for (u_int i = 0; i < nodes_count; i++ )
+    return is_read ?
+        make_read_request( nd, step, bytes_to_send, bytes_to_receive ) :
+        make_write_request( nd, step, bytes_to_send, bytes_to_receive );
+    }
+//-----------------------------------------------------------------------------
+u_int uni_io_manager::process_response( io_node* nd, bool is_read,
+    u_int step, int comm_res, int& res )
+    {
+    if ( !is_read && is_combined_exchange( nd ) )
         {
-        io_node* nd = nodes[ i ];
-
-        if ( nd->type == io_node::WAGO_750_XXX_ETHERNET ) // Ethernet I/O nodes.
-            {
-            if ( !nd->is_active )
-                {
-                continue;
-                }
+        return process_combined_response( nd, step, comm_res, res );
+        }
 
-            if ( nd->DI_cnt > 0 )
+    return is_read ?
+        process_read_response( nd, step, comm_res, res ) :
+        process_write_response( nd, step, comm_res, res );
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::make_read_request( io_node* nd, u_int& step,
+    int& bytes_to_send, int& bytes_to_receive )
+    {
+    switch ( nd->type )
+        {
+        case io_node::WAGO_750_XXX_ETHERNET:
+            if ( WAGO_STEP_DISCRETE == step && 0 == nd->DI_cnt ) step++;
+            if ( WAGO_STEP_ANALOG == step && 0 == nd->AI_cnt ) step++;
+
+            buff[ 0 ] = 's';
+            buff[ 1 ] = 's';
+            buff[ 2 ] = 0;
+            buff[ 3 ] = 0;
+            buff[ 4 ] = 0;
+            buff[ 5 ] = 6;
+            buff[ 6 ] = 0;
+            buff[ 8 ] = 0;
+            buff[ 9 ] = 0;
+            bytes_to_send = 12;
+
+            if ( WAGO_STEP_DISCRETE == step )
                 {
-                buff[ 0 ] = 's';
-                buff[ 1 ] = 's';
-                buff[ 2 ] = 0;
-                buff[ 3 ] = 0;
-                buff[ 4 ] = 0;
-                buff[ 5 ] = 6;
-                buff[ 6 ] = 0;
                 buff[ 7 ] = 0x02;
-                buff[ 8 ] = 0;
-                buff[ 9 ] = 0;
                 buff[ 10 ] = (unsigned char)nd->DI_cnt >> 7 >> 1;
                 buff[ 11 ] = (unsigned char)nd->DI_cnt & 0xFF;
 
                 u_int bytes_cnt = nd->DI_cnt / 8 + ( nd->DI_cnt % 8 > 0 ? 1 : 0 );
+                bytes_to_receive = bytes_cnt + 9;
+                return true;
+                }
 
-                if ( e_communicate( nd, 12, bytes_cnt + 9 ) == 0 )
-                    {
-                    if ( buff[ 7 ] == 0x02 && buff[ 8 ] == bytes_cnt )
-                        {
-                        for ( u_int j = 0, idx = 0; j < bytes_cnt; j++ )
-                            {
-                            for ( int k = 0; k < 8; k++ )
-                                {
-                                if ( idx < nd->DI_cnt )
-                                    {
-                                    nd->DI[ idx ] = ( buff[ j + 9 ] >> k ) & 1;
-#ifdef DEBUG_KBUS
-                                    printf( "%d -> %d, ", idx, nd->DI[ idx ] );
-#endif // DEBUG_KBUS
-                                    idx++;
-                                    }
-                                }
-                            }
-#ifdef DEBUG_KBUS
-                        printf( "\n" );
-#endif // DEBUG_KBUS
-                        nd->read_io_error_flag = false;
-                        nd->flag_error_read_message = false;
-                        }
-                    else
-                        {
-                        if ( !nd->flag_error_read_message )
-                            {
-                            add_err_to_log( "Read DI", nd->name, nd->ip_address,
-                                static_cast<int>( buff[ 7 ] ), 0x02,
-                                static_cast<int>( buff[ 8 ] ), bytes_cnt );
-                            nd->flag_error_read_message = true;
-                            }
-                        nd->read_io_error_flag = true;
-                        res = 1;
-                        continue;
-                        }
-                    } // if ( buff[ 7 ] == 0x02 && buff[ 8 ] == bytes_cnt )
-                else
-                    {
-                    nd->read_io_error_flag = true;
-                    res = 1;
-                    continue;
-                    }
-                }// if ( nd->DI_cnt > 0 )
-
-            if ( nd->AI_cnt > 0 )
+            if ( WAGO_STEP_ANALOG == step )
                 {
-                buff[ 0 ] = 's';
-                buff[ 1 ] = 's';
-                buff[ 2 ] = 0;
-                buff[ 3 ] = 0;
-                buff[ 4 ] = 0;
-                buff[ 5 ] = 6;
-                buff[ 6 ] = 0;
                 buff[ 7 ] = 0x04;
-                buff[ 8 ] = 0;
-                buff[ 9 ] = 0;
 
                 u_int bytes_cnt = nd->AI_size;
 
                 buff[ 10 ] = (unsigned char)bytes_cnt / 2 >> 8;
                 buff[ 11 ] = (unsigned char)bytes_cnt / 2 & 0xFF;
+                bytes_to_receive = bytes_cnt + 9;
+                return true;
+                }
 
-                if ( e_communicate( nd, 12, bytes_cnt + 9 ) == 0 )
-                    {
-                    if ( buff[ 7 ] == 0x04 && buff[ 8 ] == bytes_cnt )
-                        {
-                        int idx = 0;
-                        for ( unsigned int l = 0; l < nd->AI_cnt; l++ )
-                            {
-                            switch ( nd->AI_types[ l ] )
-                                {
-                                case 638:
-                                    nd->AI[ l ] = 256 * buff[ 9 + idx + 2 ] +
-                                        buff[ 9 + idx + 3 ];
-                                    idx += 4;
-                                    break;
-
-                                default:
-                                    nd->AI[ l ] = 256 * buff[ 9 + idx ] +
-                                        buff[ 9 + idx + 1 ];
-                                    idx += 2;
-                                    break;
-                                }
-                            }
-                        nd->read_io_error_flag = false;
-                        nd->flag_error_read_message = false;
-                        } // if ( buff[ 7 ] == 0x04 && buff[ 8 ] == bytes_cnt )
-                    else
-                        {
-                        if ( !nd->flag_error_read_message )
-                            {
-                            add_err_to_log( "Read AI", nd->name, nd->ip_address,
-                                static_cast<int>( buff[ 7 ] ), 0x04,
-                                static_cast<int>( buff[ 8 ] ), bytes_cnt );
-                            nd->flag_error_read_message = true;
-                            }
-                        nd->read_io_error_flag = true;
-                        res = 1;
-                        continue;
-                        }
-                    }
-                else
-                    {
-                    nd->read_io_error_flag = true;
-                    res = 1;
-                    continue;
-                    } // if ( e_communicate( nd, 12, bytes_cnt + 9 ) == 0 )
-                }// if ( nd->AI_cnt > 0 )
+            return false;
 
-            }// if ( nd->type == io_node::T_750_341 || ...
-        }// for ( u_int i = 0; i < nodes_count; i++ )
+        case io_node::PHOENIX_BK_ETH:
+            {
+            // Шаги: чтение входных регистров (частями не более
+            // MAX_MODBUS_REGISTERS_PER_QUERY), затем - регистра статуса.
+            auto queries_cnt = get_queries_count( nd->AI_cnt );
+            if ( step < queries_cnt )
+                {
+                u_int start_register = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+                u_int registers_count = std::min<u_int>( nd->AI_cnt - start_register,
+                    MAX_MODBUS_REGISTERS_PER_QUERY );
+#ifdef DEBUG_BK_MIN
+                G_LOG->warning( "Read %d node registers from %d", registers_count,
+                    PHOENIX_INPUTREGISTERS_STARTADDRESS + start_register );
+#endif // DEBUG_BK_MIN
+                make_read_input_registers_request(
+                    PHOENIX_INPUTREGISTERS_STARTADDRESS + start_register,
+                    registers_count );
+                bytes_to_send = 12;
+                bytes_to_receive = registers_count * 2 + 9;
+                return true;
+                }
 
-    for ( u_int i = 0; i < nodes_count; i++ )
-        {
-        io_node* nd = nodes[ i ];
+            if ( step == queries_cnt )
+                {
+                // Read Status Register (7996) for PP mode detection.
+                make_read_input_registers_request(
+                    PHOENIX_STATUS_REGISTER_ADDRESS, 1 );
+                bytes_to_send = 12;
+                bytes_to_receive = 2 + 9;
+                return true;
+                }
+
+            return false;
+            }
 
-        if ( nd->type == io_node::PHOENIX_BK_ETH ) // Ethernet I/O nodes.
+        default:
+            return false;
+        }
+    }
+//-----------------------------------------------------------------------------
+u_int uni_io_manager::process_read_response( io_node* nd, u_int step,
+    int comm_res, int& res )
+    {
+    if ( nd->type == io_node::WAGO_750_XXX_ETHERNET )
+        {
+        if ( comm_res != 0 )
             {
+            nd->read_io_error_flag = true;
+            res = 1;
+            return WAGO_STEP_END;
+            }
 
-            if ( !nd->is_active )
+        if ( WAGO_STEP_DISCRETE == step )
+            {
+            u_int bytes_cnt = nd->DI_cnt / 8 + ( nd->DI_cnt % 8 > 0 ? 1 : 0 );
+            if ( buff[ 7 ] == 0x02 && buff[ 8 ] == bytes_cnt )
                 {
-                continue;
+                unpack_bits( &buff[ 9 ], nd->DI, nd->DI_cnt );
+#ifdef DEBUG_KBUS
+                for ( u_int idx = 0; idx < nd->DI_cnt; idx++ )
+                    {
+                    printf( "%d -> %d, ", idx, nd->DI[ idx ] );
+                    }
+                printf( "\n" );
+#endif // DEBUG_KBUS
+                nd->read_io_error_flag = false;
+                nd->flag_error_read_message = false;
+                return WAGO_STEP_ANALOG;
                 }
 
-            if (nd->AI_cnt > 0)
+            if ( !nd->flag_error_read_message )
                 {
-                unsigned int start_register = 0;
-                unsigned int start_read_address = PHOENIX_INPUTREGISTERS_STARTADDRESS;
-                unsigned int registers_count;
+                add_err_to_log( "Read DI", nd->name, nd->ip_address,
+                    static_cast<int>( buff[ 7 ] ), 0x02,
+                    static_cast<int>( buff[ 8 ] ), bytes_cnt );
+                nd->flag_error_read_message = true;
+                }
+            nd->read_io_error_flag = true;
+            res = 1;
+            return WAGO_STEP_END;
+            }
 
-                if (nd->AI_cnt > MAX_MODBUS_REGISTERS_PER_QUERY)
-                    {
-                    registers_count = MAX_MODBUS_REGISTERS_PER_QUERY;
-                    }
-                else
+        // WAGO_STEP_ANALOG.
+        u_int bytes_cnt = nd->AI_size;
+        if ( buff[ 7 ] == 0x04 && buff[ 8 ] == bytes_cnt )
+            {
+            int idx = 0;
+            for ( unsigned int l = 0; l < nd->AI_cnt; l++ )
+                {
+                switch ( nd->AI_types[ l ] )
                     {
-                    registers_count = nd->AI_cnt;
+                    case 638:
+                        nd->AI[ l ] = 256 * buff[ 9 + idx + 2 ] +
+                            buff[ 9 + idx + 3 ];
+                        idx += 4;
+                        break;
+
+                    default:
+                        nd->AI[ l ] = 256 * buff[ 9 + idx ] +
+                            buff[ 9 + idx + 1 ];
+                        idx += 2;
+                        break;
                     }
+                }
+            nd->read_io_error_flag = false;
+            nd->flag_error_read_message = false;
+            }
+        else
+            {
+            if ( !nd->flag_error_read_message )
+                {
+                add_err_to_log( "Read AI", nd->name, nd->ip_address,
+                    static_cast<int>( buff[ 7 ] ), 0x04,
+                    static_cast<int>( buff[ 8 ] ), bytes_cnt );
+                nd->flag_error_read_message = true;
+                }
+            nd->read_io_error_flag = true;
+            res = 1;
+            }
+        return WAGO_STEP_END;
+        }
 
-                unsigned int analog_dest = 0;
-                unsigned int bit_dest = 0;
+    // io_node::PHOENIX_BK_ETH.
+    auto queries_cnt = get_queries_count( nd->AI_cnt );
+    if ( step == queries_cnt )
+        {
+        if ( 0 == comm_res && buff[ 7 ] == 0x04 && buff[ 8 ] == 2 )
+            {
+            resultbuff = &buff[ 9 ];
+            update_phoenix_status_register( nd );
+            }
+        return step + 1;
+        }
 
-                do
-                    {
-#ifdef DEBUG_BK_MIN
-                    G_LOG->warning("Read %d node registers from %d", registers_count, start_read_address + start_register);
-#endif // DEBUG_BK_MIN
-                    int result = read_input_registers(nd, start_read_address + start_register, registers_count);
+    if ( comm_res != 0 )
+        {
+        nd->read_io_error_flag = true;
+        res = 1;
+        return queries_cnt;
+        }
+
+    u_int start_register = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+    u_int registers_count = std::min<u_int>( nd->AI_cnt - start_register,
+        MAX_MODBUS_REGISTERS_PER_QUERY );
+
+    if ( buff[ 7 ] != 0x04 || buff[ 8 ] != registers_count * 2 )
+        {
+        if ( !nd->flag_error_read_message )
+            {
+            add_err_to_log( "Read AI", nd->name, nd->ip_address,
+                static_cast<int>( buff[ 7 ] ), 0x04,
+                static_cast<int>( buff[ 8 ] ), registers_count * 2 );
+            nd->flag_error_read_message = true;
+            }
+        nd->read_io_error_flag = true;
+        res = 1;
+        return queries_cnt;
+        }
+
+    resultbuff = &buff[ 9 ];
 
 #ifdef TEST_NODE_IO
-                    printf("\n\r");
-                    for (int ideb = 0; ideb < registers_count; ideb++)
-                        {
-                        printf("%d = %d, ", start_read_address + start_register + ideb, 256 * resultbuff[ideb * 2] + resultbuff[ideb * 2 + 1]);
-                        }
+    printf( "\n\r" );
+    for ( u_int ideb = 0; ideb < registers_count; ideb++ )
+        {
+        printf( "%d = %d, ",
+            PHOENIX_INPUTREGISTERS_STARTADDRESS + start_register + ideb,
+            256 * resultbuff[ ideb * 2 ] + resultbuff[ ideb * 2 + 1 ] );
+        }
 #endif
 
-                    if (result >= 0)
-                        {
-                        if (result)
-                            {
-                            for (int index_source = 0; analog_dest < start_register + registers_count; analog_dest++)
-                                {
-                                switch (nd->AI_types[analog_dest])
-                                    {
-                                    case 1027843:           //AXL F IOL8
-                                    case 1088132:           //AXL SE IOL4
-                                        memcpy(&nd->AI[analog_dest], resultbuff + index_source, 2);
-                                        index_source += 2;
-                                        break;
-
-                                    default:
-                                        nd->AI[analog_dest] = 256 * resultbuff[index_source] + resultbuff[index_source + 1];
-                                        index_source += 2;
-                                        break;
-                                    }
-#ifdef DEBUG_BK
-                                G_LOG->warning("%d %u", analog_dest, nd->AI[analog_dest]);
-#endif // DEBUG_BK
-                                }
+    for ( u_int i = 0; i < registers_count; i++ )
+        {
+        set_phoenix_input_register( nd, start_register + i, resultbuff + i * 2 );
+        }
 
-                            for (int index_source = 0; bit_dest < (start_register + registers_count) * 2 * 8; index_source++)
-                                {
-                                for (int k = 0; k < 8; k++)
-                                    {
-                                    nd->DI[bit_dest] = (resultbuff[index_source] >> k) & 1;
+    nd->read_io_error_flag = false;
+    nd->flag_error_read_message = false;
+    return step + 1;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::set_phoenix_input_register( io_node* nd, u_int idx,
+    const u_char* src )
+    {
+    switch ( nd->AI_types[ idx ] )
+        {
+        case 1027843:           //AXL F IOL8
+        case 1088132:           //AXL SE IOL4
+            memcpy( &nd->AI[ idx ], src, 2 );
+            break;
+
+        default:
+            nd->AI[ idx ] = 256 * src[ 0 ] + src[ 1 ];
+            break;
+        }
 #ifdef DEBUG_BK
-                                    G_LOG->notice("%d %d", bit_dest, (resultbuff[index_source] >> k) & 1);
+    G_LOG->warning( "%d %u", idx, nd->AI[ idx ] );
 #endif // DEBUG_BK
-                                    bit_dest++;
-                                    }
-                                }
-                            }
-                        else
-                            {
-                            if ( !nd->flag_error_read_message )
-                                {
-                                add_err_to_log( "Read AI", nd->name, nd->ip_address,
-                                    static_cast<int>( buff[ 7 ] ), 0x04,
-                                    static_cast<int>( buff[ 8 ] ), registers_count * 2 );
-                                nd->flag_error_read_message = true;
-                                }
-                            nd->read_io_error_flag = true;
-                            res = 1;
-                            break;
-                            }
-                        }
-                    else
+
+    // Дискретные входы передаются в тех же регистрах (16 на регистр).
+    unpack_bits( src, &nd->DI[ idx * 2 * 8 ], 2 * 8 );
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::update_outputs_refresh( io_node* nd )
+    {
+    auto period = G_PAC_INFO()->par[ PAC_info::P_IO_OUTPUTS_REFRESH_TIME ];
+
+    nd->is_outputs_refresh = 0 == period || nd->is_outputs_refresh_forced ||
+        get_delta_millisec( nd->last_outputs_refresh_time ) >= period;
+    if ( nd->is_outputs_refresh )
+        {
+        nd->last_outputs_refresh_time = get_millisec();
+        nd->is_outputs_refresh_forced = false;
+        }
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::is_write_needed( const io_node* nd, u_int step )
+    {
+    if ( nd->is_outputs_refresh )
+        {
+        return true;
+        }
+
+    switch ( nd->type )
+        {
+        case io_node::WAGO_750_XXX_ETHERNET:
+            if ( WAGO_STEP_DISCRETE == step )
+                {
+                return memcmp( nd->DO, nd->DO_, nd->DO_cnt ) != 0;
+                }
+            return memcmp( nd->AO, nd->AO_, nd->AO_cnt * sizeof( int_2 ) ) != 0;
+
+        case io_node::PHOENIX_BK_ETH:
+            {
+            u_int start_register = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+            u_int registers_count = std::min<u_int>( nd->AO_cnt - start_register,
+                MAX_MODBUS_REGISTERS_PER_QUERY );
+            return is_phoenix_write_needed( nd, start_register,
+                registers_count );
+            }
+
+        default:
+            return true;
+        }
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::is_phoenix_write_needed( const io_node* nd,
+    u_int start_register, u_int registers_count )
+    {
+    if ( nd->is_outputs_refresh )
+        {
+        return true;
+        }
+
+    if ( memcmp( &nd->AO[ start_register ], &nd->AO_[ start_register ],
+        registers_count * sizeof( int_2 ) ) != 0 )
+        {
+        return true;
+        }
+
+    // Дискретные выходы передаются в тех же регистрах (16 на регистр).
+    u_int DO_start = std::min( start_register * 16, nd->DO_cnt );
+    u_int DO_end = std::min( ( start_register + registers_count ) * 16,
+        nd->DO_cnt );
+    return memcmp( &nd->DO[ DO_start ], &nd->DO_[ DO_start ],
+        DO_end - DO_start ) != 0;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::apply_phoenix_outputs( io_node* nd, u_int start_register,
+    u_int registers_count )
+    {
+    memcpy( &( nd->AO[ start_register ] ), &( nd->AO_[ start_register ] ),
+        registers_count * 2 );
+    memcpy( &( nd->DO[ start_register * 16 ] ),
+        &( nd->DO_[ start_register * 16 ] ), registers_count * 16 );
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::make_write_request( io_node* nd, u_int& step,
+    int& bytes_to_send, int& bytes_to_receive )
+    {
+    if ( 0 == step )
+        {
+        update_outputs_refresh( nd );
+        }
+
+    switch ( nd->type )
+        {
+        case io_node::WAGO_750_XXX_ETHERNET:
+            if ( WAGO_STEP_DISCRETE == step &&
+                ( 0 == nd->DO_cnt || !is_write_needed( nd, step ) ) ) step++;
+            if ( WAGO_STEP_ANALOG == step &&
+                ( 0 == nd->AO_cnt || !is_write_needed( nd, step ) ) ) step++;
+
+            buff[ 0 ] = 's';
+            buff[ 1 ] = 's';
+            buff[ 2 ] = 0;
+            buff[ 3 ] = 0;
+            buff[ 4 ] = 0;
+            buff[ 6 ] = 0; //nodes[ i ]->number;
+            buff[ 8 ] = 0;
+            buff[ 9 ] = 0;
+            bytes_to_receive = 12;
+
+            if ( WAGO_STEP_DISCRETE == step )
+                {
+                u_int bytes_cnt = nd->DO_cnt / 8 + ( nd->DO_cnt % 8 > 0 ? 1 : 0 );
+
+                buff[ 5 ] = static_cast <unsigned char>( 7u + bytes_cnt );
+                buff[ 7 ] = 0x0F;
+                buff[ 10 ] = (unsigned char)nd->DO_cnt >> 7 >> 1;
+                buff[ 11 ] = (unsigned char)nd->DO_cnt & 0xFF;
+                buff[ 12 ] = static_cast <unsigned char>( bytes_cnt );
+                pack_bits( nd->DO_, &buff[ 13 ], nd->DO_cnt );
+
+                bytes_to_send = bytes_cnt + 13;
+                return true;
+                }
+
+            if ( WAGO_STEP_ANALOG == step )
+                {
+                u_int bytes_cnt = nd->AO_size;
+
+                buff[ 5 ] = static_cast <unsigned char>( 7u + bytes_cnt );
+                buff[ 7 ] = 0x10;
+                buff[ 10 ] = static_cast <unsigned char>( bytes_cnt / 2 >> 8 );
+                buff[ 11 ] = bytes_cnt / 2 & 0xFF;
+                buff[ 12 ] = static_cast <unsigned char>( bytes_cnt );
+
+                for ( unsigned int idx = 0, l = 0; idx < nd->AO_cnt; idx++ )
+                    {
+                    switch ( nd->AO_types[ idx ] )
                         {
-                        nd->read_io_error_flag = true;
-                        res = 1;
-                        break;
+                        case 638:
+                            buff[ 13 + l ] = 0;
+                            buff[ 13 + l + 1 ] = 0;
+                            buff[ 13 + l + 2 ] = 0;
+                            buff[ 13 + l + 3 ] = 0;
+                            l += 4;
+                            break;
+
+                        default:
+                            buff[ 13 + l ] = (u_char)( ( nd->AO_[ idx ] >> 8 ) & 0xFF );
+                            buff[ 13 + l + 1 ] = (u_char)( nd->AO_[ idx ] & 0xFF );
+                            l += 2;
+                            break;
                         }
-                    start_register += registers_count;
-                    registers_count = nd->AI_cnt - start_register;
-                    if (registers_count > MAX_MODBUS_REGISTERS_PER_QUERY)
+                    }
+
+                bytes_to_send = bytes_cnt + 13;
+                return true;
+                }
+
+            return false;
+
+        case io_node::PHOENIX_BK_ETH:
+            {
+            auto queries_cnt = get_queries_count( nd->AO_cnt );
+            while ( step < queries_cnt && !is_write_needed( nd, step ) )
+                {
+                step++;
+                }
+            if ( step >= queries_cnt )
+                {
+                return false;
+                }
+
+            u_int start_register = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+            u_int registers_count = std::min<u_int>( nd->AO_cnt - start_register,
+                MAX_MODBUS_REGISTERS_PER_QUERY );
+
+            fill_phoenix_outputs( nd, start_register, registers_count,
+                writebuff );
+            make_write_holding_registers_request(
+                PHOENIX_HOLDINGREGISTERS_STARTADDRESS + start_register,
+                registers_count );
+            bytes_to_send = registers_count * 2 + 13;
+            bytes_to_receive = 12;
+            return true;
+            }
+
+        default:
+            return false;
+        }
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::fill_phoenix_outputs( const io_node* nd,
+    u_int start_register, u_int registers_count, u_char* dst )
+    {
+    pack_bits( &nd->DO_[ start_register * 2 * 8 ], dst, registers_count * 2 * 8 );
+
+    // Тип модуля и смещение в пределах модуля отслеживаются с начала
+    // узла, так как модуль может начинаться в предыдущей части.
+    u_int ao_module_type = 0;
+    u_int ao_module_offset = 0;
+    for ( u_int idx = 0, l = 0; idx < start_register + registers_count; idx++ )
+        {
+        if ( nd->AO_types[ idx ] != ao_module_type )
+            {
+            ao_module_type = nd->AO_types[ idx ];
+            ao_module_offset = 0;
+            }
+        else
+            {
+            ao_module_offset++;
+            }
+
+        if ( idx < start_register )
+            {
+            continue;
+            }
+
+        switch ( ao_module_type )
+            {
+            case 1027843:           //AXL F IOL8
+            case 1088132:           //AXL SE IOL4
+                ao_module_offset %= 32;	   //if there are same modules one after other on bus
+                if ( ao_module_offset > 2 )  //first 3 words (bytes 0-5) are reserved, 2nd byte is used for trigger discrete outputs.
+                    {
+                    memcpy( &dst[ l ], &nd->AO_[ idx ], 2 );
+                    }
+                l += 2;
+                break;
+
+            case 2688093:			//CNT2 INC2
+                ao_module_offset %= 14;	   //if there are same modules one after other on bus
+                if ( 0 == ao_module_offset ) //assign start command and positive increment for both counters
+                    {
+                    dst[ l ] = 0x5;
+                    dst[ l + 1 ] = 0x5;
+                    }
+                else
+                    {
+                    dst[ l ] = 0;
+                    dst[ l + 1 ] = 0;
+                    }
+                l += 2;
+                break;
+
+            case 2688527:       //AXL F AO4 1H
+            case 2702072:       //AXL F AI2 AO2 1H
+            case 1088123:       //AXL SE AO4 I 4-20
+            case 2688666:       //AXL F RS UNI XC
+                dst[ l ] = (u_char)( ( nd->AO_[ idx ] >> 8 ) & 0xFF );
+                dst[ l + 1 ] = (u_char)( nd->AO_[ idx ] & 0xFF );
+                l += 2;
+                break;
+
+            default:
+                l += 2;
+                break;
+            }
+        }
+    }
+//-----------------------------------------------------------------------------
+u_int uni_io_manager::process_write_response( io_node* nd, u_int step,
+    int comm_res, int& res )
+    {
+    if ( nd->type == io_node::WAGO_750_XXX_ETHERNET )
+        {
+        if ( WAGO_STEP_DISCRETE == step )
+            {
+            if ( comm_res != 0 )
+                {
+                // Была какая-то сетевая ошибка.
+                res = 1;
+                return WAGO_STEP_END;
+                }
+
+            if ( buff[ 7 ] == 0x0F )
+                {
+                memcpy( nd->DO, nd->DO_, nd->DO_cnt );
+                nd->flag_error_write_message = false;
+                return WAGO_STEP_ANALOG;
+                }
+
+            if ( !nd->flag_error_write_message )
+                {
+                // Есть какая-то ошибка на прикладном уровне.
+                u_int bytes_cnt = nd->DO_cnt / 8 + ( nd->DO_cnt % 8 > 0 ? 1 : 0 );
+                add_err_to_log( "Write DO", nd->name, nd->ip_address,
+                    static_cast<int>( buff[ 7 ] ), 0x0F,
+                    static_cast<int>( buff[ 8 ] ), bytes_cnt );
+                res = 1;
+                nd->flag_error_write_message = true;
+                }
+            return WAGO_STEP_END;
+            }
+
+        // WAGO_STEP_ANALOG.
+        if ( comm_res != 0 )
+            {
+            return WAGO_STEP_END;
+            }
+
+        if ( buff[ 7 ] == 0x10 )
+            {
+            memcpy( nd->AO, nd->AO_, sizeof( nd->AO ) );
+            nd->flag_error_write_message = false;
+            }
+        else
+            {
+            if ( !nd->flag_error_write_message )
+                {
+                add_err_to_log( "Write AO", nd->name, nd->ip_address,
+                    static_cast<int>( buff[ 7 ] ), 0x10,
+                    static_cast<int>( buff[ 8 ] ), nd->AO_size );
+                }
+            }
+        return WAGO_STEP_END;
+        }
+
+    // io_node::PHOENIX_BK_ETH.
+    if ( comm_res != 0 )
+        {
+        res = 1;
+        return step + 1;
+        }
+
+    u_int start_register = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+    u_int registers_count = std::min<u_int>( nd->AO_cnt - start_register,
+        MAX_MODBUS_REGISTERS_PER_QUERY );
+
+    if ( buff[ 7 ] == 0x10 )
+        {
+        apply_phoenix_outputs( nd, start_register, registers_count );
+        nd->flag_error_write_message = false;
+        }
+    else
+        {
+        if ( !nd->flag_error_write_message )
+            {
+            add_err_to_log( "Write AO", nd->name, nd->ip_address,
+                static_cast<int>( buff[ 7 ] ), 0x10,
+                static_cast<int>( buff[ 8 ] ), registers_count );
+
+            nd->flag_error_write_message = true;
+            }
+        res = 1;
+        }
+
+    return step + 1;
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::is_combined_exchange( const io_node* nd )
+    {
+    return nd->type == io_node::PHOENIX_BK_ETH &&
+        !nd->is_rw_registers_unsupported &&
+        G_PAC_INFO()->par[ PAC_info::P_IO_COMBINED_EXCHANGE ];
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::get_combined_step( const io_node* nd, u_int step,
+    u_int& read_start, u_int& read_count, u_int& write_start,
+    u_int& write_count )
+    {
+    // Регистр статуса читается вместе со входными регистрами (вместе с
+    // промежуточными регистрами между ними).
+    u_int read_registers = nd->is_combined_read ?
+        PHOENIX_INPUTREGISTERS_STARTADDRESS -
+        PHOENIX_STATUS_REGISTER_ADDRESS + nd->AI_cnt : 0;
+
+    read_start = step * MAX_MODBUS_REGISTERS_PER_QUERY;
+    read_count = read_start < read_registers ?
+        std::min<u_int>( read_registers - read_start,
+        MAX_MODBUS_REGISTERS_PER_QUERY ) : 0;
+
+    write_start = step * MAX_MODBUS_RW_WRITE_REGISTERS;
+    write_count = write_start < nd->AO_cnt ?
+        std::min<u_int>( nd->AO_cnt - write_start,
+        MAX_MODBUS_RW_WRITE_REGISTERS ) : 0;
+    if ( write_count &&
+        !is_phoenix_write_needed( nd, write_start, write_count ) )
+        {
+        write_count = 0;
+        }
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::make_combined_request( io_node* nd, u_int& step,
+    int& bytes_to_send, int& bytes_to_receive )
+    {
+    if ( 0 == step )
+        {
+        update_outputs_refresh( nd );
+        nd->is_combined_read = check_poll_time( nd );
+        }
+
+    u_int read_registers = PHOENIX_INPUTREGISTERS_STARTADDRESS -
+        PHOENIX_STATUS_REGISTER_ADDRESS + nd->AI_cnt;
+    u_int steps_cnt = std::max( get_queries_count( read_registers ),
+        ( nd->AO_cnt + MAX_MODBUS_RW_WRITE_REGISTERS - 1 ) /
+        MAX_MODBUS_RW_WRITE_REGISTERS );
+
+    u_int read_start = 0;
+    u_int read_count = 0;
+    u_int write_start = 0;
+    u_int write_count = 0;
+    for ( ; step < steps_cnt; step++ )
+        {
+        get_combined_step( nd, step, read_start, read_count, write_start,
+            write_count );
+        if ( read_count || write_count )
+            {
+            break;
+            }
+        }
+    if ( step >= steps_cnt )
+        {
+        return false;
+        }
+
+    if ( read_count && write_count )
+        {
+        // Функция 0x17 - чтение входных и запись выходных регистров
+        // одной транзакцией.
+        u_int bytes_cnt = write_count * 2;
+        u_int read_address = PHOENIX_STATUS_REGISTER_ADDRESS + read_start;
+        u_int write_address = PHOENIX_HOLDINGREGISTERS_STARTADDRESS +
+            write_start;
+        buff[ 0 ] = 's';
+        buff[ 1 ] = 's';
+        buff[ 2 ] = 0;
+        buff[ 3 ] = 0;
+        buff[ 4 ] = 0;
+        buff[ 5 ] = static_cast <unsigned char>( 11 + bytes_cnt );
+        buff[ 6 ] = 0;
+        buff[ 7 ] = 0x17;
+        buff[ 8 ] = (u_int_2)read_address >> 8;
+        buff[ 9 ] = (u_int_2)read_address & 0xFF;
+        buff[ 10 ] = (u_int_2)read_count >> 8;
+        buff[ 11 ] = (u_int_2)read_count & 0xFF;
+        buff[ 12 ] = (u_int_2)write_address >> 8;
+        buff[ 13 ] = (u_int_2)write_address & 0xFF;
+        buff[ 14 ] = (u_int_2)write_count >> 8;
+        buff[ 15 ] = (u_int_2)write_count & 0xFF;
+        buff[ 16 ] = static_cast <unsigned char>( bytes_cnt );
+        fill_phoenix_outputs( nd, write_start, write_count, &buff[ 17 ] );
+
+        bytes_to_send = bytes_cnt + 17;
+        bytes_to_receive = read_count * 2 + 9;
+        return true;
+        }
+
+    if ( read_count )
+        {
+        make_read_input_registers_request(
+            PHOENIX_STATUS_REGISTER_ADDRESS + read_start, read_count );
+        bytes_to_send = 12;
+        bytes_to_receive = read_count * 2 + 9;
+        return true;
+        }
+
+    fill_phoenix_outputs( nd, write_start, write_count, writebuff );
+    make_write_holding_registers_request(
+        PHOENIX_HOLDINGREGISTERS_STARTADDRESS + write_start, write_count );
+    bytes_to_send = write_count * 2 + 13;
+    bytes_to_receive = 12;
+    return true;
+    }
+//-----------------------------------------------------------------------------
+u_int uni_io_manager::process_combined_response( io_node* nd, u_int step,
+    int comm_res, int& res )
+    {
+    u_int read_start = 0;
+    u_int read_count = 0;
+    u_int write_start = 0;
+    u_int write_count = 0;
+    get_combined_step( nd, step, read_start, read_count, write_start,
+        write_count );
+
+    if ( comm_res != 0 )
+        {
+        if ( read_count ) nd->read_io_error_flag = true;
+        res = 1;
+        return C_STEP_END;
+        }
+
+    u_char fun_code = read_count && write_count ? 0x17 :
+        ( read_count ? 0x04 : 0x10 );
+    if ( 0x17 == fun_code && buff[ 7 ] == ( 0x80 | 0x17 ) )
+        {
+        // Узел не поддерживает функцию 0x17 - далее обмен с ним выполняется
+        // отдельными транзакциями чтения и записи.
+        nd->is_rw_registers_unsupported = true;
+        nd->is_outputs_refresh_forced = true;
+        auto result = fmt::format_to_n( G_LOG->msg, i_log::C_BUFF_SIZE,
+            R"(Bus coupler "{}":"{}" does not support read/write )"
+            "multiple registers (0x17), separate requests are used.",
+            nd->name, nd->ip_address );
+        *result.out = '\0';
+        G_LOG->write_log( i_log::P_WARNING );
+        res = 1;
+        return C_STEP_END;
+        }
+
+    if ( buff[ 7 ] != fun_code ||
+        ( read_count && buff[ 8 ] != read_count * 2 ) )
+        {
+        if ( read_count )
+            {
+            if ( !nd->flag_error_read_message )
+                {
+                add_err_to_log( "Read/write registers", nd->name,
+                    nd->ip_address, static_cast<int>( buff[ 7 ] ), fun_code,
+                    static_cast<int>( buff[ 8 ] ), read_count * 2 );
+                nd->flag_error_read_message = true;
+                }
+            nd->read_io_error_flag = true;
+            }
+        else if ( !nd->flag_error_write_message )
+            {
+            // Только запись выходов (0x10).
+            add_err_to_log( "Write AO", nd->name, nd->ip_address,
+                static_cast<int>( buff[ 7 ] ), fun_code,
+                static_cast<int>( buff[ 8 ] ), write_count );
+            nd->flag_error_write_message = true;
+            }
+        res = 1;
+        return C_STEP_END;
+        }
+
+    if ( write_count )
+        {
+        apply_phoenix_outputs( nd, write_start, write_count );
+        nd->flag_error_write_message = false;
+        }
+
+    if ( read_count )
+        {
+        const u_int INPUTS_SHIFT = PHOENIX_INPUTREGISTERS_STARTADDRESS -
+            PHOENIX_STATUS_REGISTER_ADDRESS;
+        for ( u_int i = 0; i < read_count; i++ )
+            {
+            u_int idx = read_start + i;
+            if ( 0 == idx )
+                {
+                resultbuff = &buff[ 9 ];
+                update_phoenix_status_register( nd );
+                }
+            else if ( idx >= INPUTS_SHIFT )
+                {
+                set_phoenix_input_register( nd, idx - INPUTS_SHIFT,
+                    &buff[ 9 + i * 2 ] );
+                }
+            }
+        nd->read_io_error_flag = false;
+        nd->flag_error_read_message = false;
+        }
+
+    return step + 1;
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::exchange( io_node* nd, bool is_read )
+    {
+    auto res = 0;
+    u_int step = 0;
+    auto bytes_to_send = 0;
+    auto bytes_to_receive = 0;
+
+    while ( make_request( nd, is_read, step, bytes_to_send, bytes_to_receive ) )
+        {
+        auto comm_res = e_communicate( nd, bytes_to_send, bytes_to_receive );
+        step = process_response( nd, is_read, step, comm_res, res );
+        }
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::is_answer_complete( const pipeline_state& st )
+    {
+    // Заголовок Modbus TCP (MBAP): байты 4-5 - длина оставшейся части.
+    const int MBAP_LENGTH_SIZE = 6;
+    if ( st.rcv_count < MBAP_LENGTH_SIZE )
+        {
+        return false;
+        }
+
+    int answer_size = MBAP_LENGTH_SIZE +
+        BYTE_SHIFT_MULTIPLIER * st.rcv_buff[ 4 ] + st.rcv_buff[ 5 ];
+    return st.rcv_count >= std::min<int>( answer_size, BUFF_SIZE );
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::send_pipeline_request( io_node* nd, pipeline_state& st,
+    bool is_read, int& res )
+    {
+    auto bytes_to_send = 0;
+    auto bytes_to_receive = 0;
+
+    while ( make_request( nd, is_read, st.step, bytes_to_send, bytes_to_receive ) )
+        {
+        auto comm_res = check_connection( nd );
+        if ( 0 == comm_res )
+            {
+            comm_res = send_request( nd, bytes_to_send );
+            }
+
+        if ( 0 == comm_res )
+            {
+            st.is_waiting = true;
+            st.rcv_count = 0;
+            st.send_time = get_millisec();
+            st.send_time_us = get_microsec();
+            return true;
+            }
+
+        st.step = process_response( nd, is_read, st.step, comm_res, res );
+        }
+
+    return false;
+    }
+//-----------------------------------------------------------------------------
+int uni_io_manager::pipelined_exchange( io_node* const* nds, u_int cnt,
+    bool is_read )
+    {
+    if ( pipeline.size() != cnt )
+        {
+        pipeline.resize( cnt );
+        }
+
+    auto res = 0;
+    u_int waiting_cnt = 0;
+
+    for ( u_int i = 0; i < cnt; i++ )
+        {
+        io_node* nd = nds[ i ];
+        auto& st = pipeline[ i ];
+        st.is_waiting = false;
+        st.step = 0;
+
+        if ( ( nd->type != io_node::WAGO_750_XXX_ETHERNET &&
+            nd->type != io_node::PHOENIX_BK_ETH ) || !nd->is_active )
+            {
+            continue;
+            }
+
+        if ( is_combined_exchange( nd ) )
+            {
+            // Входы узла читаются вместе с записью выходов.
+            if ( is_read ) continue;
+            }
+        else if ( !is_read && nd->read_io_error_flag )
+            {
+            res = 1;
+            continue;
+            }
+
+        if ( is_read && !check_poll_time( nd ) )
+            {
+            continue;
+            }
+
+        if ( send_pipeline_request( nd, st, is_read, res ) )
+            {
+            waiting_cnt++;
+            }
+        }
+
+    const uint32_t RCV_TIMEOUT_MS = io_node::C_RCV_TIMEOUT_SEC * MSEC_IN_SEC +
+        io_node::C_RCV_TIMEOUT_US / 1000;
+
+    while ( waiting_cnt > 0 )
+        {
+        // Ждем ответа хотя бы одного узла, но не дольше, чем до истечения
+        // ближайшего времени ожидания ответа.
+        fd_set rfds;
+        FD_ZERO( &rfds );
+        int max_sock = 0;
+        uint32_t wait_time = RCV_TIMEOUT_MS;
+        for ( u_int i = 0; i < cnt; i++ )
+            {
+            if ( !pipeline[ i ].is_waiting ) continue;
+
+            FD_SET( nds[ i ]->sock, &rfds );
+            max_sock = std::max( max_sock, nds[ i ]->sock );
+
+            auto dt = get_delta_millisec( pipeline[ i ].send_time );
+            wait_time = std::min( wait_time,
+                dt < RCV_TIMEOUT_MS ? RCV_TIMEOUT_MS - dt : 0 );
+            }
+
+        timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = static_cast<long>( wait_time * 1000 );
+        int n = select( max_sock + 1, &rfds, nullptr, nullptr, &tv );
+
+        for ( u_int i = 0; i < cnt; i++ )
+            {
+            auto& st = pipeline[ i ];
+            if ( !st.is_waiting ) continue;
+
+            io_node* nd = nds[ i ];
+            int comm_res = 1;
+
+            if ( n > 0 && FD_ISSET( nd->sock, &rfds ) )
+                {
+                auto res = recv( nd->sock,
+                    reinterpret_cast<char*>( st.rcv_buff + st.rcv_count ),
+                    BUFF_SIZE - st.rcv_count, 0 );
+                if ( res <= 0 )
+                    {
+                    G_LOG->error(
+                        R"(Network device : s%d->"%s":"%s")"
+                        " disconnected on read try : %s",
+                        nd->sock, nd->name, nd->ip_address,
+                        0 == res ? "closed" :
+#ifdef WIN_OS
+                        WSA_Last_Err_Decode()
+#else
+                        strerror( errno )
+#endif // WIN_OS
+                    );
+                    comm_res = -102;
+                    }
+                else
+                    {
+                    st.rcv_count += static_cast<int>( res );
+                    if ( is_answer_complete( st ) )
                         {
-                        registers_count = MAX_MODBUS_REGISTERS_PER_QUERY;
+                        comm_res = 0;
                         }
-                    nd->read_io_error_flag = false;
-                    nd->flag_error_read_message = false;
-                    } while (start_register < nd->AI_cnt);
-                } // if (nd->AI_cnt > 0)
+                    }
+                }
+
+            if ( 1 == comm_res &&
+                get_delta_millisec( st.send_time ) >= RCV_TIMEOUT_MS )
+                {
+                G_LOG->error(
+                    R"(Network device : s%d->"%s":"%s")"
+                    " disconnected on select read try : timeout (%u ms).",
+                    nd->sock, nd->name, nd->ip_address, RCV_TIMEOUT_MS );
+                comm_res = -102;
+                }
+
+            if ( 1 == comm_res ) continue; // Ответ еще не получен.
+
+            // Обмен по данному шагу завершен.
+            st.is_waiting = false;
+            waiting_cnt--;
+
+            auto time = get_delta_millisec( st.send_time );
+            nd->recv_stat.cycles_cnt++;
+            nd->recv_stat.all_time += time;
+            nd->recv_stat.max_iteration_cycle_time =
+                std::max( nd->recv_stat.max_iteration_cycle_time, time );
+            nd->recv_stat.min_iteration_cycle_time =
+                std::min( nd->recv_stat.min_iteration_cycle_time, time );
+            nd->recv_hist.add( static_cast<uint32_t>(
+                get_microsec() - st.send_time_us ) );
 
-            // Read Status Register (7996) for PP mode detection.
-            read_phoenix_status_register( nd );
-            }// nd->type == io_node::PHOENIX_BK_ETH
-        }// for ( u_int i = 0; i < nodes_count; i++ )
+            if ( 0 == comm_res )
+                {
+                memcpy( buff, st.rcv_buff, st.rcv_count );
+                nd->last_poll_time = get_millisec();
+                }
+            else
+                {
+                disconnect( nd );
+                }
+
+            st.step = process_response( nd, is_read, st.step, comm_res, res );
+            if ( send_pipeline_request( nd, st, is_read, res ) )
+                {
+                waiting_cnt++;
+                }
+            }
+        }
 
     return res;
     }
 //-----------------------------------------------------------------------------
+int uni_io_manager::read_inputs()
+    {
+    if ( 0 == nodes_count )
+        {
+        return 0;
+        }
+
+    if ( check_io_thread() )
+        {
+        std::vector< node_alarm > alarms;
+        std::unique_lock<std::mutex> lock( io_mutex );
+        for ( u_int i = 0; i < nodes_count; i++ )
+            {
+            copy_inputs( shared_nodes[ i ], nodes[ i ] );
+            }
+        alarms.swap( pending_alarms );
+        auto res = io_thread_read_res;
+        lock.unlock();
+
+        for ( const auto& alarm : alarms )
+            {
+            set_node_alarm( alarm.eclass, alarm.number, alarm.is_set,
+                alarm.is_print_msg );
+            }
+
+        return res;
+        }
+
+    return exchange_nodes( nodes, nodes_count, true );
+    }
+//-----------------------------------------------------------------------------
 void uni_io_manager::read_phoenix_status_register( io_node* nd )
     {
     if ( auto result = read_input_registers( nd,
         PHOENIX_STATUS_REGISTER_ADDRESS, 1 ); result > 0 )
         {
-        nd->status_register = static_cast<u_int_2>(
-            BYTE_SHIFT_MULTIPLIER * resultbuff[ 0 ] + resultbuff[ 1 ] );
-        }
-    else
-        {
-        return;
+        update_phoenix_status_register( nd );
         }
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::update_phoenix_status_register( io_node* nd )
+    {
+    nd->status_register = static_cast<u_int_2>(
+        BYTE_SHIFT_MULTIPLIER * resultbuff[ 0 ] + resultbuff[ 1 ] );
 
     // Check for PP mode state changes.
     // PP mode has become active.
@@ -1006,9 +1735,8 @@ void uni_io_manager::read_phoenix_status_register( io_node* nd )
         if ( !nd->is_err_mode_alarm_set )
             {
             nd->is_err_mode_alarm_set = true;
-            PAC_critical_errors_manager::get_instance()->set_global_error(
-                PAC_critical_errors_manager::AC_PP_MODE,
-                PAC_critical_errors_manager::AS_IO_COUPLER, nd->number );
+            set_node_alarm( PAC_critical_errors_manager::AC_PP_MODE,
+                nd->number, true );
             }
         }
     // PP mode has become inactive.
@@ -1016,14 +1744,225 @@ void uni_io_manager::read_phoenix_status_register( io_node* nd )
         nd->is_err_mode_alarm_set )
         {
         nd->is_err_mode_alarm_set = false;
-        PAC_critical_errors_manager::get_instance()->reset_global_error(
-            PAC_critical_errors_manager::AC_PP_MODE,
-            PAC_critical_errors_manager::AS_IO_COUPLER, nd->number );
+        set_node_alarm( PAC_critical_errors_manager::AC_PP_MODE,
+            nd->number, false );
         }
 
     nd->prev_status_register = nd->status_register;
     }
 //-----------------------------------------------------------------------------
+void uni_io_manager::set_node_alarm(
+    PAC_critical_errors_manager::ALARM_CLASS eclass, u_int number,
+    bool is_set, bool is_print_msg )
+    {
+    if ( is_io_thread )
+        {
+        std::lock_guard<std::mutex> lock( io_mutex );
+        pending_alarms.push_back( { eclass, number, is_set, is_print_msg } );
+        return;
+        }
+
+    if ( is_set )
+        {
+        PAC_critical_errors_manager::get_instance()->set_global_error(
+            eclass, PAC_critical_errors_manager::AS_IO_COUPLER, number );
+        }
+    else
+        {
+        PAC_critical_errors_manager::get_instance()->reset_global_error(
+            eclass, PAC_critical_errors_manager::AS_IO_COUPLER, number,
+            is_print_msg );
+        }
+    }
+//-----------------------------------------------------------------------------
+bool uni_io_manager::check_io_thread()
+    {
+    bool is_on = G_PAC_INFO()->par[ PAC_info::P_IO_THREAD ] != 0;
+
+    // Изменилась конфигурация узлов - поток перезапускается.
+    if ( io_thread.joinable() &&
+        ( !is_on || shared_nodes.size() != nodes_count ) )
+        {
+        stop_io_thread();
+        }
+
+    if ( is_on && !io_thread.joinable() )
+        {
+        start_io_thread();
+        }
+
+    return is_on;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::start_io_thread()
+    {
+    for ( u_int i = 0; i < nodes_count; i++ )
+        {
+        // Соединения управляющего потока закрываются, поток обмена
+        // устанавливает собственные.
+        disconnect( nodes[ i ] );
+        io_nodes.push_back( clone_node( nodes[ i ] ) );
+        shared_nodes.push_back( clone_node( nodes[ i ] ) );
+        }
+
+    is_io_thread_running = true;
+    is_outputs_updated = false;
+    io_thread_read_res = 0;
+    io_thread_write_res = 0;
+    io_thread = std::thread( &uni_io_manager::io_thread_main, this );
+
+    G_LOG->info( "I/O exchange thread started (%u nodes).", nodes_count );
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::stop_io_thread()
+    {
+    if ( !io_thread.joinable() )
+        {
+        return;
+        }
+
+        {
+        std::lock_guard<std::mutex> lock( io_mutex );
+        is_io_thread_running = false;
+        }
+    io_cv.notify_one();
+    io_thread.join();
+
+    for ( auto nd : io_nodes ) delete nd;
+    for ( auto nd : shared_nodes ) delete nd;
+    io_nodes.clear();
+    shared_nodes.clear();
+
+    std::vector< node_alarm > alarms;
+    alarms.swap( pending_alarms );
+    for ( const auto& alarm : alarms )
+        {
+        set_node_alarm( alarm.eclass, alarm.number, alarm.is_set,
+            alarm.is_print_msg );
+        }
+
+    // Соединения будут установлены заново управляющим потоком.
+    for ( u_int i = 0; i < nodes_count; i++ )
+        {
+        nodes[ i ]->state = io_node::ST_NO_CONNECT;
+        }
+
+    G_LOG->info( "I/O exchange thread stopped." );
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::io_thread_main()
+    {
+    is_io_thread = true;
+    log_mngr::init_thread_log();
+
+    std::unique_lock<std::mutex> lock( io_mutex );
+    while ( is_io_thread_running )
+        {
+        io_cv.wait_for( lock,
+            std::chrono::milliseconds( C_IO_THREAD_MAX_WAIT_MS ),
+            [ this ]() { return is_outputs_updated || !is_io_thread_running; } );
+        if ( !is_io_thread_running )
+            {
+            break;
+            }
+
+        is_outputs_updated = false;
+        for ( u_int i = 0; i < io_nodes.size(); i++ )
+            {
+            copy_outputs( shared_nodes[ i ], io_nodes[ i ] );
+            }
+        lock.unlock();
+
+        for ( auto nd : io_nodes )
+            {
+            // Узел отключен (например, для обслуживания).
+            if ( !nd->is_active && nd->state == io_node::ST_OK )
+                {
+                disconnect( nd );
+                }
+            }
+
+        auto write_res = exchange_nodes( io_nodes.data(),
+            static_cast<u_int>( io_nodes.size() ), false );
+        auto read_res = exchange_nodes( io_nodes.data(),
+            static_cast<u_int>( io_nodes.size() ), true );
+
+        lock.lock();
+        for ( u_int i = 0; i < io_nodes.size(); i++ )
+            {
+            copy_inputs( io_nodes[ i ], shared_nodes[ i ] );
+            }
+        io_thread_write_res = write_res;
+        io_thread_read_res = read_res;
+        }
+    lock.unlock();
+
+    for ( auto nd : io_nodes )
+        {
+        disconnect( nd );
+        }
+
+    log_mngr::free_thread_log();
+    is_io_thread = false;
+    }
+//-----------------------------------------------------------------------------
+io_manager::io_node* uni_io_manager::clone_node( const io_node* nd )
+    {
+    auto res = new io_node( nd->type, nd->number, nd->ip_address, nd->name,
+        nd->DO_cnt, nd->DI_cnt, nd->AO_cnt, nd->AO_size, nd->AI_cnt,
+        nd->AI_size );
+
+    if ( nd->AO_cnt )
+        {
+        std::copy( nd->AO_types, nd->AO_types + nd->AO_cnt, res->AO_types );
+        std::copy( nd->AO_offsets, nd->AO_offsets + nd->AO_cnt,
+            res->AO_offsets );
+        }
+    if ( nd->AI_cnt )
+        {
+        std::copy( nd->AI_types, nd->AI_types + nd->AI_cnt, res->AI_types );
+        std::copy( nd->AI_offsets, nd->AI_offsets + nd->AI_cnt,
+            res->AI_offsets );
+        }
+
+    copy_outputs( nd, res );
+    copy_inputs( nd, res );
+    res->state = io_node::ST_NO_CONNECT;
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::copy_inputs( const io_node* src, io_node* dst )
+    {
+    if ( src->DI_cnt ) memcpy( dst->DI, src->DI, src->DI_cnt );
+    if ( src->DO_cnt ) memcpy( dst->DO, src->DO, src->DO_cnt );
+    memcpy( dst->AI, src->AI, sizeof( dst->AI ) );
+    memcpy( dst->AO, src->AO, sizeof( dst->AO ) );
+
+    dst->state = src->state;
+    dst->read_io_error_flag = src->read_io_error_flag;
+    dst->last_poll_time = src->last_poll_time;
+    dst->is_set_err = src->is_set_err;
+    dst->status_register = src->status_register;
+    dst->prev_status_register = src->prev_status_register;
+    dst->is_err_mode_alarm_set = src->is_err_mode_alarm_set;
+    dst->connect_hist = src->connect_hist;
+    dst->send_hist = src->send_hist;
+    dst->recv_hist = src->recv_hist;
+    dst->stat_reset_done = src->stat_reset_done;
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::copy_outputs( const io_node* src, io_node* dst )
+    {
+    if ( src->DO_cnt ) memcpy( dst->DO_, src->DO_, src->DO_cnt );
+    memcpy( dst->AO_, src->AO_, sizeof( dst->AO_ ) );
+
+    dst->is_active = src->is_active;
+    dst->poll_period = src->poll_period;
+    dst->poll_phase = src->poll_phase;
+    dst->stat_reset_request = src->stat_reset_request;
+    }
+//-----------------------------------------------------------------------------
 void uni_io_manager::disconnect( io_node* node )
     {
     if ( node->sock )
@@ -1045,6 +1984,9 @@ void uni_io_manager::disconnect( io_node* node )
         node->sock = 0;
         }
     node->state = io_node::ST_NO_CONNECT;
+
+    // После переподключения записываются все выходы.
+    node->is_outputs_refresh_forced = true;
     }
 //-----------------------------------------------------------------------------
 uni_io_manager::uni_io_manager()
@@ -1053,3 +1995,13 @@ uni_io_manager::uni_io_manager()
     resultbuff = &buff[ 9 ];
     }
 //-----------------------------------------------------------------------------
+uni_io_manager::~uni_io_manager()
+    {
+    stop_io_thread();
+    }
+//-----------------------------------------------------------------------------
+void uni_io_manager::set_port( u_int new_port )
+    {
+    port = new_port;
+    }
+//-----------------------------------------------------------------------------
@@ -23,6 +23,11 @@
 #include "l_tcp_cmctr.h"
 #endif // WIN_OS
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "bus_coupler_io.h"
 #include "dtime.h"
 #include "PAC_err.h"
@@ -41,13 +46,20 @@ class uni_io_manager : public io_manager
         enum CONSTANTS
             {
             MAX_MODBUS_REGISTERS_PER_QUERY = 123,
+            MAX_MODBUS_RW_WRITE_REGISTERS = 121, ///< Запись функцией 0x17.
             BUFF_SIZE = 262,
             PHOENIX_INPUTREGISTERS_STARTADDRESS = 8000,
             PHOENIX_HOLDINGREGISTERS_STARTADDRESS = 9000,
             PHOENIX_STATUS_REGISTER_ADDRESS = 7996,
             BYTE_SHIFT_MULTIPLIER = 256,
+
+            MODBUS_PORT = 502,
+            C_CONNECT_IN_PROGRESS = 8, ///< Подключение еще не завершено.
+            C_STEP_END = 0xFFFF,       ///< Завершение шагов обмена с узлом.
             };
 
+        u_int port = MODBUS_PORT; ///< Порт Modbus TCP узлов.
+
         u_char buff[ BUFF_SIZE ] = { 0 };
         u_char* resultbuff = nullptr;
         u_char* writebuff = nullptr;
@@ -86,13 +98,317 @@ class uni_io_manager : public io_manager
         /// @param nd - node to read status register from.
         void read_phoenix_status_register( io_node* nd );
 
+        /// @brief Update status register for Phoenix BK ETH nodes from
+        /// the received answer (PP mode alarm handling).
+        ///
+        /// @param nd - node to update status register.
+        void update_phoenix_status_register( io_node* nd );
+
+        /// @brief Проверка связи с узлом I/O и подключение к нему при
+        /// необходимости.
+        ///
+        /// @param node - узел I/O.
+        ///
+        /// @return -   0 - узел готов к обмену.
+        /// @return -   1 - не истекло время до повторного подключения.
+        /// @return - < 0 - ошибка подключения.
+        int check_connection( io_node* node );
+
+        /// @brief Начало асинхронного подключения к узлам, для которых
+        /// истекло время до повторного подключения.
+        ///
+        /// Подключение ко всем узлам выполняется одновременно, его
+        /// завершение проверяется при обмене с узлом (@ref check_connection).
+        void start_connections( io_node* const* nds, u_int cnt );
+
+        /// @brief Признак истечения времени до повторного подключения.
+        static bool is_reconnect_time( const io_node* node );
+
+        /// @brief Обработка ошибки подключения - увеличение времени до
+        /// повторного подключения.
+        static void set_connect_error( io_node* node );
+
+        /// @brief Отсылка узлу I/O запроса из буфера обмена.
+        ///
+        /// @param node          - узел I/O.
+        /// @param bytes_to_send - размер запроса.
+        ///
+        /// @return -   0 - ок.
+        /// @return - < 0 - ошибка, соединение разорвано.
+        int send_request( io_node* node, int bytes_to_send );
+
+        /// @brief Формирование в буфере обмена запроса Modbus чтения
+        /// входных регистров (функция 0x04).
+        void make_read_input_registers_request( unsigned int address,
+            unsigned int quantity, unsigned char station = 0 );
+
+        /// @brief Формирование в буфере обмена заголовка запроса Modbus
+        /// записи регистров (функция 0x10), данные - в @ref writebuff.
+        void make_write_holding_registers_request( unsigned int address,
+            unsigned int quantity, unsigned char station = 0 );
+
+        /// @brief Шаги (транзакции) обмена с узлом WAGO.
+        enum WAGO_STEPS
+            {
+            WAGO_STEP_DISCRETE = 0, ///< Чтение DI/запись DO.
+            WAGO_STEP_ANALOG,       ///< Чтение AI/запись AO.
+
+            WAGO_STEP_END,
+            };
+
+        /// @brief Формирование в буфере обмена запроса очередного шага
+        /// (транзакции) обмена с узлом.
+        ///
+        /// Шаги без данных (например, чтение DI при их отсутствии)
+        /// пропускаются, при этом @a step увеличивается.
+        ///
+        /// @param nd               - узел I/O.
+        /// @param is_read          - чтение входов (true)/запись выходов.
+        /// @param step             - номер шага.
+        /// @param bytes_to_send    - размер запроса.
+        /// @param bytes_to_receive - ожидаемый размер ответа.
+        ///
+        /// @return - true - запрос сформирован, false - шагов больше нет.
+        bool make_request( io_node* nd, bool is_read, u_int& step,
+            int& bytes_to_send, int& bytes_to_receive );
+
+        /// @brief Обработка ответа узла на запрос шага обмена (ответ
+        /// находится в буфере обмена).
+        ///
+        /// @param nd       - узел I/O.
+        /// @param is_read  - чтение входов (true)/запись выходов.
+        /// @param step     - номер шага.
+        /// @param comm_res - результат обмена (см. @ref e_communicate).
+        /// @param res      - общий результат обмена, при ошибке равен 1.
+        ///
+        /// @return - номер следующего шага.
+        u_int process_response( io_node* nd, bool is_read, u_int step,
+            int comm_res, int& res );
+
+        bool make_read_request( io_node* nd, u_int& step,
+            int& bytes_to_send, int& bytes_to_receive );
+        u_int process_read_response( io_node* nd, u_int step, int comm_res,
+            int& res );
+
+        bool make_write_request( io_node* nd, u_int& step,
+            int& bytes_to_send, int& bytes_to_receive );
+        u_int process_write_response( io_node* nd, u_int step, int comm_res,
+            int& res );
+
+        /// @brief Определение необходимости записи всех выходов узла в
+        /// текущем цикле обмена (см. @ref PAC_info::P_IO_OUTPUTS_REFRESH_TIME).
+        static void update_outputs_refresh( io_node* nd );
+
+        /// @brief Признак необходимости записи выходов шага обмена -
+        /// значения для записи отличаются от текущих или требуется запись
+        /// всех выходов.
+        static bool is_write_needed( const io_node* nd, u_int step );
+
+        /// @brief Признак необходимости записи выходных регистров узла
+        /// Phoenix (см. @ref is_write_needed).
+        static bool is_phoenix_write_needed( const io_node* nd,
+            u_int start_register, u_int registers_count );
+
+        /// @brief Формирование данных выходных регистров узла Phoenix.
+        ///
+        /// @param nd             - узел I/O.
+        /// @param start_register - первый регистр.
+        /// @param registers_count - количество регистров.
+        /// @param dst            - буфер для данных регистров.
+        static void fill_phoenix_outputs( const io_node* nd,
+            u_int start_register, u_int registers_count, u_char* dst );
+
+        /// @brief Сохранение записанных значений выходных регистров узла
+        /// Phoenix как текущих.
+        static void apply_phoenix_outputs( io_node* nd, u_int start_register,
+            u_int registers_count );
+
+        /// @brief Установка значений AI и DI узла Phoenix по значению
+        /// входного регистра.
+        ///
+        /// @param nd  - узел I/O.
+        /// @param idx - номер входного регистра.
+        /// @param src - значение регистра (2 байта).
+        static void set_phoenix_input_register( io_node* nd, u_int idx,
+            const u_char* src );
+
+        /// @brief Признак совмещенного обмена с узлом - чтение входов и
+        /// запись выходов одной транзакцией Modbus (функция 0x17, см.
+        /// @ref PAC_info::P_IO_COMBINED_EXCHANGE).
+        ///
+        /// Совмещенный обмен выполняется при записи выходов, регистр
+        /// статуса читается в той же транзакции. Если узел не поддерживает
+        /// функцию 0x17, обмен с ним выполняется отдельными транзакциями.
+        static bool is_combined_exchange( const io_node* nd );
+
+        /// @brief Регистры шага совмещенного обмена.
+        ///
+        /// Чтение выполняется начиная с регистра статуса
+        /// (@ref PHOENIX_STATUS_REGISTER_ADDRESS). Нулевое количество -
+        /// чтение (запись) на шаге не выполняется.
+        static void get_combined_step( const io_node* nd, u_int step,
+            u_int& read_start, u_int& read_count, u_int& write_start,
+            u_int& write_count );
+
+        bool make_combined_request( io_node* nd, u_int& step,
+            int& bytes_to_send, int& bytes_to_receive );
+        u_int process_combined_response( io_node* nd, u_int step,
+            int comm_res, int& res );
+
+        /// @brief Количество запросов для передачи заданного количества
+        /// регистров с учетом @ref MAX_MODBUS_REGISTERS_PER_QUERY.
+        static u_int get_queries_count( u_int registers_count );
+
+        /// @brief Последовательный (шаг за шагом) обмен с узлом.
+        ///
+        /// @param nd      - узел I/O.
+        /// @param is_read - чтение входов (true)/запись выходов.
+        ///
+        /// @return - 0 - ок, 1 - ошибка.
+        int exchange( io_node* nd, bool is_read );
+
+        /// @brief Состояние конвейерного обмена с узлом.
+        struct pipeline_state
+            {
+            u_int step = 0;           ///< Текущий шаг обмена.
+            bool is_waiting = false;  ///< Ожидается ответ узла.
+            int rcv_count = 0;        ///< Количество полученных байт ответа.
+            uint32_t send_time = 0;   ///< Время отсылки запроса, мсек.
+            uint64_t send_time_us = 0;///< Время отсылки запроса, мкс.
+            u_char rcv_buff[ BUFF_SIZE ] = { 0 }; ///< Буфер ответа.
+            };
+
+        std::vector< pipeline_state > pipeline; ///< Состояние обмена с узлами.
+
+        /// @brief Обмен со всеми узлами (последовательный или конвейерный,
+        /// в зависимости от параметра @ref PAC_info::P_IO_PIPELINED_EXCHANGE).
+        ///
+        /// @param nds     - узлы I/O.
+        /// @param cnt     - количество узлов.
+        /// @param is_read - чтение входов (true)/запись выходов.
+        ///
+        /// @return - 0 - ок, 1 - ошибка.
+        int exchange_nodes( io_node* const* nds, u_int cnt, bool is_read );
+
+        /// @brief Последовательный обмен со всеми узлами.
+        ///
+        /// @param nds     - узлы I/O.
+        /// @param cnt     - количество узлов.
+        /// @param is_read - чтение входов (true)/запись выходов.
+        ///
+        /// @return - 0 - ок, 1 - ошибка.
+        int serial_exchange( io_node* const* nds, u_int cnt, bool is_read );
+
+        u_int poll_cycle = 0; ///< Номер цикла опроса (чтения входов) узлов.
+
+        /// @brief Проверка необходимости опроса узла в текущем цикле (с
+        /// учетом периода опроса узла).
+        ///
+        /// @return - true - узел необходимо опросить.
+        bool check_poll_time( io_node* node );
+
+        /// @brief Конвейерный обмен со всеми узлами.
+        ///
+        /// Сначала всем активным узлам отсылаются запросы, затем по мере
+        /// готовности сокетов принимаются ответы и сразу отсылаются
+        /// запросы следующих шагов. Таким образом время обмена определяется
+        /// самым медленным узлом, а не суммой времени обмена с каждым из них.
+        ///
+        /// @param nds     - узлы I/O.
+        /// @param cnt     - количество узлов.
+        /// @param is_read - чтение входов (true)/запись выходов.
+        ///
+        /// @return - 0 - ок, 1 - ошибка.
+        int pipelined_exchange( io_node* const* nds, u_int cnt,
+            bool is_read );
+
+        /// @brief Отсылка запроса очередного шага конвейерного обмена.
+        ///
+        /// Шаги, для которых отсылка невозможна (нет связи с узлом),
+        /// обрабатываются сразу как неуспешные.
+        ///
+        /// @return - true - запрос отослан, ожидается ответ.
+        bool send_pipeline_request( io_node* nd, pipeline_state& st,
+            bool is_read, int& res );
+
+        /// @brief Признак получения полного ответа Modbus TCP.
+        static bool is_answer_complete( const pipeline_state& st );
+
+        /// @brief Установка/сброс ошибки узла.
+        ///
+        /// В потоке обмена ошибки накапливаются и передаются менеджеру
+        /// ошибок в управляющем потоке (при чтении входов).
+        void set_node_alarm( PAC_critical_errors_manager::ALARM_CLASS eclass,
+            u_int number, bool is_set, bool is_print_msg = true );
+
+        /// @brief Отложенная установка/сброс ошибки узла.
+        struct node_alarm
+            {
+            PAC_critical_errors_manager::ALARM_CLASS eclass;
+            u_int number;
+            bool is_set;
+            bool is_print_msg;
+            };
+
+        enum IO_THREAD_CONSTANTS
+            {
+            ///< Максимальное время ожидания новых значений выходов потоком
+            ///< обмена, мсек. По его истечении выполняется обмен с прежними
+            ///< значениями (для контроля связи и обновления входов).
+            C_IO_THREAD_MAX_WAIT_MS = 50,
+            };
+
+        /// @brief Поток обмена с узлами I/O.
+        ///
+        /// Поток работает с собственными копиями узлов (@ref io_nodes).
+        /// Значения входов/выходов передаются между потоками через
+        /// промежуточные копии узлов (@ref shared_nodes), доступ к которым
+        /// защищен @ref io_mutex. Таким образом медленный или
+        /// переподключаемый узел не увеличивает время управляющего цикла,
+        /// а устройства продолжают работать с данными узлов @ref nodes.
+        std::thread io_thread;
+        std::mutex io_mutex;
+        std::condition_variable io_cv;
+
+        // Данные ниже защищены io_mutex.
+        bool is_io_thread_running = false;
+        bool is_outputs_updated = false;     ///< Есть новые значения выходов.
+        int io_thread_read_res = 0;          ///< Результат чтения входов.
+        int io_thread_write_res = 0;         ///< Результат записи выходов.
+        std::vector< io_node* > shared_nodes;
+        std::vector< node_alarm > pending_alarms;
+
+        std::vector< io_node* > io_nodes;    ///< Узлы потока обмена.
+
+        /// Признак выполнения в потоке обмена.
+        inline static thread_local bool is_io_thread = false;
+
+        /// @brief Запуск/останов потока обмена в соответствии с параметром
+        /// @ref PAC_info::P_IO_THREAD.
+        ///
+        /// @return - true - обмен выполняется потоком обмена.
+        bool check_io_thread();
+
+        void start_io_thread();
+        void stop_io_thread();
+        void io_thread_main();
+
+        /// @brief Создание копии узла (без сетевого соединения).
+        static io_node* clone_node( const io_node* nd );
+
+        /// @brief Копирование считанных значений и состояния узла.
+        static void copy_inputs( const io_node* src, io_node* dst );
+
+        /// @brief Копирование значений выходов для записи.
+        static void copy_outputs( const io_node* src, io_node* dst );
+
     public:
         int read_inputs() override;
         int write_outputs() override;
 
         uni_io_manager();
 
-        ~uni_io_manager() override = default;
+        ~uni_io_manager() override;
 
         /// @brief Данный класс является некопируемым и неперемещаемым.
         uni_io_manager( const uni_io_manager& ) = delete;
@@ -107,10 +423,35 @@ class uni_io_manager : public io_manager
         /// @return - < 0 - ошибка.
         int net_init( io_node* node ) const;
 
+        /// @brief Начало асинхронного (неблокирующего) подключения к узлу.
+        ///
+        /// @param node - узел I/O.
+        ///
+        /// @return -   0 - подключение начато (состояние узла
+        /// @ref io_node::ST_CONNECTING).
+        /// @return - > 0 - ошибка.
+        int net_init_start( io_node* node ) const;
+
+        /// @brief Проверка завершения подключения к узлу.
+        ///
+        /// @param node    - узел I/O.
+        /// @param is_wait - ожидать завершения подключения (не более
+        /// @ref io_node::C_CNT_TIMEOUT_US).
+        ///
+        /// @return - 0 - ок.
+        /// @return - @ref C_CONNECT_IN_PROGRESS - подключение не завершено.
+        /// @return - другое значение - ошибка, сокет закрыт.
+        int net_init_check( io_node* node, bool is_wait ) const;
+
         /// @brief Отключение от узла.
         ///
         /// @param node - узел, от которого отключаемся.
         void disconnect( io_node* node ) override;
+
+        /// @brief Установка порта Modbus TCP узлов (по умолчанию -
+        /// @ref MODBUS_PORT, другой порт используется, например, для
+        /// работы с симулятором узлов).
+        void set_port( u_int new_port );
     };
 //-----------------------------------------------------------------------------
 #endif // UNI_BUS_COUPLER_IO_H
@@ -1,14 +1,21 @@
 #include <netdb.h>
 #include <time.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <errno.h>
 #include <inttypes.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include "l_tcp_cmctr.h"
 #include "PAC_err.h"
+#include "PAC_info.h"
 #include "tcp_client.h"
 
 #include "log.h"
@@ -20,10 +27,6 @@ tcp_communicator_linux::tcp_communicator_linux( const char *name_rus,
     const char *name_eng ):tcp_communicator(),
     sst(), netOK( 0 )
     {
-    // Задаем таймаут.
-    tv.tv_sec  = 0;
-    tv.tv_usec = 1000;
-
     sin_len = sizeof( ssin );
     strncpy( host_name_rus, name_rus, TC_MAX_HOST_NAME );
     strncpy( host_name_eng, name_eng, TC_MAX_HOST_NAME );
@@ -39,8 +42,6 @@ tcp_communicator_linux::tcp_communicator_linux( const char *name_rus,
 //------------------------------------------------------------------------------
 void tcp_communicator_linux::killsockets()
     {
-    FD_ZERO( &rfds ); /* clear FD set */
-
     for ( u_int i = 0; i < sst.size(); i++ )
         {
         if ( sst[ i ].active )
@@ -50,12 +51,139 @@ void tcp_communicator_linux::killsockets()
             }
         }
     sst.clear();
+
+    for ( auto epoll : { &epoll_fd, &async_epoll_fd } )
+        {
+        if ( *epoll >= 0 )
+            {
+            close( *epoll );
+            *epoll = -1;
+            }
+        }
+    async_epoll_sockets.clear();
+
+    if ( answers_event_fd >= 0 )
+        {
+        close( answers_event_fd );
+        answers_event_fd = -1;
+        }
+
+        {
+        std::lock_guard<std::mutex> lock( comm_mutex );
+        requests.clear();
+        answers.clear();
+        }
+
+    std::lock_guard<std::mutex> lock( push_mutex );
+    push_data.clear();
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::remove_socket( int idx )
+    {
+    epoll_ctl( epoll_fd, EPOLL_CTL_DEL, sst[ idx ].socket, nullptr );
+    shutdown( sst[ idx ].socket, 0 );
+    close( sst[ idx ].socket );
+
+    if ( sst[ idx ].id )
+        {
+        std::lock_guard<std::mutex> lock( push_mutex );
+        push_data.erase( sst[ idx ].id );
+        }
+    sst.erase( sst.begin() + idx, sst.begin() + idx + 1 );
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::push( u_int connection_id, u_char srv_id,
+    const u_char* data, u_int size )
+    {
+    std::lock_guard<std::mutex> lock( push_mutex );
+    auto it = push_data.find( connection_id );
+    if ( it == push_data.end() )
+        {
+        return PUSH_NO_CONNECTION;
+        }
+
+    auto& frame = it->second;
+    if ( !frame.empty() )
+        {
+        return PUSH_BUSY;
+        }
+
+    const u_int HEADER_SIZE = 7;
+    frame.resize( HEADER_SIZE + size );
+    frame[ 0 ] = 's';
+    frame[ 1 ] = PUSH_DATA;
+    frame[ 2 ] = srv_id;
+    frame[ 3 ] = ( size >> 24 ) & 0xFF;
+    frame[ 4 ] = ( size >> 16 ) & 0xFF;
+    frame[ 5 ] = ( size >> 8 ) & 0xFF;
+    frame[ 6 ] = size & 0xFF;
+    memcpy( frame.data() + HEADER_SIZE, data, size );
+
+    return PUSH_OK;
+    }
+//------------------------------------------------------------------------------
+bool tcp_communicator_linux::is_push_busy( u_int connection_id ) const
+    {
+    std::lock_guard<std::mutex> lock( push_mutex );
+    auto it = push_data.find( connection_id );
+    return it != push_data.end() && !it->second.empty();
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::send_pushes()
+    {
+    std::vector< u_char > frame;
+    for ( u_int i = 0; i < sst.size(); i++ )
+        {
+        // Данные передаются после ответа на запрос - до этого новые данные
+        // не принимаются (PUSH_BUSY).
+        if ( !sst[ i ].id || !sst[ i ].out_queue.empty() ||
+            sst[ i ].is_service_waiting )
+            {
+            continue;
+            }
+
+            {
+            std::lock_guard<std::mutex> lock( push_mutex );
+            auto it = push_data.find( sst[ i ].id );
+            if ( it == push_data.end() || it->second.empty() )
+                {
+                continue;
+                }
+            frame.swap( it->second );
+            }
+
+        auto err = queue_send( i, frame.data(), frame.size() );
+        frame.clear();
+
+        if ( err < 0 )               /* write error */
+            {
+            remove_socket( i );
+            i--;
+            }
+        }
     }
 //------------------------------------------------------------------------------
 int tcp_communicator_linux::net_init()
     {
     errno = 0;
 
+    if ( epoll_fd < 0 )
+        {
+        epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+        }
+    if ( async_epoll_fd < 0 )
+        {
+        async_epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+        }
+    if ( epoll_fd < 0 || async_epoll_fd < 0 )
+        {
+        sprintf( G_LOG->msg,
+            "Network communication : epoll_create1 : %s.", strerror( errno ) );
+        G_LOG->write_log( i_log::P_ERR );
+
+        return -3;
+        }
+
     int type = SOCK_STREAM;
     int protocol = 0;        /* всегда 0 */
     int err = master_socket = socket( PF_INET, type, protocol ); // Cоздание мастер-сокета.
@@ -134,7 +262,7 @@ int tcp_communicator_linux::net_init()
             0 );
         }
 
-    err = listen( master_socket, QLEN ); // Делаем мастер-сокет слушателем.
+    err = listen( master_socket, C_LISTEN_QUEUE_LEN ); // Делаем мастер-сокет слушателем.
     if ( type == SOCK_STREAM && err < 0 )
         {
         PAC_critical_errors_manager::get_instance()->set_global_error(
@@ -186,6 +314,9 @@ int tcp_communicator_linux::net_init()
             1 );
         }
 
+    // Переводим в неблокирующий режим.
+    fcntl( modbus_socket, F_SETFL, O_NONBLOCK );
+
     // Адресация modbus_socket сокета.
     socket_state modbus_socket_state;
     memset( &modbus_socket_state.sin, 0, sizeof ( modbus_socket_state.sin ) );
@@ -215,7 +346,7 @@ int tcp_communicator_linux::net_init()
             1 );
         }
 
-    err = listen( modbus_socket, QLEN ); // Делаем слушателем.
+    err = listen( modbus_socket, C_LISTEN_QUEUE_LEN ); // Делаем слушателем.
     if ( type == SOCK_STREAM && err < 0 )
         {
         PAC_critical_errors_manager::get_instance()->set_global_error(
@@ -240,7 +371,28 @@ int tcp_communicator_linux::net_init()
 
     sst.push_back(modbus_socket_state);
 
-    FD_ZERO ( &rfds );
+    // Сокеты-слушатели - в режиме edge-triggered (подключения принимаются
+    // до EAGAIN).
+    for ( auto listener : { master_socket, modbus_socket } )
+        {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = listener;
+        epoll_ctl( epoll_fd, EPOLL_CTL_ADD, listener, &ev );
+        }
+
+    // Событие готовности ответов управляющего потока (для потока обмена).
+    if ( answers_event_fd < 0 )
+        {
+        answers_event_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+        }
+    if ( answers_event_fd >= 0 )
+        {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = answers_event_fd;
+        epoll_ctl( epoll_fd, EPOLL_CTL_ADD, answers_event_fd, &ev );
+        }
 
     netOK = 1;
     return 0;
@@ -254,6 +406,7 @@ void tcp_communicator_linux::net_terminate()
 //------------------------------------------------------------------------------
 tcp_communicator_linux::~tcp_communicator_linux()
     {
+    stop_comm_thread();
     net_terminate();
     }
 //------------------------------------------------------------------------------
@@ -292,244 +445,529 @@ int tcp_communicator_linux::evaluate()
         }
     // Инициализация сети, при необходимости.-!>
 
+    if ( check_comm_thread() )
+        {
+        process_service_requests();
+
+        // Асинхронные клиенты используются управляющим потоком (из Lua),
+        // поэтому обрабатываются им же, без ожидания.
+        process_async_clients();
+
+        return 0;
+        }
+
     int count_cycles = 0;
-    int max_sock_number = 0;
     while ( count_cycles < max_cycles )
         {
         /* service loop */
         count_cycles++;
-        sleep_ms(1);
-        max_sock_number = 0;
 
-        FD_ZERO( &rfds );
-        for ( u_int i = 0; i < sst.size(); i++ )
+        if ( 0 == process_sockets( 0, true ) ) break; // Ничего не произошло.
+        }  /* service loop */
+
+    send_pushes();
+
+    for ( u_int i = 0; i < sst.size(); i++ )
+        {
+        sst[ i ].evaluated = 0;
+        }
+
+    return 0;
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::process_sockets( int timeout_ms,
+    bool is_async_clients )
+    {
+    // Сокеты, данные которых не обработаны в предыдущей итерации, -
+    // без ожидания.
+    auto is_ready = std::any_of( sst.begin(), sst.end(),
+        []( const socket_state& state )
+        {
+        return state.is_readable && !state.evaluated &&
+            state.out_queue.empty() && !state.is_service_waiting;
+        } );
+
+    epoll_event events[ C_MAX_EVENTS ];
+    rc = epoll_wait( epoll_fd, events, C_MAX_EVENTS,
+        is_ready ? 0 : timeout_ms );
+
+    if ( rc < 0 )
+        {
+        if ( EINTR != errno )
             {
-            if ( sst[ i ].active &&
-                sst[ i ].is_listener &&
-                !sst[ i ].evaluated )
+            sprintf( G_LOG->msg,
+                "Network communication : epoll_wait : %s.",
+                strerror( errno ) );
+            G_LOG->write_log( i_log::P_ERR );
+            }
+
+        return rc;
+        }
+
+    for ( int i = 0; i < rc; i++ )
+        {
+        auto fd = events[ i ].data.fd;
+        if ( fd == master_socket || fd == modbus_socket )
+            {
+            accept_clients( fd );
+            continue;
+            }
+        if ( fd == answers_event_fd )
+            {
+            // Ответы передаются потоком обмена после обработки событий.
+            uint64_t value;
+            while ( read( answers_event_fd, &value, sizeof( value ) ) > 0 );
+            continue;
+            }
+
+        for ( u_int j = 0; j < sst.size(); j++ )
+            {
+            if ( sst[ j ].socket != fd )
                 {
-                /* re-join active sockets */
-                FD_SET( sst[ i ].socket, &rfds );
-                if (sst[ i ].socket > max_sock_number)
-                    {
-                    max_sock_number = sst[ i ].socket;
-                    }
+                continue;
+                }
+
+            if ( events[ i ].events & ~EPOLLOUT )
+                {
+                sst[ j ].is_readable = true;
+                }
+            if ( ( events[ i ].events & EPOLLOUT ) &&
+                flush_out_queue( j ) < 0 )
+                {
+                remove_socket( j );
+                }
+            break;
+            }
+        }
+
+    check_slow_clients();
+
+    // Обработка запросов - не более одного для сокета сервера за вызов
+    // evaluate(). Пока ответ на предыдущий запрос не передан, новые
+    // запросы соединения не принимаются.
+    auto processed_count = 0;
+    for ( u_int i = 0; i < sst.size(); i++ )
+        {
+        if ( !sst[ i ].is_readable || sst[ i ].evaluated ||
+            !sst[ i ].out_queue.empty() || sst[ i ].is_service_waiting )
+            {
+            continue;
+            }
+
+        processed_count++;
+        if ( read_socket( i ) < 0 )
+            {
+            remove_socket( i );
+            i--;
+            continue;
+            }
+
+        if ( auto frame_size = get_frame_size( sst[ i ] ); frame_size > 0 )
+            {
+            auto sockets_count = sst.size();
+            do_echo( i, frame_size );
+            glob_last_transfer_time = get_millisec();
+
+            if ( sst.size() < sockets_count ) // Сокет закрыт.
+                {
+                i--;
+                continue;
                 }
             }
 
-        //Добавляем асинхронные сокеты в список прослушки
-        for (std::map<int, tcp_client*>::iterator it = clients->begin(); it != clients->end(); ++ it)
+        // Событие edge-triggered не повторяется - принятые кадры и данные,
+        // оставшиеся в сокете, обрабатываются при следующем вызове.
+        int available = 0;
+        sst[ i ].is_readable = get_frame_size( sst[ i ] ) > 0 ||
+            ( ioctl( sst[ i ].socket, FIONREAD, &available ) == 0 &&
+            available > 0 );
+        }
+
+    if ( is_async_clients )
+        {
+        process_async_clients();
+        }
+
+    return rc + processed_count;
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::accept_clients( int listener )
+    {
+    while ( true )
+        {
+        memset( &ssin, 0, sizeof ( ssin ) );
+        sin_len = sizeof( ssin );
+        slave_socket = accept( listener, ( struct sockaddr * ) &ssin,
+            &sin_len );
+
+        if ( slave_socket < 0 )
             {
-            FD_SET( it->second->get_socket(), &rfds);
-            if (it->second->get_socket() > max_sock_number)
+            if ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR )
                 {
-                max_sock_number = it->second->get_socket();
+                sprintf( G_LOG->msg,
+                    "Network communication : accept socket : %s.",
+                    strerror( errno ) );
+                G_LOG->write_log( i_log::P_ERR );
                 }
+
+            return;
+            }
+
+        if ( listener != modbus_socket )
+            {
+            char Message1[] = "PAC accept";
+            send( slave_socket, Message1, strlen ( Message1 ), MSG_NOSIGNAL );
+            }
+        // Установка сокета в неблокирующий режим.
+        if ( fcntl( slave_socket, F_SETFL, O_NONBLOCK ) < 0 )
+            {
+            // Ошибка, разрушаем сокет.
+            shutdown( slave_socket, 0 );
+            close( slave_socket );
+
+            sprintf( G_LOG->msg,
+                "Network communication : fcntl socket : %s.",
+                strerror( errno ) );
+            G_LOG->write_log( i_log::P_ERR );
+
+            continue;
             }
 
-        // Ждём события в одном из сокетов.
-        rc = select( max_sock_number + 1, &rfds, NULL, NULL, &tv );
+        const char *DESCR = "modbus";
+        if ( listener != modbus_socket )
+            {
+            DESCR = "server";
+            }
 
-        if ( 0 == rc ) break; // Ничего не произошло.
+        // Определение имени клиента.
+        if (hostent* client = gethostbyaddr(&ssin.sin_addr, 4, AF_INET); client)
+            {
+            sprintf( G_LOG->msg,
+               "Network communication : accepted %s connection : s%d->\"%s\":\"%s\".",
+               DESCR, slave_socket, client->h_name, inet_ntoa(ssin.sin_addr) );
+            G_LOG->write_log( i_log::P_INFO );
+            }
+        else
+            {
+            const char* err_str = hstrerror( h_errno );
+            sprintf( G_LOG->msg,
+               "Network communication : accepted %s connection : s%d->\"%s\":\"%s\".",
+               DESCR, slave_socket, err_str, inet_ntoa(ssin.sin_addr));
+            G_LOG->write_log( i_log::P_INFO );
+            }
 
-        if ( rc < 0 )
+        // Данные, поступившие до регистрации, также дают событие.
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = slave_socket;
+        if ( epoll_ctl( epoll_fd, EPOLL_CTL_ADD, slave_socket, &ev ) < 0 )
             {
+            shutdown( slave_socket, 0 );
+            close( slave_socket );
+
             sprintf( G_LOG->msg,
-                "Network communication : select socket : %s.",
+                "Network communication : epoll_ctl socket : %s.",
                 strerror( errno ) );
             G_LOG->write_log( i_log::P_ERR );
 
             continue;
             }
 
-        for ( u_int i = 0; i < sst.size(); i++ )  /* scan all possible sockets */
+        socket_state slave_socket_state;
+        slave_socket_state.socket = slave_socket;
+        slave_socket_state.active = 1;
+        slave_socket_state.init   = 1;
+        slave_socket_state.is_listener = 1;
+        slave_socket_state.evaluated = 0;
+        if ( ++last_socket_key == 0 ) last_socket_key++;
+        slave_socket_state.key = last_socket_key;
+        memcpy( &slave_socket_state.sin, &ssin, sin_len );
+        if ( listener == modbus_socket )
             {
-            // Поступил новый запрос на соединение.
-            if ( FD_ISSET ( sst[ i ].socket, &rfds ) )
+            slave_socket_state.ismodbus = 1;
+            }
+        else
+            {
+            slave_socket_state.ismodbus = 0;
+
+            if ( ++last_connection_id == 0 ) last_connection_id++;
+            slave_socket_state.id = last_connection_id;
+            std::lock_guard<std::mutex> lock( push_mutex );
+            push_data[ slave_socket_state.id ].clear();
+            }
+
+        sst.push_back(slave_socket_state);
+        }
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::process_async_clients()
+    {
+    // Регистрация сокетов новых клиентов, удаление - отключенных.
+    for ( auto it = async_epoll_sockets.begin();
+        it != async_epoll_sockets.end(); )
+        {
+        if ( clients->count( *it ) == 0 )
+            {
+            epoll_ctl( async_epoll_fd, EPOLL_CTL_DEL, *it, nullptr );
+            it = async_epoll_sockets.erase( it );
+            }
+        else
+            {
+            ++it;
+            }
+        }
+    for ( const auto& [ socket, client ] : *clients )
+        {
+        if ( async_epoll_sockets.insert( socket ).second )
+            {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = socket;
+            epoll_ctl( async_epoll_fd, EPOLL_CTL_ADD, socket, &ev );
+            }
+        }
+
+    std::set< int > ready_sockets;
+    if ( !clients->empty() )
+        {
+        epoll_event events[ C_MAX_EVENTS ];
+        auto count = epoll_wait( async_epoll_fd, events, C_MAX_EVENTS, 0 );
+        for ( int i = 0; i < count; i++ )
+            {
+            ready_sockets.insert( events[ i ].data.fd );
+            }
+        }
+
+    //проверка асинхронных сокетов на предмет поступления данных
+    for (std::map<int, tcp_client*>::iterator it = clients->begin(); it != clients->end();)
+        {
+        int is_removed = 0;
+        if ( ready_sockets.count( it->second->get_socket() ) ) //если есть событие на сокете
+            {
+            if ( int err = recvtimeout(it->second->get_socket(),
+                (unsigned char*)it->second->buff, it->second->buff_size,
+                1, 0, it->second->ip, "async client", 0);
+                err <= 0 ) //Ошибка чтения
                 {
-                if ( sst[ i ].socket == master_socket || sst[ i ].socket == modbus_socket )
-                     {
-                    /* master socket */
-                    memset( &ssin, 0, sizeof ( ssin ) );
-                    slave_socket = accept ( sst[ i ].socket,
-                        ( struct sockaddr * ) &ssin, &sin_len );
-
-                    if ( slave_socket <= 0 )    // Ошибка.
-                        {
-                        sprintf( G_LOG->msg,
-                            "Network communication : accept socket : %s.",
-                            strerror( errno ) );
-                        G_LOG->write_log( i_log::P_ERR );
-
-                        continue;
-                        }
-
-                    if ( sst[ i ].socket != modbus_socket )
-                        {
-                        char Message1[] = "PAC accept";
-                        send( slave_socket, Message1, strlen ( Message1 ), MSG_NOSIGNAL );
-                        }
-                    // Установка сокета в неблокирующий режим.
-                    if ( fcntl( slave_socket, F_SETFL, O_NONBLOCK ) < 0 )
-                        {
-                        // Ошибка, разрушаем сокет.
-                        shutdown( slave_socket, 0 );
-                        close( slave_socket );
-
-                        sprintf( G_LOG->msg,
-                            "Network communication : fcntl socket : %s.",
-                            strerror( errno ) );
-                        G_LOG->write_log( i_log::P_ERR );
-
-                        continue;
-                        }
-
-                    const char *DESCR = "modbus";
-                    if ( sst[ i ].socket != modbus_socket )
-                        {
-                        DESCR = "server";
-                        }
-
-                    // Определение имени клиента.
-                    if (hostent* client = gethostbyaddr(&ssin.sin_addr, 4, AF_INET); client)
-                        {
-                        sprintf( G_LOG->msg,
-                           "Network communication : accepted %s connection : s%d->\"%s\":\"%s\".",
-                           DESCR, slave_socket, client->h_name, inet_ntoa(ssin.sin_addr) );
-                        G_LOG->write_log( i_log::P_INFO );
-                        }
-                    else
-                        {
-                        const char* err_str = hstrerror( h_errno );
-                        sprintf( G_LOG->msg,
-                           "Network communication : accepted %s connection : s%d->\"%s\":\"%s\".",
-                           DESCR, slave_socket, err_str, inet_ntoa(ssin.sin_addr));
-                        G_LOG->write_log( i_log::P_INFO );
-                        }
-
-
-                    FD_SET( slave_socket, &rfds );
-                    socket_state slave_socket_state;
-                    slave_socket_state.socket = slave_socket;
-                    slave_socket_state.active = 1;
-                    slave_socket_state.init   = 1;
-                    slave_socket_state.is_listener = 1;
-                    slave_socket_state.evaluated = 0;
-                    memcpy( &slave_socket_state.sin, &ssin, sin_len );
-                    if ( sst[ i ].socket == modbus_socket )
-                        {
-                        slave_socket_state.ismodbus = 1;
-                        }
-                    else
-                        {
-                        slave_socket_state.ismodbus = 0;
-                        }
-
-                    sst.push_back(slave_socket_state);
-                    }
-                else         /* slave socket */
-                    {
-                    do_echo( i );
-                    glob_last_transfer_time = get_millisec();
-                    }
+                it->second->Disconnect();
+                it->second->set_async_result(it->second->AR_SOCKETERROR);
+                }
+            else //Получены данные
+                {
+                it->second->set_async_result(err);
+                }
+            is_removed = 1;
+            }
+        else //проверяем на таймаут
+            {
+            if (get_delta_millisec(it->second->async_queued) > it->second->async_timeout)
+                {
+                it->second->Disconnect();
+                it->second->set_async_result(it->second->AR_TIMEOUT);
+                is_removed = 1;
                 }
             }
 
-        //проверка асинхронных сокетов на предмет поступления данных
-         for (std::map<int, tcp_client*>::iterator it = clients->begin(); it != clients->end();)
-             {
-             int is_removed = 0;
-             if (FD_ISSET(it->second->get_socket(), &rfds)) //если есть событие на сокете
-                 {
-                 if ( int err = recvtimeout(it->second->get_socket(),
-                     (unsigned char*)it->second->buff, it->second->buff_size,
-                     1, 0, it->second->ip, "async client", 0);
-                     err <= 0 ) //Ошибка чтения
-                     {
-                     it->second->Disconnect();
-                     it->second->set_async_result(it->second->AR_SOCKETERROR);
-                     }
-                 else //Получены данные
-                     {
-                     in_buffer_count = err;
-                     it->second->set_async_result(in_buffer_count);
-                     }
-                 is_removed = 1;
-                 }
-             else //проверяем на таймаут
-                 {
-                 if (get_delta_millisec(it->second->async_queued) > it->second->async_timeout)
-                     {
-                     it->second->Disconnect();
-                     it->second->set_async_result(it->second->AR_TIMEOUT);
-                     is_removed = 1;
-                     }
-                 }
-
-             if (is_removed)
-                 {
-                 clients->erase(it++);
-                 }
-             else
-                 {
-                 it++;
-                 }
-             }
+        if (is_removed)
+            {
+            // Сокет может быть закрыт клиентом и открыт заново с тем же
+            // номером - регистрация удаляется сразу.
+            epoll_ctl( async_epoll_fd, EPOLL_CTL_DEL, it->first, nullptr );
+            async_epoll_sockets.erase( it->first );
+            clients->erase(it++);
+            }
+        else
+            {
+            it++;
+            }
+        }
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::queue_service_request( int idx, srv_ptr srv,
+    u_int frame_size )
+    {
+    auto& sock_state = sst[ idx ];
+    sock_state.is_service_waiting = true;
 
-        }  /* service loop */
+    std::lock_guard<std::mutex> lock( comm_mutex );
+    requests.push_back( { sock_state.key, sock_state.id, srv,
+        std::vector< u_char >( buf, buf + frame_size ) } );
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::process_service_requests()
+    {
+    std::deque< service_request > current;
+        {
+        std::lock_guard<std::mutex> lock( comm_mutex );
+        current.swap( requests );
+        }
+    if ( current.empty() )
+        {
+        return;
+        }
+
+    if ( service_buff.empty() )
+        {
+        service_buff.resize( BUFSIZE );
+        }
+
+    // Все принятые запросы выполняются за один вызов, ответ формируется
+    // так же, как в do_echo().
+    for ( auto& request : current )
+        {
+        auto b = service_buff.data();
+        auto frame_size = request.frame.size();
+        memcpy( b, request.frame.data(), frame_size );
+        b[ frame_size ] = 0;
+        auto len = static_cast<u_int>( b[ 4 ] * 256 + b[ 5 ] );
 
+        if ( 0 == b[ 2 ] + b[ 3 ] ) // MODBUS
+            {
+            long res = request.srv( len, b + 6, b + 6 );
+            if ( res > 0 )
+                {
+                b[ 4 ] = ( res >> 8 ) & 0xFF;
+                b[ 5 ] = res & 0xFF;
+                frame_size = res + 6;
+                }
+            }
+        else
+            {
+            auto answer_pidx = b[ 3 ];
+            service_connection_id = request.connection_id;
+            long res = request.srv( len, b + 6, b + 5 );
+            service_connection_id = 0;
+
+            b[ 1 ] = AKN_OK;
+            b[ 2 ] = answer_pidx;
+            b[ 3 ] = ( res >> 8 ) & 0xFF;
+            b[ 4 ] = res & 0xFF;
+            frame_size = res + 5;
+            }
 
+        request.frame.assign( b, b + frame_size );
+        }
 
-    for ( u_int i = 0; i < sst.size(); i++ )
         {
-        sst[ i ].evaluated = 0;
+        std::lock_guard<std::mutex> lock( comm_mutex );
+        std::move( current.begin(), current.end(),
+            std::back_inserter( answers ) );
         }
 
-    return 0;
+    // Без события ответы передаются по истечении времени ожидания потока
+    // обмена.
+    uint64_t value = 1;
+    if ( answers_event_fd >= 0 &&
+        write( answers_event_fd, &value, sizeof( value ) ) < 0 )
+        {
+        sprintf( G_LOG->msg,
+            "Network communication : eventfd write : %s.", strerror( errno ) );
+        G_LOG->write_log( i_log::P_WARNING );
+        }
     }
 //------------------------------------------------------------------------------
-int tcp_communicator_linux::sendall (int sockfd, unsigned char *buf, int len,
-    int sec, int usec, const char* IP, const char* name,
-    stat_time *stat )
+void tcp_communicator_linux::send_service_answers()
     {
-    //Network performance info.
-    if (stat)
+    std::deque< service_request > ready;
         {
-        static time_t t_;
-        struct tm *timeInfo_;
-        t_ = time(0);
-        timeInfo_ = localtime(&t_);
+        std::lock_guard<std::mutex> lock( comm_mutex );
+        ready.swap( answers );
+        }
 
-        //Once per hour writes performance info.
-        if (stat->print_cycle_last_h != timeInfo_->tm_hour)
+    for ( auto& answer : ready )
+        {
+        // Соединение могло быть закрыто - ответ не передается.
+        for ( u_int i = 0; i < sst.size(); i++ )
             {
-            auto t =
-                G_PAC_INFO()->par[PAC_info::P_WAGO_TCP_NODE_WARN_ANSWER_AVG_TIME];
-
-            stat->print_cycle_last_h = timeInfo_->tm_hour;
+            if ( sst[ i ].key != answer.key )
+                {
+                continue;
+                }
 
-            auto avg_time = stat->all_time / stat->cycles_cnt;
-            sprintf( G_LOG->msg,
-                R"(Network performance : send : s%d->"%s":"%s" )"
-                "avg = %" PRIu32 ", min = %" PRIu32 ", max = %" PRIu32 ", tresh = %u (ms).",
-                sockfd, name, IP,
-                avg_time, stat->min_iteration_cycle_time,
-                stat->max_iteration_cycle_time, t );
-            G_LOG->write_log( i_log::P_DEBUG );
-
-            if (t < avg_time)
+            sst[ i ].is_service_waiting = false;
+            if ( queue_send( i, answer.frame.data(),
+                static_cast<u_int>( answer.frame.size() ) ) < 0 )
                 {
-                sprintf( G_LOG->msg,
-                    R"(Network performance : send : s%d->"%s":"%s" )"
-                    "avg %" PRIu32 " > tresh %u (ms).",
-                    sockfd, name, IP, avg_time, t );
-                G_LOG->write_log( i_log::P_ALERT );
+                remove_socket( i );
                 }
+            break;
+            }
+        }
+    }
+//------------------------------------------------------------------------------
+size_t tcp_communicator_linux::get_service_requests_count() const
+    {
+    std::lock_guard<std::mutex> lock( comm_mutex );
+    return requests.size();
+    }
+//------------------------------------------------------------------------------
+bool tcp_communicator_linux::check_comm_thread()
+    {
+    bool is_on = G_PAC_INFO()->par[ PAC_info::P_COMM_THREAD ] != 0;
+
+    if ( !is_on && comm_thread.joinable() )
+        {
+        stop_comm_thread();
 
-            stat->clear();
+        // Запросы, принятые потоком обмена, выполняются без него.
+        process_service_requests();
+        send_service_answers();
+        }
+
+    if ( is_on && !comm_thread.joinable() )
+        {
+        start_comm_thread();
+        }
+
+    return is_on;
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::start_comm_thread()
+    {
+    is_comm_thread_running = true;
+    comm_thread = std::thread( &tcp_communicator_linux::comm_thread_main, this );
+
+    G_LOG->info( "Server communication thread started." );
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::stop_comm_thread()
+    {
+    if ( !comm_thread.joinable() )
+        {
+        return;
+        }
+
+    is_comm_thread_running = false;
+    comm_thread.join();
+
+    G_LOG->info( "Server communication thread stopped." );
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::comm_thread_main()
+    {
+    is_comm_thread = true;
+    log_mngr::init_thread_log();
+
+    while ( is_comm_thread_running )
+        {
+        process_sockets( C_COMM_THREAD_WAIT_TIMEOUT_MS, false );
+        send_service_answers();
+        send_pushes();
+
+        for ( auto& sock_state : sst )
+            {
+            sock_state.evaluated = 0;
             }
         }
 
+    log_mngr::free_thread_log();
+    is_comm_thread = false;
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::sendall (int sockfd, unsigned char *buf, int len,
+    int sec, int usec, const char* IP, const char* name,
+    stat_time *stat )
+    {
     int total_size = 0;
     unsigned char *p = buf;
 
@@ -543,10 +981,9 @@ int tcp_communicator_linux::sendall (int sockfd, unsigned char *buf, int len,
     rec_tv.tv_sec = sec;
     rec_tv.tv_usec = usec;
 
-    //Network performance info.
-    static uint32_t st_time;
-    static uint32_t select_wait_time;
-    st_time = get_millisec();
+    //Network performance info. Функция может вызываться из потока обмена
+    //с узлами I/O, поэтому статические переменные не используются.
+    uint32_t st_time = get_millisec();
 
     int res = 0;
 
@@ -601,84 +1038,367 @@ int tcp_communicator_linux::sendall (int sockfd, unsigned char *buf, int len,
         }
 
     //Network performance info.
-    select_wait_time = get_delta_millisec( st_time );
+    add_net_stat( stat, get_delta_millisec( st_time ), "send", sockfd, IP,
+        name );
+
+    return res;
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::add_net_stat( stat_time* stat,
+    uint32_t time_ms, const char* direction, int sockfd, const char* IP,
+    const char* name )
+    {
+    if ( !stat )
+        {
+        return;
+        }
+
+    time_t t_ = time(0);
+    struct tm *timeInfo_;
+    timeInfo_ = localtime(&t_);
 
-    if ( stat )
+    //Once per hour writes performance info.
+    if (stat->print_cycle_last_h != timeInfo_->tm_hour)
         {
-        stat->cycles_cnt++;
-        stat->all_time += select_wait_time;
+        auto t =
+            G_PAC_INFO()->par[PAC_info::P_WAGO_TCP_NODE_WARN_ANSWER_AVG_TIME];
 
-        if ( select_wait_time > stat->max_iteration_cycle_time )
+        stat->print_cycle_last_h = timeInfo_->tm_hour;
+
+        auto avg_time = stat->all_time / stat->cycles_cnt;
+        sprintf( G_LOG->msg,
+            R"(Network performance : %s : s%d->"%s":"%s" )"
+            "avg = %" PRIu32 ", min = %" PRIu32 ", max = %" PRIu32 ", tresh = %u (ms).",
+            direction, sockfd, name, IP,
+            avg_time, stat->min_iteration_cycle_time,
+            stat->max_iteration_cycle_time, t );
+        G_LOG->write_log( i_log::P_DEBUG );
+
+        if (t < avg_time)
             {
-            stat->max_iteration_cycle_time = select_wait_time;
+            sprintf( G_LOG->msg,
+                R"(Network performance : %s : s%d->"%s":"%s" )"
+                "avg %" PRIu32 " > tresh %u (ms).",
+                direction, sockfd, name, IP, avg_time, t );
+            G_LOG->write_log( i_log::P_ALERT );
             }
-        if ( select_wait_time < stat->min_iteration_cycle_time )
+
+        stat->clear();
+        }
+
+    stat->cycles_cnt++;
+    stat->all_time += time_ms;
+
+    if ( time_ms > stat->max_iteration_cycle_time )
+        {
+        stat->max_iteration_cycle_time = time_ms;
+        }
+    if ( time_ms < stat->min_iteration_cycle_time )
+        {
+        stat->min_iteration_cycle_time = time_ms;
+        }
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::queue_send( int idx, const u_char* data,
+    u_int size )
+    {
+    auto& state = sst[ idx ];
+    if ( state.out_queue.empty() )
+        {
+        state.out_start_time = get_millisec();
+        state.out_progress_time = state.out_start_time;
+
+        // Очередь пуста - передача без копирования, в очередь помещается
+        // только непереданная часть.
+        auto n = send( state.socket, data, size, MSG_NOSIGNAL );
+        if ( n < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+            errno != EINTR )
             {
-            stat->min_iteration_cycle_time = select_wait_time;
+            sprintf( G_LOG->msg,
+                "Network device : s%d->\"%s\":\"%s\""
+                " disconnected on write try : %s.",
+                state.socket, get_dev_name( state ),
+                inet_ntoa( state.sin.sin_addr ), strerror( errno ) );
+            G_LOG->write_log( i_log::P_ERR );
+
+            return -1;
+            }
+        if ( n > 0 )
+            {
+            data += n;
+            size -= n;
+            }
+        if ( 0 == size )
+            {
+            add_net_stat( &state.send_stat, 0, "send", state.socket,
+                inet_ntoa( state.sin.sin_addr ), get_dev_name( state ) );
+            return 0;
             }
         }
 
-    return res;
+    u_int max_size = G_PAC_INFO()->par[ PAC_info::P_TCP_MAX_OUT_QUEUE ];
+    if ( max_size && state.out_queue_size + size > max_size * 1024ULL )
+        {
+        slow_clients_count++;
+        sprintf( G_LOG->msg,
+            "Network device : s%d->\"%s\" disconnected : output queue "
+            "size %zu > %u (Kb).",
+            state.socket, inet_ntoa( state.sin.sin_addr ),
+            ( state.out_queue_size + size ) / 1024, max_size );
+        G_LOG->write_log( i_log::P_WARNING );
+
+        return -1;
+        }
+
+    state.out_queue.emplace_back( data, data + size );
+    state.out_queue_size += size;
+    if ( state.out_queue_size > max_out_queue_size )
+        {
+        max_out_queue_size = state.out_queue_size;
+        }
+
+    return flush_out_queue( idx );
     }
 //------------------------------------------------------------------------------
-int tcp_communicator_linux::do_echo ( int idx )
+int tcp_communicator_linux::flush_out_queue( int idx )
     {
-    socket_state &sock_state = sst[ idx ];
-    FD_CLR( sock_state.socket, &rfds );
+    auto& state = sst[ idx ];
+    while ( !state.out_queue.empty() )
+        {
+        // Передача нескольких буферов очереди за один вызов (как writev,
+        // но с MSG_NOSIGNAL).
+        iovec iov[ C_MAX_IOV ];
+        size_t iov_count = 0;
+        for ( auto it = state.out_queue.begin();
+            it != state.out_queue.end() && iov_count < C_MAX_IOV; ++it )
+            {
+            auto offset = iov_count ? 0 : state.out_offset;
+            iov[ iov_count ].iov_base = it->data() + offset;
+            iov[ iov_count ].iov_len = it->size() - offset;
+            iov_count++;
+            }
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iov_count;
+        auto n = sendmsg( state.socket, &msg, MSG_NOSIGNAL );
+        if ( n < 0 )
+            {
+            if ( EINTR == errno )
+                {
+                continue;
+                }
+            if ( EAGAIN == errno || EWOULDBLOCK == errno )
+                {
+                break;
+                }
+
+            sprintf( G_LOG->msg,
+                "Network device : s%d->\"%s\":\"%s\""
+                " disconnected on write try : %s.",
+                state.socket, get_dev_name( state ),
+                inet_ntoa( state.sin.sin_addr ), strerror( errno ) );
+            G_LOG->write_log( i_log::P_ERR );
+
+            return -1;
+            }
+
+        state.out_progress_time = get_millisec();
+        state.out_queue_size -= n;
+        size_t sent = n;
+        while ( sent > 0 )
+            {
+            auto rest = state.out_queue.front().size() - state.out_offset;
+            if ( sent < rest )
+                {
+                state.out_offset += sent;
+                break;
+                }
 
-    static const char* const SERVER = "easyserver";
-    static const char* const MODBUS_DEV = "modbus device";
+            sent -= rest;
+            state.out_offset = 0;
+            state.out_queue.pop_front();
+            }
+        }
 
-    const char *dev_name = SERVER;
-    if ( sock_state.ismodbus )
+    if ( state.out_queue.empty() )
         {
-        dev_name = MODBUS_DEV;
+        add_net_stat( &state.send_stat,
+            get_delta_millisec( state.out_start_time ), "send", state.socket,
+            inet_ntoa( state.sin.sin_addr ), get_dev_name( state ) );
         }
 
-    int err = 0, res;
+    // Ожидание возможности передачи - только пока очередь не пуста.
+    bool is_out_waiting = !state.out_queue.empty();
+    if ( is_out_waiting != state.is_out_waiting )
+        {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        if ( is_out_waiting )
+            {
+            ev.events |= EPOLLOUT;
+            }
+        ev.data.fd = state.socket;
+        epoll_ctl( epoll_fd, EPOLL_CTL_MOD, state.socket, &ev );
+        state.is_out_waiting = is_out_waiting;
+        }
 
-    sock_state.evaluated = 1;
-    memset( buf, 0, BUFSIZE );
+    return 0;
+    }
+//------------------------------------------------------------------------------
+void tcp_communicator_linux::check_slow_clients()
+    {
+    u_int timeout = G_PAC_INFO()->par[ PAC_info::P_TCP_SLOW_CLIENT_TIMEOUT ];
+    if ( !timeout )
+        {
+        return;
+        }
 
-    if (sock_state.init)
+    for ( u_int i = 0; i < sst.size(); i++ )
         {
-        sock_state.init = 0;
-        if (sock_state.ismodbus)
+        if ( sst[ i ].out_queue.empty() ||
+            get_delta_millisec( sst[ i ].out_progress_time ) <= timeout )
             {
-            // Ожидаем данные с таймаутом 50 мсек.
-            err = in_buffer_count = recvtimeout( sock_state.socket, buf, BUFSIZE, 0, 50000L,
-                inet_ntoa( sock_state.sin.sin_addr ), dev_name, &sock_state.recv_stat );
-            if (err == -2)
+            continue;
+            }
+
+        slow_clients_count++;
+        sprintf( G_LOG->msg,
+            "Network device : s%d->\"%s\" disconnected : slow client, "
+            "%zu bytes are not sent during %u ms.",
+            sst[ i ].socket, inet_ntoa( sst[ i ].sin.sin_addr ),
+            sst[ i ].out_queue_size, timeout );
+        G_LOG->write_log( i_log::P_WARNING );
+
+        remove_socket( i );
+        i--;
+        }
+    }
+//------------------------------------------------------------------------------
+u_int tcp_communicator_linux::get_slow_clients_count() const
+    {
+    return slow_clients_count;
+    }
+//------------------------------------------------------------------------------
+size_t tcp_communicator_linux::get_max_out_queue_size() const
+    {
+    return max_out_queue_size;
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::read_socket( int idx )
+    {
+    auto& state = sst[ idx ];
+    while ( true )
+        {
+        // Буфер должен вмещать принимаемый кадр целиком.
+        size_t buff_size = std::max<u_int>( C_RECV_BUFF_SIZE,
+            get_frame_size( state, true ) );
+        if ( state.in_buff.size() < buff_size )
+            {
+            state.in_buff.resize( buff_size );
+            }
+
+        auto space = state.in_buff.size() - state.in_size;
+        if ( 0 == space ) // Буфер содержит принятые кадры.
+            {
+            return 0;
+            }
+
+        auto n = recv( state.socket, state.in_buff.data() + state.in_size,
+            space, 0 );
+        if ( n > 0 )
+            {
+            if ( 0 == state.in_size )
+                {
+                state.in_start_time = get_millisec();
+                }
+            state.in_size += n;
+
+            if ( static_cast<size_t>( n ) < space ) // Данных больше нет.
                 {
-                //Если при подключении на модбас-сокет первый раз данные не пришли, то игнорируем(панель Weintek)
                 return 0;
                 }
+            continue;
             }
-        else
+
+        if ( 0 == n )
+            {
+            sprintf( G_LOG->msg,
+                "Network device : s%d->\"%s\":\"%s\""
+                " was closed.",
+                state.socket, get_dev_name( state ),
+                inet_ntoa( state.sin.sin_addr ) );
+            G_LOG->write_log( i_log::P_WARNING );
+
+            return -1;
+            }
+
+        if ( EINTR == errno )
+            {
+            continue;
+            }
+        if ( EAGAIN == errno || EWOULDBLOCK == errno )
             {
-            // Ожидаем данные с таймаутом 300 мсек.
-            err = in_buffer_count = recvtimeout( sock_state.socket, buf, BUFSIZE, 0, 300000L,
-                inet_ntoa( sock_state.sin.sin_addr ), dev_name, &sock_state.recv_stat );
+            return 0;
             }
+
+        sprintf( G_LOG->msg,
+            "Network device : s%d->\"%s\":\"%s\""
+            " disconnected on read try : %s.",
+            state.socket, get_dev_name( state ),
+            inet_ntoa( state.sin.sin_addr ), strerror( errno ) );
+        G_LOG->write_log( i_log::P_ERR );
+
+        return -1;
         }
-    else
+    }
+//------------------------------------------------------------------------------
+u_int tcp_communicator_linux::get_frame_size( const socket_state& state,
+    bool is_header_only )
+    {
+    if ( state.in_size < C_FRAME_HEADER_SIZE )
         {
-        // Ожидаем данные с таймаутом 300 мсек.
-        err = in_buffer_count = recvtimeout( sock_state.socket, buf, BUFSIZE, 0, 300000L,
-            inet_ntoa( sock_state.sin.sin_addr ), dev_name, &sock_state.recv_stat );
+        return 0;
         }
 
-    if ( err <= 0 )               /* read error */
-        {
-        shutdown( sock_state.socket, 0 );
-        close( sock_state.socket );
-        sst.erase(sst.begin() + idx, sst.begin() + idx + 1);
-        return err;
-        }
+    // Кадр сервера и Modbus TCP: 6 байт заголовка, последние два - размер
+    // данных (старший байт первый).
+    u_int frame_size = C_FRAME_HEADER_SIZE +
+        state.in_buff[ 4 ] * 256 + state.in_buff[ 5 ];
 
-    if ( sock_state.init )         /* socket is just initiated */
+    return is_header_only || state.in_size >= frame_size ? frame_size : 0;
+    }
+//------------------------------------------------------------------------------
+const char* tcp_communicator_linux::get_dev_name( const socket_state& state )
+    {
+    return state.ismodbus ? "modbus device" : "easyserver";
+    }
+//------------------------------------------------------------------------------
+int tcp_communicator_linux::do_echo( int idx, u_int frame_size )
+    {
+    socket_state &sock_state = sst[ idx ];
+
+    int err = 0, res;
+
+    sock_state.evaluated = 1;
+
+    // Кадр копируется в общий буфер (в нем же формируется ответ) -
+    // обнуляется только байт после кадра (строковые данные сервисов).
+    memcpy( buf, sock_state.in_buff.data(), frame_size );
+    buf[ frame_size ] = 0;
+    in_buffer_count = frame_size;
+
+    add_net_stat( &sock_state.recv_stat,
+        get_delta_millisec( sock_state.in_start_time ), "recv",
+        sock_state.socket, inet_ntoa( sock_state.sin.sin_addr ),
+        get_dev_name( sock_state ) );
+
+    sock_state.in_size -= frame_size;
+    if ( sock_state.in_size > 0 )
         {
-        sock_state.init = 0;
+        memmove( sock_state.in_buff.data(),
+            sock_state.in_buff.data() + frame_size, sock_state.in_size );
+        sock_state.in_start_time = get_millisec();
         }
 
     if ( in_buffer_count > max_buffer_use )
@@ -700,9 +1420,18 @@ int tcp_communicator_linux::do_echo ( int idx )
         switch ( buf[ 2 ] )
             {
             case FRAME_SINGLE:
+                if ( is_comm_thread )
+                    {
+                    // Сервис выполняется управляющим потоком.
+                    queue_service_request( idx, services[ buf[ 1 ] ],
+                        frame_size );
+                    return 0;
+                    }
 
-                res = services[ buf[ 1 ] ] (
+                service_connection_id = sock_state.id;
+                res = services[ buf[ 1 ] ](
                     ( u_int ) ( buf[ 4 ] * 256 + buf[ 5 ] ), buf + 6, buf + 5 );
+                service_connection_id = 0;
 
                 if ( ( unsigned int ) res > max_buffer_use )
                     {
@@ -738,9 +1467,15 @@ int tcp_communicator_linux::do_echo ( int idx )
         {
         if ( services[ 15 ] != NULL && 0 == buf[ 2 ] + buf[ 3 ] ) //MODBUS
             {
-            res = services[ 15 ] ( ( u_int ) ( buf[ 4 ] * 256 + buf[ 5 ] ),
-                buf + 6,
-                buf + 6 );
+            if ( is_comm_thread )
+                {
+                queue_service_request( idx, services[ 15 ], frame_size );
+                sock_state.evaluated = 0;
+                return 0;
+                }
+
+            res = services[ 15 ](
+                ( u_int ) ( buf[ 4 ] * 256 + buf[ 5 ] ), buf + 6, buf + 6 );
             if ( res > 0 )
                 {
                 buf[ 4 ] = ( res >> 8 ) & 0xFF;
@@ -760,19 +1495,16 @@ int tcp_communicator_linux::do_echo ( int idx )
             }
         }
 
-    err = sendall( sock_state.socket, buf, in_buffer_count, 0, 300000,
-        inet_ntoa( sock_state.sin.sin_addr ), dev_name, &sock_state.send_stat );
+    err = queue_send( idx, buf, in_buffer_count );
 
-    if ( err <= 0 )               /* write error */
+    if ( err < 0 )               /* write error */
         {
-        shutdown( sock_state.socket, 0 );
-        close( sock_state.socket );
-        sst.erase(sst.begin() + idx, sst.begin() + idx + 1);
+        remove_socket( idx );
 
         return err;
         }
 
-    return err;
+    return in_buffer_count;
     }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
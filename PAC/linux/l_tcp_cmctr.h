@@ -26,6 +26,12 @@
 
 #include <fcntl.h>
 #include <stdio.h>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
 #include <vector>
 //-----------------------------------------------------------------------------
 /// @brief Cостояние сокета.
@@ -38,6 +44,23 @@ struct socket_state
     int evaluated;   ///< В данном цикле уже произошел обмен информацией по данному сокету.
     int ismodbus;
     sockaddr_in sin; ///< Адрес клиента.
+    u_int id = 0;    ///< Идентификатор соединения (0 - не соединение сервера).
+    u_int key = 0;   ///< Уникальный номер сокета (ответы на запросы сервисов).
+    bool is_readable = false; ///< В сокете есть необработанные данные.
+
+    /// Запрос передан на выполнение управляющему потоку, ответ не получен.
+    bool is_service_waiting = false;
+
+    std::vector< u_char > in_buff; ///< Буфер приема (части кадров).
+    size_t in_size = 0;            ///< Размер принятых данных, байт.
+    uint32_t in_start_time = 0;    ///< Время приема начала кадра.
+
+    std::deque< std::vector< u_char > > out_queue; ///< Очередь передачи.
+    size_t out_queue_size = 0;      ///< Размер данных очереди передачи, байт.
+    size_t out_offset = 0;          ///< Передано байт первого буфера очереди.
+    uint32_t out_start_time = 0;    ///< Время постановки данных в пустую очередь.
+    uint32_t out_progress_time = 0; ///< Время последней передачи данных очереди.
+    bool is_out_waiting = false;    ///< Ожидается возможность передачи (EPOLLOUT).
 
 
     stat_time recv_stat;  ///< Статистика работы с сокетом.
@@ -53,37 +76,223 @@ class tcp_communicator_linux : public tcp_communicator
             virtual ~tcp_communicator_linux();
 
             /// @brief Итерация обмена данными с сервером.
+            ///
+            /// При работе потока обмена (@ref PAC_info::P_COMM_THREAD)
+            /// выполняются все запросы сервисов, принятые потоком обмена
+            /// (@ref process_service_requests), и обмен с асинхронными
+            /// клиентами.
             int evaluate();
 
+            int push( u_int connection_id, u_char srv_id, const u_char* data,
+                u_int size ) override;
+
+            bool is_push_busy( u_int connection_id ) const override;
+
+            u_int get_slow_clients_count() const override;
+
+            size_t get_max_out_queue_size() const override;
+
+            /// @brief Количество запросов сервисов, ожидающих выполнения
+            /// управляющим потоком.
+            size_t get_service_requests_count() const;
+
     private:
             sockaddr_in ssin;       ///< Адрес клиента.
             u_int sin_len;    	    ///< Длина адреса.
 
             int modbus_socket = 0;  ///< Модбас сокет.
             int slave_socket = 0;   ///< Слейв-сокет, получаемый при подключении клиента.
-            int rc = 0;             ///< Код возврата select.
+            int rc = 0;             ///< Код возврата epoll_wait.
+
+            /// @brief Обработка принятого кадра и посылка ответных данных
+            /// на сервер.
+            ///
+            /// @param idx        - индекс сокета.
+            /// @param frame_size - размер кадра в начале буфера приема.
+            int do_echo( int idx, u_int frame_size );
 
-            /// @brief Посылка ответных данных на сервер.
+            /// @brief Прием доступных данных сокета в его буфер приема
+            /// (без блокировки).
+            ///
+            /// @return - 0 - успешно, < 0 - соединение закрыто или ошибка.
+            int read_socket( int idx );
+
+            /// @brief Размер кадра в начале буфера приема.
+            ///
+            /// @param is_header_only - размер по заголовку (кадр может быть
+            /// принят не полностью).
             ///
-            /// @param skt - сокет.
-            int do_echo( int idx );
+            /// @return - размер кадра, 0 - кадр не принят полностью.
+            static u_int get_frame_size( const socket_state& state,
+                bool is_header_only = false );
 
-            uint32_t glob_last_transfer_time;  ///< Время последней успешной передачи данных.
+            static const char* get_dev_name( const socket_state& state );
 
-            timeval tv;                      ///< Задержка ожидания функции опроса состояний сокетов, 0 по умолчанию.
-            fd_set rfds;                     ///< Набор дескрипторов сокетных файлов для чтения.
+            /// Время последней успешной передачи данных.
+            std::atomic< uint32_t > glob_last_transfer_time;
+
+            int epoll_fd = -1;               ///< Ожидание событий сокетов сервера.
+            int async_epoll_fd = -1;         ///< Ожидание событий асинхронных клиентов.
+            std::set< int > async_epoll_sockets; ///< Сокеты, добавленные в async_epoll_fd.
             std::vector< socket_state > sst; ///< Таблица состояния сокетов.
             int netOK;                       ///< Признак успешной инициализации сети.
 
             /// @brief Уничтожение сокетов.
             void killsockets ();
 
+            /// @brief Подключение всех ожидающих клиентов сокета-слушателя.
+            void accept_clients( int listener );
+
+            /// @brief Закрытие сокета и удаление его из таблицы.
+            void remove_socket( int idx );
+
+            /// @brief Передача данных соединению без блокировки.
+            ///
+            /// Непереданная часть данных помещается в очередь передачи
+            /// соединения и передается при готовности сокета (EPOLLOUT).
+            ///
+            /// @return - 0 - успешно, < 0 - ошибка или переполнение очереди
+            /// (@ref PAC_info::P_TCP_MAX_OUT_QUEUE), соединение нужно закрыть.
+            int queue_send( int idx, const u_char* data, u_int size );
+
+            /// @brief Передача данных очереди передачи соединения без
+            /// блокировки.
+            ///
+            /// @return - 0 - успешно (в том числе передана часть данных),
+            /// < 0 - ошибка, соединение нужно закрыть.
+            int flush_out_queue( int idx );
+
+            /// @brief Закрытие соединений, данные которым не передаются
+            /// дольше @ref PAC_info::P_TCP_SLOW_CLIENT_TIMEOUT.
+            void check_slow_clients();
+
+            /// Статистика изменяется потоком обмена, читается основным.
+            std::atomic<u_int> slow_clients_count{ 0 };
+            std::atomic<size_t> max_out_queue_size{ 0 };
+
+            /// @brief Учет времени приема/передачи, раз в час - вывод
+            /// статистики.
+            static void add_net_stat( stat_time* stat, uint32_t time_ms,
+                const char* direction, int sockfd, const char* IP,
+                const char* name );
+
+            /// @brief Передача данных, поставленных в очередь @ref push.
+            void send_pushes();
+
+            u_int last_connection_id = 0;
+
+            /// @brief Данные для передачи по инициативе PAC (кадр PUSH_DATA)
+            /// для каждого соединения сервера. Защищены push_mutex - данные
+            /// ставятся в очередь управляющим потоком, передаются потоком
+            /// обмена.
+            std::map< u_int, std::vector< u_char > > push_data;
+            mutable std::mutex push_mutex;
+
             /// @brief Инициализация сети.
             int  net_init();
 
             /// @brief Закрытие сети.
             void net_terminate();
 
+            /// @brief Одна итерация обработки сокетов: ожидание событий,
+            /// подключение клиентов, прием запросов и отправка ответов.
+            ///
+            /// Ожидаются только события (epoll) - затраты не зависят от
+            /// количества неактивных соединений.
+            ///
+            /// @param timeout_ms       - время ожидания событий, мс.
+            /// @param is_async_clients - обрабатывать асинхронных клиентов.
+            ///
+            /// @return - количество событий и обработанных запросов
+            /// (0 - событий нет).
+            int process_sockets( int timeout_ms, bool is_async_clients );
+
+            /// @brief Обработка событий асинхронных клиентов (без ожидания).
+            void process_async_clients();
+
+            enum CONSTANTS
+                {
+                /// Время ожидания событий сокетов потоком обмена, мс.
+                C_COMM_THREAD_WAIT_TIMEOUT_MS = 10,
+
+                /// Максимальное количество событий за одно ожидание.
+                C_MAX_EVENTS = 64,
+
+                /// Максимальное количество буферов очереди за одну передачу.
+                C_MAX_IOV = 16,
+
+                /// Размер заголовка кадра.
+                C_FRAME_HEADER_SIZE = 6,
+
+                /// Начальный размер буфера приема соединения.
+                C_RECV_BUFF_SIZE = 4096,
+
+                /// Длина очереди подключений сокетов-слушателей.
+                C_LISTEN_QUEUE_LEN = SOMAXCONN,
+                };
+
+            /// @brief Поток обмена с сервером.
+            ///
+            /// Поток выполняет сетевой обмен (прием запросов, отправку
+            /// ответов), поэтому медленный клиент не увеличивает время
+            /// управляющего цикла. Сервисы работают с устройствами и Lua,
+            /// поэтому выполняются управляющим потоком: поток обмена ставит
+            /// принятые запросы в очередь (@ref requests) и продолжает обмен
+            /// с остальными соединениями, управляющий поток выполняет всю
+            /// очередь при вызове @ref evaluate - между этапами управляющего
+            /// цикла, по согласованному состоянию устройств.
+            std::thread comm_thread;
+            mutable std::mutex comm_mutex;
+
+            /// @brief Запрос сервиса, выполняемый управляющим потоком.
+            struct service_request
+                {
+                u_int key;           ///< Сокет (@ref socket_state::key).
+                u_int connection_id; ///< Соединение (@ref socket_state::id).
+                srv_ptr srv;
+
+                std::vector< u_char > frame; ///< Кадр запроса, затем ответа.
+                };
+
+            // Данные ниже защищены comm_mutex.
+            std::deque< service_request > requests; ///< Ожидают выполнения.
+            std::deque< service_request > answers;  ///< Ожидают передачи.
+
+            std::atomic< bool > is_comm_thread_running{ false };
+
+            /// Событие наличия ответов (пробуждение потока обмена).
+            int answers_event_fd = -1;
+
+            /// Буфер выполнения сервисов управляющим потоком.
+            std::vector< u_char > service_buff;
+
+            u_int last_socket_key = 0;
+
+            /// Признак выполнения в потоке обмена.
+            inline static thread_local bool is_comm_thread = false;
+
+            /// @brief Запуск/останов потока обмена в соответствии с параметром
+            /// @ref PAC_info::P_COMM_THREAD.
+            ///
+            /// @return - true - обмен выполняется потоком обмена.
+            bool check_comm_thread();
+
+            void start_comm_thread();
+            void stop_comm_thread();
+            void comm_thread_main();
+
+            /// @brief Постановка принятого кадра в очередь запросов
+            /// управляющего потока (поток обмена). Пока ответ не передан,
+            /// новые запросы соединения не принимаются.
+            void queue_service_request( int idx, srv_ptr srv,
+                u_int frame_size );
+
+            /// @brief Выполнение всех запросов очереди (управляющий поток).
+            void process_service_requests();
+
+            /// @brief Передача ответов, сформированных управляющим потоком.
+            void send_service_answers();
+
         public:
             static int sendall (int sockfd, unsigned char *buf, int len,
                 int sec, int usec, const char* IP, const char* name,
@@ -32,6 +32,7 @@
 #include "OPCUAServer.h"
 
 #include "main_cycle.h"
+#include "cycle_scheduler.h"
 
 int G_DEBUG = 0;                //Вывод дополнительной отладочной информации.
 
@@ -129,8 +130,19 @@ int main( int argc, const char *argv[] )
     //Инициализация дополнительных устройств
     IOT_INIT();
 
-    G_LOG->info( "Starting main loop! Sleep time is %u ms.",
-        G_PROJECT_MANAGER->sleep_time_ms );
+    cycle_scheduler::setup_current_thread( G_PROJECT_MANAGER->cpu_core,
+        G_PROJECT_MANAGER->rt_priority );
+
+    if ( auto period = G_PAC_INFO()->par[ PAC_info::P_MAIN_CYCLE_PERIOD ];
+        period > 0 )
+        {
+        G_LOG->info( "Starting main loop! Cycle period is %u ms.", period );
+        }
+    else
+        {
+        G_LOG->info( "Starting main loop! Sleep time is %u ms.",
+            G_PROJECT_MANAGER->sleep_time_ms );
+        }
 
     while ( running )
         {
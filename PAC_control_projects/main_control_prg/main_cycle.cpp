@@ -9,6 +9,10 @@
 #include "PAC_info.h"
 #include "PAC_err.h"
 #include "iot_common.h"
+#include "cycle_profiler.h"
+#include "cycle_scheduler.h"
+#include "lua_gc_controller.h"
+#include "g_device.h"
 
 #include "OPCUAServer.h"
 
@@ -16,6 +20,16 @@
 extern bool G_NO_IO_NODES;
 extern bool G_READ_ONLY_IO_NODES;
 
+/// @brief Ожидание после этапа цикла (если не задан период цикла - при
+/// заданном периоде ожидание выполняется один раз в конце цикла).
+static void idle()
+    {
+    if ( !G_CYCLE_SCHEDULER()->is_active() )
+        {
+        sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+        }
+    }
+
 int main_cycle()
     {
 #ifdef TEST_SPEED
@@ -28,50 +42,109 @@ int main_cycle()
     cycles_cnt++;
 #endif // TEST_SPEED
 
+    auto profiler = G_CYCLE_PROFILER();
+    profiler->start_cycle();
+
+    auto scheduler = G_CYCLE_SCHEDULER();
+    scheduler->set_period(
+        G_PAC_INFO()->par[ PAC_info::P_MAIN_CYCLE_PERIOD ] );
+    scheduler->set_task_period( cycle_scheduler::TC_FAST,
+        G_PAC_INFO()->par[ PAC_info::P_FAST_TASKS_PERIOD ] );
+    scheduler->set_task_period( cycle_scheduler::TC_NORMAL,
+        G_PAC_INFO()->par[ PAC_info::P_NORMAL_TASKS_PERIOD ] );
+    scheduler->set_task_period( cycle_scheduler::TC_SLOW,
+        G_PAC_INFO()->par[ PAC_info::P_SLOW_TASKS_PERIOD ] );
+
+    auto is_fast = scheduler->is_task_due( cycle_scheduler::TC_FAST );
+    auto is_normal = scheduler->is_task_due( cycle_scheduler::TC_NORMAL );
+    auto is_slow = scheduler->is_task_due( cycle_scheduler::TC_SLOW );
+
     if ( G_DEBUG )
         {
         fflush( stdout );
         }
 
-    lua_gc( G_LUA_MANAGER->get_Lua(), LUA_GCSTEP, 200 );
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    if ( is_normal )
+        {
+        // Свободное время цикла - по времени работы предыдущего цикла.
+        auto gc_slack = lua_gc_controller::NO_SLACK_LIMIT;
+        if ( scheduler->is_active() )
+            {
+            uint32_t period = scheduler->get_period() * 1000;
+            auto work_time = profiler->get_last_cycle_work_time();
+            gc_slack = period > work_time ? period - work_time : 0;
+            }
+        G_LUA_GC_CONTROLLER()->step( G_LUA_MANAGER->get_Lua(), gc_slack );
+        }
+    profiler->end_phase( cycle_profiler::PH_LUA_GC );
+    idle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
 
-    if ( !G_NO_IO_NODES ) G_IO_MANAGER()->read_inputs();
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    if ( is_fast && !G_NO_IO_NODES ) G_IO_MANAGER()->read_inputs();
+    profiler->end_phase( cycle_profiler::PH_READ_INPUTS );
+    idle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
 
-    G_DEVICE_MANAGER()->evaluate_io();
+    if ( is_fast ) G_DEVICE_MANAGER()->evaluate_io();
+    profiler->end_phase( cycle_profiler::PH_EVALUATE_IO );
 
-    valve::evaluate();
+    if ( is_fast ) valve::evaluate();
+    profiler->end_phase( cycle_profiler::PH_VALVES );
 
-    G_TECH_OBJECT_MNGR()->evaluate();
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    if ( is_normal ) G_TECH_OBJECT_MNGR()->evaluate();
+    profiler->end_phase( cycle_profiler::PH_TECH_OBJECTS );
+    idle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
 
-    if ( !G_NO_IO_NODES &&
+    if ( is_fast && !G_NO_IO_NODES &&
         !G_READ_ONLY_IO_NODES ) G_IO_MANAGER()->write_outputs();
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    profiler->end_phase( cycle_profiler::PH_WRITE_OUTPUTS );
+    idle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
+
+    if ( is_normal )
+        {
+        G_DEVICE_CMMCTR->evaluate_subscriptions();
 
-    G_CMMCTR->evaluate();
+        // Одинаковые запросы клиентов в цикле - одним ответом.
+        G_DEVICE_CMMCTR->start_answers_cache();
+        G_CMMCTR->evaluate();
+        G_DEVICE_CMMCTR->stop_answers_cache();
+        }
+    profiler->end_phase( cycle_profiler::PH_COMMUNICATION );
 
-    params_manager::get_instance()->evaluate();
+    if ( is_slow ) params_manager::get_instance()->evaluate();
+    profiler->end_phase( cycle_profiler::PH_PARAMS );
 
-    if ( G_PAC_INFO()->par[ PAC_info::P_IS_OPC_UA_SERVER_ACTIVE ] == 1 )
+    if ( is_normal &&
+        G_PAC_INFO()->par[ PAC_info::P_IS_OPC_UA_SERVER_ACTIVE ] == 1 )
         {
         G_OPCUA_SERVER.evaluate();
         }
+    profiler->end_phase( cycle_profiler::PH_OPC_UA );
 
     //Основной цикл работы с дополнительными устройствами
-    if ( !G_NO_IO_NODES && !G_READ_ONLY_IO_NODES )
+    if ( is_normal && !G_NO_IO_NODES && !G_READ_ONLY_IO_NODES )
         {
         IOT_EVALUATE();
         }
+    profiler->end_phase( cycle_profiler::PH_IOT );
 
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    idle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
 
-    PAC_info::get_instance()->eval();
-    PAC_critical_errors_manager::get_instance()->show_errors();
-    G_ERRORS_MANAGER->evaluate();
-    G_SIREN_LIGHTS_MANAGER()->eval();
-    sleep_ms( G_PROJECT_MANAGER->sleep_time_ms );
+    if ( is_slow )
+        {
+        PAC_info::get_instance()->eval();
+        PAC_critical_errors_manager::get_instance()->show_errors();
+        G_ERRORS_MANAGER->evaluate();
+        G_SIREN_LIGHTS_MANAGER()->eval();
+        }
+    profiler->end_phase( cycle_profiler::PH_ERRORS );
+    idle();
+    scheduler->wait_next_cycle();
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
+    profiler->end_cycle();
 
 #ifdef TEST_SPEED
     u_int TRESH_AVG =
@@ -1,5 +1,9 @@
 #include <cstring>
 #include <cstdio>
+#include <cctype>
+#include <ctime>
+#include <string_view>
+#include <algorithm>
 
 #include "g_device.h"
 
@@ -11,16 +15,47 @@
 #include "lua_manager.h"
 #include "tech_def.h"
 #include "params_recipe_manager.h"
+#include "cycle_profiler.h"
+#include "PAC_info.h"
+#include "device/manager.h"
 
 char device_communicator::buff[ tcp_communicator::BUFSIZE ];
 
 auto_smart_ptr < device_communicator > device_communicator::instance;
 
-const u_int_2 G_CURRENT_PROTOCOL_VERSION = 104;
+/// 105 - CMD_GET_DEVICES_STATES_DELTA.
+/// 106 - двоичное представление состояния устройств (ENC_BINARY).
+/// 107 - CMD_GET_COMPRESSION_DICTIONARY.
+/// 108 - подписка на изменения состояния устройств
+/// (CMD_SUBSCRIBE_DEVICES_STATES).
+/// 109 - CMD_EXEC_DEVICE_COMMANDS.
+const u_int_2 G_CURRENT_PROTOCOL_VERSION = 109;
 
 std::vector< i_Lua_save_device* > device_communicator::dev;
 
 bool device_communicator::use_compression = true;
+
+z_stream device_communicator::compression_stream{};
+bool device_communicator::is_compression_stream_init = false;
+int device_communicator::compression_level = Z_DEFAULT_COMPRESSION;
+int device_communicator::compression_strategy = Z_DEFAULT_STRATEGY;
+
+std::string device_communicator::compression_dictionary;
+uint32_t device_communicator::compression_dictionary_id = 0;
+size_t device_communicator::compression_dictionary_key = 0;
+
+std::vector< device_communicator::subscription >
+    device_communicator::subscriptions;
+std::vector< u_char > device_communicator::push_buff;
+std::vector< device_communicator::cached_answer >
+    device_communicator::answers_cache;
+bool device_communicator::is_answers_cache_active = false;
+
+devices_states_delta device_communicator::states_delta;
+
+uint32_t device_communicator::states_schema_id = 0;
+std::vector< int > device_communicator::states_schema_fields_count;
+u_int device_communicator::states_schema_config_version = 0;
 //-----------------------------------------------------------------------------
 void print_str( const char *err_str, char is_need_CR )
     {
@@ -45,6 +80,43 @@ long device_communicator::write_devices_states_service(
 
     u_int answer_size = 0;
 
+    auto is_cacheable = false;
+    std::vector< u_char > cached_request;
+    if ( is_answers_cache_active )
+        {
+        switch ( data[ 0 ] )
+            {
+            case CMD_GET_DEVICES_STATES:
+            case CMD_GET_PAC_ERRORS:
+                answer_size = get_cached_answer( len, data, outdata );
+                if ( answer_size > 0 )
+                    {
+                    return answer_size;
+                    }
+                is_cacheable = true;
+                // Буфер ответа перекрывает буфер запроса (выходной буфер
+                // смещен на байт назад) - запрос сохраняется до формирования
+                // ответа.
+                cached_request.assign( data, data + len );
+                break;
+
+            case CMD_EXEC_DEVICE_COMMAND:
+            case CMD_EXEC_DEVICE_COMMANDS:
+            case CMD_SET_PAC_ERROR_CMD:
+            case CMD_RESTORE_PARAMS:
+                // Состояние изменяется - сохраненные ответы устарели.
+                answers_cache.clear();
+                break;
+            }
+        }
+
+    // При сжатии ответ формируется во временном буфере и сжимается сразу в
+    // выходной буфер. Другой буфер используется как временный при
+    // формировании ответа (параметры запроса к этому моменту прочитаны).
+    auto answer = use_compression ? reinterpret_cast<u_char*>( buff ) : outdata;
+    auto tmp_buff = use_compression ? reinterpret_cast<char*>( outdata ) : buff;
+    auto use_dictionary = false;
+
 #ifdef DEBUG_DEV_CMCTR
     uint32_t start_time = get_millisec();
 #endif // DEBUG_DEV_CMCTR
@@ -55,7 +127,7 @@ long device_communicator::write_devices_states_service(
     switch ( data[ 0 ] )
         {
         case CMD_GET_INFO_ON_CONNECT:
-            answer_size = sprintf( ( char* ) outdata,
+            answer_size = sprintf( ( char* ) answer,
                 "protocol_version = %d; PAC_name = \"%s\"; is_reset_params = %d;"
                 "params_CRC=%d;\n",
                 G_CURRENT_PROTOCOL_VERSION,
@@ -80,20 +152,28 @@ long device_communicator::write_devices_states_service(
                 memcpy( &g_devices_request_id, data + 1, param_size );
                 }
 
-            memcpy( outdata, &g_devices_request_id, param_size );
+            auto is_binary = len > 1 + static_cast<long>( param_size ) &&
+                ENC_BINARY == data[ 1 + param_size ];
+
+            memcpy( answer, &g_devices_request_id, param_size );
             answer_size += param_size;
 
             for ( u_int i = 0; i < dev.size(); i++ )
                 {
-                answer_size += dev[ i ]->save_device( ( char* ) outdata +
+                answer_size += dev[ i ]->save_device( ( char* ) answer +
                     answer_size );
                 }
-            outdata[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
+            if ( is_binary )
+                {
+                answer_size += save_states_schema( ( char* ) answer +
+                    answer_size, tmp_buff );
+                }
+            answer[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
 
 #ifdef DEBUG_DEV_CMCTR
             if ( answer_size < 40000 ) //Вывод больших строк тормозит работу.
                 {
-                std::string source = ( char* ) outdata + 2;
+                std::string source = ( char* ) answer + 2;
                 for ( u_int i = 0; i < source.length(); i++ )
                     {
                     if ( source[ i ] == '\t' )
@@ -116,19 +196,30 @@ long device_communicator::write_devices_states_service(
 
         case CMD_GET_DEVICES_STATES:
             {
+            auto is_binary = len > 1 && ENC_BINARY == data[ 1 ];
+            use_dictionary = G_PAC_INFO()->par[
+                PAC_info::P_COMPRESSION_DICTIONARY ] && use_compression;
+
             param_size = sizeof( g_devices_request_id );
-            memcpy( outdata, &g_devices_request_id, param_size );
+            memcpy( answer, &g_devices_request_id, param_size );
             answer_size += param_size;
 
-            for ( u_int i = 0; i < dev.size(); i++ )
+            if ( is_binary )
                 {
-                answer_size += dev[ i ]->save_device( ( char* ) outdata +
-                    answer_size );
+                answer_size += save_states_binary( answer + answer_size );
+                }
+            else
+                {
+                for ( u_int i = 0; i < dev.size(); i++ )
+                    {
+                    answer_size += dev[ i ]->save_device( ( char* ) answer +
+                        answer_size );
+                    }
                 }
-            outdata[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
+            answer[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
 
 #ifdef DEBUG_DEV_CMCTR
-            //printf( "%s", outdata + 2 );
+            //printf( "%s", answer + 2 );
 #endif // DEBUG_DEV_CMCTR
 
 #ifdef DEBUG_DEV_CMCTR
@@ -140,29 +231,62 @@ long device_communicator::write_devices_states_service(
             break;
             }
 
+        case CMD_GET_DEVICES_STATES_DELTA:
+            {
+            uint32_t session_id = 0;
+            uint32_t last_seq = 0;
+            if ( len >= 1 + 2 * static_cast<long>( sizeof( uint32_t ) ) )
+                {
+                memcpy( &session_id, data + 1, sizeof( session_id ) );
+                memcpy( &last_seq, data + 1 + sizeof( session_id ),
+                    sizeof( last_seq ) );
+                }
+
+            use_dictionary = G_PAC_INFO()->par[
+                PAC_info::P_COMPRESSION_DICTIONARY ] && use_compression;
+            states_delta.update( dev, tmp_buff );
+
+            memcpy( answer, &g_devices_request_id,
+                sizeof( g_devices_request_id ) );
+            answer_size += sizeof( g_devices_request_id );
+            auto new_session_id = states_delta.get_session_id();
+            memcpy( answer + answer_size, &new_session_id,
+                sizeof( new_session_id ) );
+            answer_size += sizeof( new_session_id );
+            auto seq = states_delta.get_seq();
+            memcpy( answer + answer_size, &seq, sizeof( seq ) );
+            answer_size += sizeof( seq );
+
+            auto is_full = false;
+            auto is_full_pos = answer_size++;
+            answer_size += states_delta.save_changes( session_id, last_seq,
+                reinterpret_cast<char*>( answer ) + answer_size, is_full );
+            answer[ is_full_pos ] = is_full ? 1 : 0;
+            answer[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
+
+#ifdef DEBUG_DEV_CMCTR
+            printf( "Devices states delta size = %u, seq = %u, full = %d\n",
+                answer_size, seq, is_full );
+
+            printf( "Operation time = %lu\n", get_delta_millisec( start_time ) );
+#endif // DEBUG_DEV_CMCTR
+            break;
+            }
+
         case CMD_EXEC_DEVICE_COMMAND:
             {
 #ifdef DEBUG_DEV_CMCTR
             printf( "\nEXEC_DEVICE_CMD\n" );
             printf( "cmd = %s\n",  data + 1 );
 #endif // DEBUG_DEV_CMCTR
-            int res;
-            auto str = reinterpret_cast<char*>( data + 1 );
-            if ( strstr( str, "__RECMAN" ) != nullptr )
-                {
-                res = G_PARAMS_RECIPE_MANAGER()->parseDriverCmd( str );
-                }
-            else
-                {
-                res = lua_manager::get_instance()->exec_Lua_str( 
-                    str, "CMD_EXEC_DEVICE_COMMAND " );
-                }
+            auto res = exec_device_command(
+                reinterpret_cast<char*>( data + 1 ) );
 
-            outdata[ 0 ] = 0;
-            outdata[ 1 ] = 0; //Возвращаем 0.
+            answer[ 0 ] = 0;
+            answer[ 1 ] = 0; //Возвращаем 0.
             if ( res )
                 {
-                outdata[ 0 ] = 1;
+                answer[ 0 ] = 1;
                 }
 
 #ifdef DEBUG_DEV_CMCTR
@@ -173,6 +297,33 @@ long device_communicator::write_devices_states_service(
             break;
             }
 
+        case CMD_EXEC_DEVICE_COMMANDS:
+            {
+            u_int_2 errors_count = 0;
+            auto str = reinterpret_cast<char*>( data + 1 );
+            auto end = reinterpret_cast<char*>( data + len );
+            while ( str < end )
+                {
+                auto str_end = static_cast<char*>(
+                    memchr( str, '\0', end - str ) );
+                if ( !str_end )
+                    {
+                    errors_count++; // Команда без завершающего \0.
+                    break;
+                    }
+
+                if ( str_end > str && exec_device_command( str ) )
+                    {
+                    errors_count++;
+                    }
+                str = str_end + 1;
+                }
+
+            memcpy( answer, &errors_count, sizeof( errors_count ) );
+            answer_size = sizeof( errors_count );
+            break;
+            }
+
         case CMD_GET_PAC_ERRORS:
             {
 #ifdef DEBUG_DEV_CMCTR
@@ -181,7 +332,7 @@ long device_communicator::write_devices_states_service(
             static u_int_2 errors_id = get_millisec() % 100;
 
             unsigned char project_descr_id = data[ 1 ];
-            char *str = ( char* ) outdata;
+            char *str = ( char* ) answer;
             str[ 0 ] = 0;
 
             answer_size = sprintf( str, "alarms[ %d ] = \n  {}",
@@ -220,7 +371,7 @@ long device_communicator::write_devices_states_service(
             answer_size += sprintf( str + answer_size, "  %s\n", "}" );
 
 #ifdef DEBUG_DEV_CMCTR
-            printf( "Critical errors = \n%s", outdata );
+            printf( "Critical errors = \n%s", answer );
 #endif // DEBUG_DEV_CMCTR
 
             str[ answer_size++ ] = '\0'; // Учитываем завершающий \0.
@@ -237,11 +388,11 @@ long device_communicator::write_devices_states_service(
             int res = lua_manager::get_instance()->exec_Lua_str( ( char* ) data + 1,
                 "CMD_EXEC_DEVICE_COMMAND ");
 
-            outdata[ 0 ] = 0;
-            outdata[ 1 ] = 0; //Возвращаем 0.
+            answer[ 0 ] = 0;
+            answer[ 1 ] = 0; //Возвращаем 0.
             if ( res )
                 {
-                outdata[ 0 ] = 1;
+                answer[ 0 ] = 1;
                 }
 
 #ifdef DEBUG_DEV_CMCTR
@@ -254,7 +405,7 @@ long device_communicator::write_devices_states_service(
 
         case CMD_GET_PARAMS:
             answer_size = params_manager::get_instance()->save_params_as_Lua_str(
-                ( char* ) outdata );
+                ( char* ) answer );
             answer_size++; // Учитываем завершающий \0.
             break;
 
@@ -268,11 +419,11 @@ long device_communicator::write_devices_states_service(
             int res = params_manager::get_instance(
                 )->restore_params_from_server_backup( ( char*) data + 1 );
 
-            outdata[ 0 ] = 0;
-            outdata[ 1 ] = 0; //Возвращаем 0.
+            answer[ 0 ] = 0;
+            answer[ 1 ] = 0; //Возвращаем 0.
             if ( res )
                 {
-                outdata[ 0 ] = 1;
+                answer[ 0 ] = 1;
                 }
 
 #ifdef DEBUG_DEV_CMCTR
@@ -284,25 +435,111 @@ long device_communicator::write_devices_states_service(
             }
 
         case CMD_GET_PARAMS_CRC:
-            answer_size = sprintf( ( char* ) outdata, "params_CRC=%d; request_id=%d\n",
+            answer_size = sprintf( ( char* ) answer, "params_CRC=%d; request_id=%d\n",
                 params_manager::get_instance()->solve_CRC(),
                 g_devices_request_id );
             answer_size++; // Учитываем завершающий \0.
             break;
+
+        case CMD_GET_CYCLE_PROFILE:
+            {
+            auto is_reset = len > 1 && data[ 1 ];
+            answer_size = G_CYCLE_PROFILER()->save_as_Lua_str(
+                ( char* ) answer, tcp_communicator::BUFSIZE );
+            answer_size++; // Учитываем завершающий \0.
+
+            if ( is_reset )
+                {
+                G_CYCLE_PROFILER()->reset();
+                }
+            break;
+            }
+
+        case CMD_SUBSCRIBE_DEVICES_STATES:
+            {
+            subscription sub{ G_CMMCTR->get_service_connection_id(), 0 };
+            if ( len >= 3 )
+                {
+                sub.period_ms = data[ 1 ] + 256 * data[ 2 ];
+                }
+            if ( len > 3 )
+                {
+                std::string names( reinterpret_cast<char*>( data + 3 ),
+                    strnlen( reinterpret_cast<char*>( data + 3 ), len - 3 ) );
+                size_t pos = 0;
+                while ( ( pos = names.find_first_not_of( ' ', pos ) ) !=
+                    std::string::npos )
+                    {
+                    auto end = names.find( ' ', pos );
+                    sub.filter.push_back( names.substr( pos, end - pos ) );
+                    pos = end;
+                    }
+                }
+
+            answer[ 0 ] = 0;
+            answer[ 1 ] = 0; //Возвращаем 0.
+            if ( 0 == sub.connection_id )
+                {
+                answer[ 0 ] = 1;
+                }
+            else
+                {
+                auto it = std::find_if( subscriptions.begin(),
+                    subscriptions.end(), [ &sub ]( const subscription& s )
+                    {
+                    return s.connection_id == sub.connection_id;
+                    } );
+                if ( it != subscriptions.end() )
+                    {
+                    *it = sub;
+                    }
+                else
+                    {
+                    subscriptions.push_back( sub );
+                    }
+                }
+
+            answer_size = 2;
+            break;
+            }
+
+        case CMD_UNSUBSCRIBE_DEVICES_STATES:
+            {
+            auto connection_id = G_CMMCTR->get_service_connection_id();
+            subscriptions.erase( std::remove_if( subscriptions.begin(),
+                subscriptions.end(), [ connection_id ]( const subscription& s )
+                {
+                return s.connection_id == connection_id;
+                } ), subscriptions.end() );
+
+            answer[ 0 ] = 0;
+            answer[ 1 ] = 0; //Возвращаем 0.
+            answer_size = 2;
+            break;
+            }
+
+        case CMD_GET_COMPRESSION_DICTIONARY:
+            update_compression_dictionary( tmp_buff );
+
+            memcpy( answer, &compression_dictionary_id,
+                sizeof( compression_dictionary_id ) );
+            answer_size += sizeof( compression_dictionary_id );
+            memcpy( answer + answer_size, compression_dictionary.c_str(),
+                compression_dictionary.size() + 1 );
+            answer_size += compression_dictionary.size() + 1;
+            break;
         }
 
 
     if ( answer_size > 0 && use_compression )
         {
-        unsigned long r = sizeof( buff );
-        int res = compress( (u_char*)buff, &r, outdata, answer_size );
-
-        if ( res == Z_OK && r > 0 )
+        if ( use_dictionary )
             {
-            memcpy( outdata, buff, r );
-            answer_size = r;
+            update_compression_dictionary( tmp_buff );
             }
-        else
+        answer_size = compress_answer( answer, answer_size, outdata,
+            use_dictionary );
+        if ( 0 == answer_size )
             {
             outdata[ 0 ] = 0;
             outdata[ 1 ] = 0; //Возвращаем 0.
@@ -311,9 +548,540 @@ long device_communicator::write_devices_states_service(
             }
         }
 
+    if ( is_cacheable && answer_size > 0 )
+        {
+        answers_cache.push_back( { std::move( cached_request ),
+            std::vector< u_char >( outdata, outdata + answer_size ) } );
+        }
+
     return answer_size;
     }
 //-----------------------------------------------------------------------------
+u_int device_communicator::get_cached_answer( long len, const u_char* data,
+    u_char* outdata )
+    {
+    for ( const auto& item : answers_cache )
+        {
+        if ( item.request.size() == static_cast<size_t>( len ) &&
+            std::equal( item.request.begin(), item.request.end(), data ) )
+            {
+            // Буфер запроса и ответа совпадают со смещением - запрос
+            // сравнивается до записи ответа.
+            memcpy( outdata, item.answer.data(), item.answer.size() );
+            return static_cast<u_int>( item.answer.size() );
+            }
+        }
+
+    return 0;
+    }
+//-----------------------------------------------------------------------------
+void device_communicator::start_answers_cache()
+    {
+    is_answers_cache_active = true;
+    }
+//-----------------------------------------------------------------------------
+void device_communicator::stop_answers_cache()
+    {
+    is_answers_cache_active = false;
+    answers_cache.clear();
+    }
+//-----------------------------------------------------------------------------
+void device_communicator::clear_answers_cache()
+    {
+    answers_cache.clear();
+    }
+//-----------------------------------------------------------------------------
+u_int device_communicator::compress_answer( u_char* src, u_int size,
+    u_char* out, bool use_dictionary )
+    {
+    auto& par = G_PAC_INFO()->par;
+    int level = par[ PAC_info::P_COMPRESSION_LEVEL ];
+    if ( level < 1 || level > Z_BEST_COMPRESSION )
+        {
+        level = Z_DEFAULT_COMPRESSION;
+        }
+    int strategy = par[ PAC_info::P_COMPRESSION_STRATEGY ];
+    if ( strategy < Z_DEFAULT_STRATEGY || strategy > Z_FIXED )
+        {
+        strategy = Z_DEFAULT_STRATEGY;
+        }
+
+    auto& strm = compression_stream;
+    if ( !is_compression_stream_init )
+        {
+        // Поток создается один раз - без выделения памяти для каждого ответа.
+        if ( deflateInit2( &strm, level, Z_DEFLATED, MAX_WBITS, 8,
+            strategy ) != Z_OK )
+            {
+            return 0;
+            }
+        is_compression_stream_init = true;
+        compression_level = level;
+        compression_strategy = strategy;
+        }
+    else
+        {
+        deflateReset( &strm );
+        if ( level != compression_level || strategy != compression_strategy )
+            {
+            if ( deflateParams( &strm, level, strategy ) != Z_OK )
+                {
+                return 0;
+                }
+            compression_level = level;
+            compression_strategy = strategy;
+            }
+        }
+
+    if ( use_dictionary && deflateSetDictionary( &strm,
+        reinterpret_cast<const Bytef*>( compression_dictionary.c_str() ),
+        static_cast<uInt>( compression_dictionary.size() ) ) != Z_OK )
+        {
+        return 0;
+        }
+
+    strm.next_in = src;
+    strm.avail_in = size;
+    strm.next_out = out;
+    strm.avail_out = tcp_communicator::BUFSIZE;
+    if ( deflate( &strm, Z_FINISH ) != Z_STREAM_END )
+        {
+        return 0;
+        }
+
+    return static_cast<u_int>( strm.total_out );
+    }
+//-----------------------------------------------------------------------------
+void device_communicator::update_compression_dictionary( char* tmp_buff )
+    {
+    auto key = dev.size() * 100000 + G_DEVICE_MANAGER()->get_device_count();
+    if ( !compression_dictionary.empty() && key == compression_dictionary_key )
+        {
+        return;
+        }
+
+    // Словарь - состояние устройств на момент формирования (в словаре zlib
+    // используется не более 32 Кб).
+    const size_t MAX_DICTIONARY_SIZE = 32768;
+    compression_dictionary.clear();
+    for ( auto d : dev )
+        {
+        auto size = d->save_device( tmp_buff );
+        compression_dictionary.append( tmp_buff, std::min<size_t>( size,
+            MAX_DICTIONARY_SIZE - compression_dictionary.size() ) );
+        if ( compression_dictionary.size() >= MAX_DICTIONARY_SIZE )
+            {
+            break;
+            }
+        }
+
+    compression_dictionary_id = static_cast<uint32_t>( adler32( 1,
+        reinterpret_cast<const Bytef*>( compression_dictionary.c_str() ),
+        static_cast<uInt>( compression_dictionary.size() ) ) );
+    compression_dictionary_key = key;
+    }
+//-----------------------------------------------------------------------------
+int device_communicator::exec_device_command( const char* str )
+    {
+    if ( strstr( str, "__RECMAN" ) != nullptr )
+        {
+        return G_PARAMS_RECIPE_MANAGER()->parseDriverCmd( str ) ? 0 : 1;
+        }
+
+    // Результат set_cmd не учитывается - как и при выполнении Lua.
+    if ( device_set_cmd cmd; cmd.parse( str ) && cmd.exec() )
+        {
+        return 0;
+        }
+
+    return lua_manager::get_instance()->exec_Lua_str( str,
+        "CMD_EXEC_DEVICE_COMMAND " );
+    }
+//-----------------------------------------------------------------------------
+bool device_set_cmd::parse( const char* str )
+    {
+    auto p = str;
+    auto skip_spaces = [ &p ]()
+        {
+        while ( isspace( static_cast<u_char>( *p ) ) ) p++;
+        };
+    auto skip_name = [ &p ]()
+        {
+        while ( isalnum( static_cast<u_char>( *p ) ) || '_' == *p ) p++;
+        };
+    auto skip_char = [ &p, &skip_spaces ]( char c )
+        {
+        skip_spaces();
+        if ( *p != c )
+            {
+            return false;
+            }
+        p++;
+        skip_spaces();
+        return true;
+        };
+
+    skip_spaces();
+    is_table_name = strncmp( p, "t.", 2 ) == 0;
+    if ( is_table_name || strncmp( p, "__", 2 ) == 0 )
+        {
+        p += 2;
+        }
+    auto name_start = p;
+    skip_name();
+    if ( p == name_start )
+        {
+        return false;
+        }
+    name.assign( name_start, p - name_start );
+
+    if ( !skip_char( ':' ) || strncmp( p, "set_cmd", 7 ) != 0 )
+        {
+        return false;
+        }
+    p += 7;
+    if ( !skip_char( '(' ) )
+        {
+        return false;
+        }
+
+    // Имя свойства.
+    auto quote = *p;
+    if ( quote != '"' && quote != '\'' )
+        {
+        return false;
+        }
+    auto prop_start = ++p;
+    skip_name();
+    auto prop_size = p - prop_start;
+    if ( *p != quote || 0 == prop_size || prop_size > C_MAX_PROP_LENGTH )
+        {
+        return false;
+        }
+    memcpy( prop, prop_start, prop_size );
+    prop[ prop_size ] = '\0';
+    p++;
+
+    // Индекс и значение (числа, иначе - выполнение Lua).
+    if ( !skip_char( ',' ) || !isdigit( static_cast<u_char>( *p ) ) )
+        {
+        return false;
+        }
+    char* end;
+    idx = strtoul( p, &end, 10 );
+    p = end;
+
+    if ( !skip_char( ',' ) )
+        {
+        return false;
+        }
+    auto num_start = '-' == *p ? p + 1 : p;
+    if ( !isdigit( static_cast<u_char>( *num_start ) ) && *num_start != '.' )
+        {
+        return false;
+        }
+    val = strtod( p, &end );
+    if ( end == p )
+        {
+        return false;
+        }
+    p = end;
+
+    if ( !skip_char( ')' ) )
+        {
+        return false;
+        }
+    if ( ';' == *p )
+        {
+        p++;
+        skip_spaces();
+        }
+
+    return '\0' == *p;
+    }
+//-----------------------------------------------------------------------------
+bool device_set_cmd::exec() const
+    {
+    if ( is_table_name && name == "SYSTEM" )
+        {
+        G_PAC_INFO()->set_cmd( prop, idx, val );
+        return true;
+        }
+
+    if ( !is_table_name )
+        {
+        auto dev_manager = G_DEVICE_MANAGER();
+        auto is_logging_disabled = dev_manager->disable_error_logging;
+        dev_manager->disable_error_logging = true;
+        auto dev = dev_manager->get_device( name.c_str() );
+        dev_manager->disable_error_logging = is_logging_disabled;
+
+        if ( dev != dev_manager->get_stub_device() )
+            {
+            dev->set_cmd( prop, idx, val );
+            return true;
+            }
+        }
+
+    auto objects = G_TECH_OBJECT_MNGR();
+    for ( u_int i = 0; i < objects->get_count(); i++ )
+        {
+        auto obj = objects->get_tech_objects( i );
+        if ( name == obj->get_name_in_Lua() )
+            {
+            obj->set_cmd( prop, idx, val );
+            return true;
+            }
+        }
+
+    return false;
+    }
+//-----------------------------------------------------------------------------
+devices_states_delta::devices_states_delta() :
+    session_id( static_cast<uint32_t>( time( nullptr ) ) )
+    {
+    }
+//-----------------------------------------------------------------------------
+void devices_states_delta::update( const std::vector< i_Lua_save_device* >& dev,
+    char* tmp_buff )
+    {
+    // Текущий состав устройств (устройства менеджера - по отдельности).
+    std::vector< std::pair< const i_Lua_save_device*, FRAGMENT_TYPE > > items;
+    for ( auto d : dev )
+        {
+        if ( d == G_DEVICE_MANAGER() )
+            {
+            items.emplace_back( d, FT_DEVICES_START );
+            auto count = G_DEVICE_MANAGER()->get_device_count();
+            for ( size_t i = 0; i < count; i++ )
+                {
+                items.emplace_back( G_DEVICE_MANAGER()->get_device( i ),
+                    FT_PROJECT_DEVICE );
+                }
+            }
+        else
+            {
+            items.emplace_back( d, FT_OBJECT );
+            }
+        }
+
+    auto is_structure_changed = items.size() != fragments.size();
+    for ( size_t i = 0; !is_structure_changed && i < items.size(); i++ )
+        {
+        is_structure_changed = items[ i ].first != fragments[ i ].dev ||
+            items[ i ].second != fragments[ i ].type;
+        }
+
+    auto new_seq = seq + 1;
+    auto is_changed = false;
+    if ( is_structure_changed )
+        {
+        fragments.clear();
+        fragments.reserve( items.size() );
+        for ( const auto& [ d, type ] : items )
+            {
+            fragments.push_back( { d, type, "", new_seq } );
+            }
+        full_seq = new_seq;
+        is_changed = true;
+        }
+
+    for ( auto& f : fragments )
+        {
+        if ( FT_DEVICES_START == f.type )
+            {
+            continue;
+            }
+
+        auto size = f.dev->save_device( tmp_buff );
+        if ( is_structure_changed || f.str.compare( 0, std::string::npos,
+            tmp_buff, size ) != 0 )
+            {
+            f.str.assign( tmp_buff, size );
+            f.seq = new_seq;
+            is_changed = true;
+            }
+        }
+
+    if ( is_changed )
+        {
+        seq = new_seq;
+        }
+    }
+//-----------------------------------------------------------------------------
+int devices_states_delta::save_changes( uint32_t client_session_id,
+    uint32_t last_seq, char* buff, bool& is_full,
+    const std::vector< std::string >* filter ) const
+    {
+    is_full = client_session_id != session_id || last_seq < full_seq ||
+        last_seq > seq;
+    auto min_seq = is_full ? 0 : last_seq;
+
+    // Устройства проекта сохраняются в таблицу t (полное состояние, как
+    // в device_manager::save_device) или t_delta (только изменения).
+    auto is_full_table = is_full && !filter;
+    std::string_view devices_start = is_full_table ?
+        "t=\n\t{\n" : "t_delta=\n\t{\n";
+    std::string_view devices_end = is_full_table ? "\t}\n" :
+        "\t}\nfor k, v in pairs( t_delta ) do t[ k ] = v end\n";
+
+    // Строка устройства проекта начинается с "ИМЯ=".
+    auto is_in_filter = [ filter ]( const std::string& str )
+        {
+        for ( const auto& name : *filter )
+            {
+            if ( str.size() > name.size() && str[ name.size() ] == '=' &&
+                str.compare( 0, name.size(), name ) == 0 )
+                {
+                return true;
+                }
+            }
+        return false;
+        };
+
+    auto res = 0;
+    auto is_devices_started = false;
+    auto save_str = [ & ]( std::string_view str )
+        {
+        memcpy( buff + res, str.data(), str.size() );
+        res += static_cast<int>( str.size() );
+        };
+    for ( const auto& f : fragments )
+        {
+        if ( is_devices_started && f.type != FT_PROJECT_DEVICE )
+            {
+            save_str( devices_end );
+            is_devices_started = false;
+            }
+
+        if ( FT_DEVICES_START == f.type )
+            {
+            if ( is_full_table )
+                {
+                save_str( devices_start );
+                is_devices_started = true;
+                }
+            continue;
+            }
+
+        if ( f.seq <= min_seq )
+            {
+            continue;
+            }
+
+        if ( filter && ( FT_OBJECT == f.type || !is_in_filter( f.str ) ) )
+            {
+            continue;
+            }
+
+        if ( FT_PROJECT_DEVICE == f.type )
+            {
+            if ( !is_devices_started )
+                {
+                save_str( devices_start );
+                is_devices_started = true;
+                }
+            buff[ res++ ] = '\t';
+            }
+        save_str( f.str );
+        }
+
+    if ( is_devices_started )
+        {
+        save_str( devices_end );
+        }
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+uint32_t devices_states_delta::get_session_id() const
+    {
+    return session_id;
+    }
+//-----------------------------------------------------------------------------
+uint32_t devices_states_delta::get_seq() const
+    {
+    return seq;
+    }
+//-----------------------------------------------------------------------------
+int device_communicator::save_states_schema( char* buff, char* tmp_buff )
+    {
+    auto res = sprintf( buff, "t_states_schema=\n\t{\n" );
+    auto schema_start = buff + res;
+
+    states_schema_fields_count.clear();
+    states_schema_config_version = G_DEVICE_MANAGER()->get_config_version();
+    std::vector< std::string > fields;
+    auto count = G_DEVICE_MANAGER()->get_device_count();
+    for ( size_t i = 0; i < count; i++ )
+        {
+        auto d = G_DEVICE_MANAGER()->get_device( i );
+        fields.clear();
+        binary_state_writer writer( tmp_buff, &fields );
+        d->save_device_binary( writer );
+        states_schema_fields_count.push_back( writer.get_fields_count() );
+
+        res += sprintf( buff + res, "\t{ '%s', ", d->get_name() );
+        for ( const auto& field : fields )
+            {
+            res += sprintf( buff + res, "'%s', ", field.c_str() );
+            }
+        res += sprintf( buff + res, "},\n" );
+        }
+    res += sprintf( buff + res, "\t}\n" );
+
+    // Идентификатор схемы - хэш FNV-1a (не 0).
+    uint32_t hash = 2166136261u;
+    for ( auto p = schema_start; p < buff + res; p++ )
+        {
+        hash = ( hash ^ static_cast<u_char>( *p ) ) * 16777619u;
+        }
+    states_schema_id = hash ? hash : 1;
+    res += sprintf( buff + res, "t_states_schema_id=%u\n", states_schema_id );
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
+int device_communicator::save_states_binary( u_char* buff )
+    {
+    auto out = reinterpret_cast<char*>( buff );
+    auto res = static_cast<int>( sizeof( states_schema_id ) );
+
+    auto count = G_DEVICE_MANAGER()->get_device_count();
+    // Схема устарела при изменении состава устройств (в том числе при
+    // замене устройства другим с тем же количеством полей).
+    auto is_schema_valid = count == states_schema_fields_count.size() &&
+        states_schema_config_version ==
+        G_DEVICE_MANAGER()->get_config_version();
+    res += binary_state_writer::write_varint( out + res,
+        static_cast<uint32_t>( count ) );
+    for ( size_t i = 0; i < count; i++ )
+        {
+        res += binary_state_writer::write_varint( out + res,
+            static_cast<uint32_t>( i ) );
+        binary_state_writer writer( out + res );
+        G_DEVICE_MANAGER()->get_device( i )->save_device_binary( writer );
+        res += writer.get_size();
+
+        is_schema_valid = is_schema_valid &&
+            writer.get_fields_count() == states_schema_fields_count[ i ];
+        }
+
+    uint32_t schema_id = is_schema_valid ? states_schema_id : 0;
+    memcpy( buff, &schema_id, sizeof( schema_id ) );
+
+    // Остальные устройства коммуникатора - скрипт Lua.
+    for ( auto d : dev )
+        {
+        if ( d != G_DEVICE_MANAGER() )
+            {
+            res += d->save_device( out + res );
+            }
+        }
+
+    return res;
+    }
+//-----------------------------------------------------------------------------
 int device_communicator::add_device( i_Lua_save_device *device )
     {
     dev.push_back( device );
@@ -326,6 +1094,129 @@ void device_communicator::clear_devices()
     dev.clear();
     }
 //-----------------------------------------------------------------------------
+bool device_communicator::is_subscription_due( const subscription& sub )
+    {
+    if ( sub.period_ms &&
+        get_delta_millisec( sub.last_push_time ) < sub.period_ms )
+        {
+        return false;
+        }
+
+    // Закрытое соединение не занято - подписка удаляется при передаче.
+    return !G_CMMCTR->is_push_busy( sub.connection_id );
+    }
+//-----------------------------------------------------------------------------
+void device_communicator::evaluate_subscriptions()
+    {
+    // Состояние устройств формируется, только если данные можно передать
+    // хотя бы одной подписке (истек период передачи, соединение свободно).
+    auto is_due = std::any_of( subscriptions.begin(), subscriptions.end(),
+        []( const subscription& sub )
+            {
+            return is_subscription_due( sub );
+            } );
+    if ( !is_due )
+        {
+        return;
+        }
+
+    if ( push_buff.empty() )
+        {
+        push_buff.resize( tcp_communicator::BUFSIZE );
+        }
+
+    auto use_dictionary = use_compression &&
+        G_PAC_INFO()->par[ PAC_info::P_COMPRESSION_DICTIONARY ];
+    if ( use_dictionary )
+        {
+        update_compression_dictionary( buff );
+        }
+
+    // Состояние устройств формируется один раз для всех подписок.
+    states_delta.update( dev, buff );
+    auto session_id = states_delta.get_session_id();
+    auto seq = states_delta.get_seq();
+
+    // Данные последней подписки без фильтра (для повторного использования).
+    auto is_shared_valid = false;
+    uint32_t shared_last_seq = 0;
+    u_int size = 0;
+
+    for ( auto it = subscriptions.begin(); it != subscriptions.end(); )
+        {
+        auto& sub = *it;
+        if ( sub.last_seq == seq || !is_subscription_due( sub ) )
+            {
+            ++it;
+            continue;
+            }
+
+        auto is_shared = sub.filter.empty();
+        if ( !is_shared || !is_shared_valid || shared_last_seq != sub.last_seq )
+            {
+            auto answer = reinterpret_cast<u_char*>( buff );
+            size = 0;
+            memcpy( answer, &session_id, sizeof( session_id ) );
+            size += sizeof( session_id );
+            memcpy( answer + size, &seq, sizeof( seq ) );
+            size += sizeof( seq );
+
+            auto is_full = false;
+            auto is_full_pos = size++;
+            auto str_size = states_delta.save_changes( session_id,
+                sub.last_seq, buff + size, is_full,
+                is_shared ? nullptr : &sub.filter );
+            size += str_size;
+            answer[ is_full_pos ] = is_full ? 1 : 0;
+            answer[ size++ ] = '\0'; // Учитываем завершающий \0.
+
+            if ( 0 == str_size && !is_full )
+                {
+                // Нет изменений устройств фильтра.
+                sub.last_seq = seq;
+                is_shared_valid = false;
+                ++it;
+                continue;
+                }
+
+            if ( use_compression )
+                {
+                size = compress_answer( answer, size, push_buff.data(),
+                    use_dictionary );
+                }
+            else
+                {
+                memcpy( push_buff.data(), answer, size );
+                }
+
+            is_shared_valid = is_shared && size > 0;
+            shared_last_seq = sub.last_seq;
+            }
+
+        if ( 0 == size )
+            {
+            ++it;
+            continue;
+            }
+
+        auto res = G_CMMCTR->push( sub.connection_id, C_SERVICE_N,
+            push_buff.data(), size );
+        if ( tcp_communicator::PUSH_NO_CONNECTION == res )
+            {
+            it = subscriptions.erase( it );
+            continue;
+            }
+        if ( tcp_communicator::PUSH_OK == res )
+            {
+            // При занятом соединении изменения будут переданы позже
+            // (вместе с последующими).
+            sub.last_seq = seq;
+            sub.last_push_time = get_millisec();
+            }
+        ++it;
+        }
+    }
+//-----------------------------------------------------------------------------
 void device_communicator::print() const
     {
     char tmp_str[ 200 ];
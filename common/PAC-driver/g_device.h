@@ -24,6 +24,7 @@
 #ifndef DRIVER
 
 #include <stdlib.h>
+#include <string>
 #include <vector>
 
 #include "smart_ptr.h"
@@ -34,6 +35,111 @@ extern "C" {
 #include "zlib.h"
     };
 
+//-----------------------------------------------------------------------------
+/// @brief Изменения состояния устройств - для передачи на сервер только
+/// изменившихся устройств.
+///
+/// Каждое устройство коммуникатора (для менеджера устройств - каждое
+/// устройство проекта) сохраняется в отдельный фрагмент, который
+/// сравнивается с предыдущим. Изменившимся фрагментам назначается новый
+/// номер изменения. Сервер передает номер последнего полученного изменения
+/// и получает только фрагменты с большим номером: устройства проекта - в
+/// таблице t_delta, которая добавляется в таблицу t, остальные устройства
+/// (технологические объекты, PAC_info и т.д.) - без изменений.
+///
+/// Если номер изменения неизвестен (0, другой идентификатор сеанса после
+/// перезапуска PAC, изменился состав устройств), передается полное
+/// состояние - как для CMD_GET_DEVICES_STATES.
+class devices_states_delta
+    {
+    public:
+        devices_states_delta();
+
+        /// @brief Обновление фрагментов.
+        ///
+        /// @param dev      - устройства коммуникатора.
+        /// @param tmp_buff - временный буфер для сохранения устройства.
+        void update( const std::vector< i_Lua_save_device* >& dev,
+            char* tmp_buff );
+
+        /// @brief Сохранение изменений в виде скрипта Lua.
+        ///
+        /// @param session_id   - идентификатор сеанса клиента.
+        /// @param last_seq     - номер последнего полученного изменения.
+        /// @param buff [ out ] - буфер.
+        /// @param is_full [ out ] - передано полное состояние.
+        /// @param filter  - имена устройств проекта (nullptr - все
+        /// устройства). При заданном фильтре устройства проекта всегда
+        /// добавляются в таблицу t (t_delta), остальные устройства
+        /// коммуникатора не сохраняются.
+        ///
+        /// @return - размер записанной строки (без завершающего \0).
+        int save_changes( uint32_t session_id, uint32_t last_seq, char* buff,
+            bool& is_full,
+            const std::vector< std::string >* filter = nullptr ) const;
+
+        uint32_t get_session_id() const;
+
+        /// @brief Номер последнего изменения.
+        uint32_t get_seq() const;
+
+    private:
+        enum FRAGMENT_TYPE
+            {
+            FT_OBJECT = 0,      ///< Устройство коммуникатора.
+            FT_DEVICES_START,   ///< Начало устройств менеджера устройств.
+            FT_PROJECT_DEVICE,  ///< Устройство менеджера устройств.
+            };
+
+        struct fragment
+            {
+            const i_Lua_save_device* dev;
+            FRAGMENT_TYPE type;
+            std::string str;
+            uint32_t seq;       ///< Номер изменения.
+            };
+
+        std::vector< fragment > fragments;
+
+        uint32_t session_id;
+        uint32_t seq = 0;
+        uint32_t full_seq = 0;  ///< Номер изменения состава устройств.
+    };
+//-----------------------------------------------------------------------------
+/// @brief Команда устройству, выполняемая без Lua.
+///
+/// Команды вида "ИМЯ:set_cmd( "СВОЙСТВО", индекс, число )" разбираются и
+/// выполняются напрямую (без компиляции строки Lua). ИМЯ - устройство
+/// проекта (допускается префикс "__") или технологический объект (имя в
+/// Lua, допускается префикс "t."), "t.SYSTEM" - PAC_info. Остальные команды
+/// выполняются Lua.
+class device_set_cmd
+    {
+    public:
+        enum CONSTANTS
+            {
+            C_MAX_PROP_LENGTH = 50,
+            };
+
+        /// @brief Разбор команды.
+        ///
+        /// @param str - строка команды (с завершающим \0).
+        ///
+        /// @return - true - команда разобрана.
+        bool parse( const char* str );
+
+        /// @brief Выполнение разобранной команды.
+        ///
+        /// @return - true - объект команды найден, команда выполнена.
+        bool exec() const;
+
+    private:
+        std::string name;       ///< Имя объекта (без префикса).
+        bool is_table_name = false; ///< Имя с префиксом "t.".
+        char prop[ C_MAX_PROP_LENGTH + 1 ] = { 0 };
+        u_int idx = 0;
+        double val = 0;
+    };
 #endif // DRIVER
 //-----------------------------------------------------------------------------
 /// @brief Коммуникатор устройств - содержит все устройства одного PAC. Служит
@@ -67,10 +173,80 @@ class device_communicator
             CMD_GET_PARAMS_CRC,
             // Резервное копирование параметров. -!>
 
+            ///@brief Получение статистики времени этапов основного цикла.
+            ///
+            /// Ненулевой байт параметра - сброс статистики после получения.
+            CMD_GET_CYCLE_PROFILE,
+
+            ///@brief Запрос инф. об изменившихся устройствах PAC.
+            ///
+            /// Параметры: идентификатор сеанса (u_int_4) и номер последнего
+            /// полученного изменения (u_int_4) из предыдущего ответа (0 -
+            /// полное состояние). Ответ: идентификатор запроса устройств
+            /// (u_int_2), идентификатор сеанса (u_int_4), номер изменения
+            /// (u_int_4), признак полного состояния (u_char), скрипт Lua
+            /// (@ref devices_states_delta).
+            CMD_GET_DEVICES_STATES_DELTA,
+
+            ///@brief Получение словаря сжатия состояния устройств.
+            ///
+            /// При включенном параметре PAC_info::P_COMPRESSION_DICTIONARY
+            /// ответы CMD_GET_DEVICES_STATES и CMD_GET_DEVICES_STATES_DELTA
+            /// сжимаются с предварительно заданным словарем (его
+            /// идентификатор - в заголовке zlib, inflate возвращает
+            /// Z_NEED_DICT). Ответ: идентификатор словаря (adler32, u_int_4),
+            /// словарь, завершающий \0.
+            CMD_GET_COMPRESSION_DICTIONARY,
+
+            ///@brief Подписка на изменения состояния устройств.
+            ///
+            /// Вместо периодического запроса CMD_GET_DEVICES_STATES_DELTA
+            /// изменения передаются PAC по инициативе PAC (кадр
+            /// tcp_communicator::PUSH_DATA) - не чаще заданного периода,
+            /// изменения за период объединяются. Параметры: минимальный
+            /// период передачи, мс (u_int_2, 0 - в каждом цикле при наличии
+            /// изменений), имена устройств проекта через пробел (строка с
+            /// завершающим \0, пустая или отсутствует - все устройства).
+            /// Данные: идентификатор сеанса (u_int_4), номер изменения
+            /// (u_int_4), признак полного состояния (u_char), скрипт Lua
+            /// (@ref devices_states_delta), завершающий \0 - со сжатием,
+            /// как и ответ. Ответ: 0 - подписка выполнена, 1 - передача по
+            /// инициативе PAC не поддерживается. Повторная подписка
+            /// соединения заменяет предыдущую.
+            CMD_SUBSCRIBE_DEVICES_STATES,
+
+            ///@brief Отмена подписки соединения на изменения состояния
+            /// устройств.
+            CMD_UNSUBSCRIBE_DEVICES_STATES,
+
+            ///@brief Выполнение нескольких команд для устройств.
+            ///
+            /// Параметр - команды (как для CMD_EXEC_DEVICE_COMMAND), каждая с
+            /// завершающим \0. Ответ - количество команд, выполненных с
+            /// ошибкой (u_int_2).
+            CMD_EXEC_DEVICE_COMMANDS,
+
             CMD_RM_GET_DEVICES = 200,   ///< Запрос устройств PAC от PAC-мастера.
             CMD_RM_GET_DEVICES_STATES,  ///< Запрос состояния устройств PAC от PAC-мастера.
             };
 
+        /// @brief Представление состояния устройств (CMD_GET_DEVICES_STATES).
+        ///
+        /// Двоичное представление задается байтом после идентификатора
+        /// запроса для CMD_GET_DEVICES (в ответ добавляется схема -
+        /// таблица t_states_schema и ее идентификатор t_states_schema_id)
+        /// и байтом после команды для CMD_GET_DEVICES_STATES. Ответ:
+        /// идентификатор запроса устройств (u_int_2), идентификатор схемы
+        /// (u_int_4, 0 - схема устарела, необходимо повторить
+        /// CMD_GET_DEVICES), количество устройств (varint), для каждого
+        /// устройства - номер (varint) и значения полей схемы, далее -
+        /// скрипт Lua остальных устройств коммуникатора.
+        enum ENCODING
+            {
+            ENC_LUA = 0,    ///< Скрипт Lua.
+            ENC_BINARY,     ///< Двоичное (@ref binary_state_writer).
+            };
+
 #ifndef DRIVER
     private:
         /// Единственный экземпляр класса.
@@ -79,6 +255,96 @@ class device_communicator
 
         static bool use_compression;
 
+        /// @brief Поток сжатия (инициализируется один раз, для каждого
+        /// ответа сбрасывается).
+        static z_stream compression_stream;
+        static bool is_compression_stream_init;
+        static int compression_level;
+        static int compression_strategy;
+
+        /// @brief Словарь сжатия - начало состояния всех устройств.
+        static std::string compression_dictionary;
+        static uint32_t compression_dictionary_id;
+        /// @brief Состав устройств, для которого сформирован словарь.
+        static size_t compression_dictionary_key;
+
+        /// @brief Сжатие ответа.
+        ///
+        /// @param src            - ответ.
+        /// @param size           - размер ответа.
+        /// @param out            - буфер для сжатого ответа.
+        /// @param use_dictionary - сжатие с словарем.
+        ///
+        /// @return - размер сжатого ответа (0 - ошибка).
+        static u_int compress_answer( u_char* src, u_int size, u_char* out,
+            bool use_dictionary );
+
+        /// @brief Обновление словаря сжатия при изменении состава устройств.
+        ///
+        /// @param tmp_buff - временный буфер.
+        static void update_compression_dictionary( char* tmp_buff );
+
+        static devices_states_delta states_delta;
+
+        /// @brief Идентификатор схемы двоичного представления.
+        static uint32_t states_schema_id;
+        /// @brief Количество полей устройств по схеме.
+        static std::vector< int > states_schema_fields_count;
+        /// @brief Версия состава устройств, для которого получена схема.
+        static u_int states_schema_config_version;
+
+        /// @brief Сохранение схемы двоичного представления состояния
+        /// устройств проекта (скрипт Lua).
+        ///
+        /// @param tmp_buff - временный буфер.
+        static int save_states_schema( char* buff, char* tmp_buff );
+
+        /// @brief Сохранение состояния устройств в двоичном виде.
+        static int save_states_binary( u_char* buff );
+
+        /// @brief Выполнение команды для устройства (@ref device_set_cmd,
+        /// при невозможности - Lua).
+        ///
+        /// @return - 0 - ок, 1 - ошибка.
+        static int exec_device_command( const char* str );
+
+        /// @brief Подписка на изменения состояния устройств
+        /// (CMD_SUBSCRIBE_DEVICES_STATES).
+        struct subscription
+            {
+            u_int connection_id;    ///< Соединение tcp_communicator.
+            u_int period_ms;        ///< Минимальный период передачи.
+            std::vector< std::string > filter; ///< Имена устройств.
+
+            uint32_t last_seq = 0;  ///< Номер переданного изменения.
+            uint32_t last_push_time = 0;
+            };
+
+        static std::vector< subscription > subscriptions;
+
+        /// @brief Данные подписки можно передать (истек период передачи,
+        /// предыдущие данные соединения переданы).
+        static bool is_subscription_due( const subscription& sub );
+
+        /// @brief Буфер для сжатых данных подписки.
+        static std::vector< u_char > push_buff;
+
+        /// @brief Ответ на запрос, сохраненный для других клиентов.
+        struct cached_answer
+            {
+            std::vector< u_char > request; ///< Команда и ее параметры.
+            std::vector< u_char > answer;  ///< Ответ (сжатый).
+            };
+
+        static std::vector< cached_answer > answers_cache;
+        static bool is_answers_cache_active;
+
+        /// @brief Поиск ответа в кэше ответов.
+        ///
+        /// @return - размер ответа, записанного в outdata (0 - не найден).
+        static u_int get_cached_answer( long len, const u_char* data,
+            u_char* outdata );
+
     public:
         static void switch_on_compression()
             {
@@ -131,6 +397,32 @@ class device_communicator
 
         /// @brief Удаление устройств.
         void clear_devices();
+
+        /// @brief Передача изменений состояния устройств подписанным
+        /// клиентам (CMD_SUBSCRIBE_DEVICES_STATES).
+        ///
+        /// Вызывается в каждом цикле управляющей программы. Состояние
+        /// устройств формируется один раз для всех подписок (@ref
+        /// devices_states_delta), данные подписок без фильтра с одинаковым
+        /// номером переданного изменения - также один раз.
+        void evaluate_subscriptions();
+
+        /// @brief Начало обмена в цикле управляющей программы - ответы на
+        /// CMD_GET_DEVICES_STATES и CMD_GET_PAC_ERRORS сохраняются, на
+        /// одинаковые запросы других клиентов передаются сохраненные
+        /// ответы (без формирования и сжатия).
+        ///
+        /// Состояние устройств за время обмена не изменяется, кроме команд
+        /// (CMD_EXEC_DEVICE_COMMAND и др.) и записи по Modbus - они очищают
+        /// кэш.
+        void start_answers_cache();
+
+        /// @brief Очистка кэша ответов (состояние устройств изменилось).
+        static void clear_answers_cache();
+
+        /// @brief Окончание обмена - кэш ответов очищается и не
+        /// используется.
+        void stop_answers_cache();
 #endif // !DRIVER
     };
 //-----------------------------------------------------------------------------
@@ -202,3 +202,48 @@ TEST( OPCUA_server, evaluate )
 
     G_DEVICE_MANAGER()->clear_io_devices();
     }
+
+TEST( OPCUA_server, create_io_nodes_stat )
+    {
+    G_OPCUA_SERVER.create_io_nodes_stat();  //Correct call with no initialization.
+
+    G_IO_MANAGER()->init( 1 );
+    G_IO_MANAGER()->add_node( 0, io_manager::io_node::PHOENIX_BK_ETH, 1,
+        "127.0.0.1", "A100", 0, 0, 0, 0, 0, 0 );
+    auto node = G_IO_MANAGER()->get_node( 0 );
+    node->recv_hist.add( 100 );
+    node->recv_hist.add( 1'000 );
+
+    G_OPCUA_SERVER.init();
+    G_OPCUA_SERVER.create_io_nodes_stat();
+    G_OPCUA_SERVER.create_io_nodes_stat();  //Correct call again.
+    auto res = G_OPCUA_SERVER.start();
+    EXPECT_EQ( UA_STATUSCODE_GOOD, res );
+
+    auto UA_server = G_OPCUA_SERVER.get_server();
+    UA_Variant out;
+    UA_Variant_init( &out );
+    UA_NodeId recv_max_NodeId = UA_NODEID_STRING_ALLOC( 0,
+        "io_nodes.A100.recv_max" );
+    res = UA_Server_readValue( UA_server, recv_max_NodeId, &out );
+    EXPECT_EQ( UA_STATUSCODE_GOOD, res );
+    EXPECT_TRUE( out.type == &UA_TYPES[ UA_TYPES_UINT32 ] );
+    EXPECT_EQ( 1'000u, *static_cast<UA_UInt32*>( out.data ) );
+    UA_Variant_clear( &out );
+    UA_NodeId_clear( &recv_max_NodeId );
+
+    UA_NodeId connect_p99_NodeId = UA_NODEID_STRING_ALLOC( 0,
+        "io_nodes.A100.connect_p99" );
+    res = UA_Server_readValue( UA_server, connect_p99_NodeId, &out );
+    EXPECT_EQ( UA_STATUSCODE_GOOD, res );
+    EXPECT_EQ( 0u, *static_cast<UA_UInt32*>( out.data ) );
+    UA_Variant_clear( &out );
+    UA_NodeId_clear( &connect_p99_NodeId );
+
+    res = G_OPCUA_SERVER.read_io_node_stat( nullptr, nullptr, nullptr,
+        nullptr, nullptr, false, nullptr, nullptr );
+    EXPECT_EQ( UA_STATUSCODE_BAD, res );
+
+    G_OPCUA_SERVER.shutdown();
+    G_IO_MANAGER()->init( 0 );
+    }
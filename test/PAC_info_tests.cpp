@@ -2,6 +2,9 @@
 #include "bus_coupler_io.h"
 #include "OPCUAServer.h"
 #include "lua_manager.h"
+#include "cycle_profiler.h"
+#include "cycle_scheduler.h"
+#include "lua_gc_controller.h"
 
 // Мок для G_OPCUA_SERVER.
 class MockOPCUAServer : public OPCUA_server
@@ -114,6 +117,27 @@ TEST( PAC_info, set_cmd )
     EXPECT_EQ( 0, G_PAC_INFO()->set_cmd( "NODEENABLED", 1, 100 ) );
     EXPECT_FALSE( PAC_critical_errors_manager::get_instance()->is_any_error() );
 
+    // Сброс статистики обмена с узлами.
+    auto nd = G_IO_MANAGER()->get_node( 0 );
+    nd->recv_hist.add( 100 );
+    EXPECT_EQ( 0, G_PAC_INFO()->set_cmd( "CMD", 0,
+        static_cast<double>( PAC_info::COMMANDS::RESET_IO_STAT ) ) );
+    nd->check_stat_reset();
+    EXPECT_EQ( 0u, nd->recv_hist.get_count() );
+
+    // Сброс статистики основного цикла.
+    G_CYCLE_PROFILER()->start_cycle();
+    G_CYCLE_PROFILER()->end_cycle();
+    G_CYCLE_SCHEDULER()->set_period( 1 );
+    G_CYCLE_SCHEDULER()->wait_next_cycle();
+    G_CYCLE_SCHEDULER()->set_period( 0 );
+    G_LUA_GC_CONTROLLER()->step( L );
+    EXPECT_EQ( 0, G_PAC_INFO()->set_cmd( "CMD", 0,
+        static_cast<double>( PAC_info::COMMANDS::RESET_CYCLE_PROFILE ) ) );
+    EXPECT_EQ( 0u, G_CYCLE_PROFILER()->get_cycle_hist().get_count() );
+    EXPECT_EQ( 0u, G_CYCLE_SCHEDULER()->get_jitter_hist().get_count() );
+    EXPECT_EQ( 0u, G_LUA_GC_CONTROLLER()->get_gc_time_hist().get_count() );
+
     G_LUA_MANAGER->free_Lua();
     tcp_communicator::clear_instance();
     }
@@ -144,11 +168,14 @@ TEST( PAC_info, save_device )
     G_PAC_INFO()->set_cmd( "CMD", 0,
         static_cast<double>( PAC_info::COMMANDS::CLEAR_RESULT_CMD ) );
     G_PAC_INFO()->set_cycle_time( 100 );
+    G_CYCLE_PROFILER()->reset();
+    G_CYCLE_SCHEDULER()->reset();
+    G_LUA_GC_CONTROLLER()->reset();
     G_PAC_INFO()->reset_uptime();
     DeltaMilliSecSubHooker::set_millisec( 0 );
     G_PAC_INFO()->eval();  // Update error indicators.
 
-    const auto MAX_SIZE = 1000;
+    const auto MAX_SIZE = 2800;
     const auto REF_STR =
         "t.SYSTEM = \n"
         "\t{\n"
@@ -159,6 +186,35 @@ TEST( PAC_info, save_device )
         "\tUP_SECS=0,\n"
         "\tUP_TIME=\"0 дн. 0:0:0\",\n"
         "\tCYCLE_TIME=100,\n"
+        "\tCYCLE_TIME_P99=0,\n"
+        "\tCYCLE_TIME_MAX=0,\n"
+        "\tCYCLE_PHASE_P99 = \n"
+        "\t{\n"
+        "\t0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \n"
+        "\t},\n"
+        "\tCYCLE_PHASE_WORST = \n"
+        "\t{\n"
+        "\t0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \n"
+        "\t},\n"
+        "\tCYCLE_JITTER_P99=0,\n"
+        "\tCYCLE_JITTER_MAX=0,\n"
+        "\tCYCLE_OVERRUNS=0,\n"
+        "\tCYCLE_OVERRUN_MAX=0,\n"
+        "\tCYCLE_TASK_P99 = \n"
+        "\t{\n"
+        "\t0, 0, 0, \n"
+        "\t},\n"
+        "\tCYCLE_TASK_OVERRUNS = \n"
+        "\t{\n"
+        "\t0, 0, 0, \n"
+        "\t},\n"
+        "\tLUA_HEAP_SIZE=0,\n"
+        "\tLUA_GC_STEP=0,\n"
+        "\tLUA_GC_TIME_P99=0,\n"
+        "\tLUA_GC_TIME_MAX=0,\n"
+        "\tLUA_GC_FULL_COUNT=0,\n"
+        "\tTCP_SLOW_CLIENTS=0,\n"
+        "\tTCP_OUT_QUEUE_MAX=0,\n"
         "\tWASH_VALVE_SEAT_PERIOD=180,\n"
         "\tWASH_VALVE_UPPER_SEAT_TIME=2000,\n"
         "\tWASH_VALVE_LOWER_SEAT_TIME=1000,\n"
@@ -180,9 +236,33 @@ TEST( PAC_info, save_device )
         "\t{\n"
         "\t0, \n"
         "\t},\n"
+        "\tNODE_RECV_P99 = \n"
+        "\t{\n"
+        "\t0, \n"
+        "\t},\n"
+        "\tNODE_RECV_MAX = \n"
+        "\t{\n"
+        "\t0, \n"
+        "\t},\n"
         "\tP_IS_OPC_UA_SERVER_ACTIVE=1,\n"
         "\tP_IS_OPC_UA_SERVER_CONTROL=0,\n"
         "\tP_BK_ANSWER_MAX_WAIT_TIME=6000,\n"
+        "\tP_IO_PIPELINED_EXCHANGE=0,\n"
+        "\tP_IO_THREAD=0,\n"
+        "\tP_IO_OUTPUTS_REFRESH_TIME=0,\n"
+        "\tP_IO_COMBINED_EXCHANGE=0,\n"
+        "\tP_MAIN_CYCLE_PERIOD=0,\n"
+        "\tP_FAST_TASKS_PERIOD=0,\n"
+        "\tP_NORMAL_TASKS_PERIOD=0,\n"
+        "\tP_SLOW_TASKS_PERIOD=0,\n"
+        "\tP_COMM_THREAD=0,\n"
+        "\tP_LUA_GC_ADAPTIVE=0,\n"
+        "\tP_LUA_GC_FULL_THRESHOLD=0,\n"
+        "\tP_COMPRESSION_LEVEL=0,\n"
+        "\tP_COMPRESSION_STRATEGY=0,\n"
+        "\tP_COMPRESSION_DICTIONARY=0,\n"
+        "\tP_TCP_MAX_OUT_QUEUE=4096,\n"
+        "\tP_TCP_SLOW_CLIENT_TIMEOUT=10000,\n"
         "\tNODES_COMM_ERROR=0,\n"
         "\tWATCHDOG_ERROR=0,\n"
         "\tCOMMUN_ERROR=0,\n"
@@ -205,6 +285,35 @@ TEST( PAC_info, save_device )
             "\tUP_SECS=1,\n"
             "\tUP_TIME=\"0 дн. 00:00:01\",\n"
             "\tCYCLE_TIME=100,\n"
+            "\tCYCLE_TIME_P99=0,\n"
+            "\tCYCLE_TIME_MAX=0,\n"
+            "\tCYCLE_PHASE_P99 = \n"
+            "\t{\n"
+            "\t0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \n"
+            "\t},\n"
+            "\tCYCLE_PHASE_WORST = \n"
+            "\t{\n"
+            "\t0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \n"
+            "\t},\n"
+            "\tCYCLE_JITTER_P99=0,\n"
+            "\tCYCLE_JITTER_MAX=0,\n"
+            "\tCYCLE_OVERRUNS=0,\n"
+            "\tCYCLE_OVERRUN_MAX=0,\n"
+            "\tCYCLE_TASK_P99 = \n"
+            "\t{\n"
+            "\t0, 0, 0, \n"
+            "\t},\n"
+            "\tCYCLE_TASK_OVERRUNS = \n"
+            "\t{\n"
+            "\t0, 0, 0, \n"
+            "\t},\n"
+            "\tLUA_HEAP_SIZE=0,\n"
+            "\tLUA_GC_STEP=0,\n"
+            "\tLUA_GC_TIME_P99=0,\n"
+            "\tLUA_GC_TIME_MAX=0,\n"
+            "\tLUA_GC_FULL_COUNT=0,\n"
+            "\tTCP_SLOW_CLIENTS=0,\n"
+            "\tTCP_OUT_QUEUE_MAX=0,\n"
             "\tWASH_VALVE_SEAT_PERIOD=180,\n"
             "\tWASH_VALVE_UPPER_SEAT_TIME=2000,\n"
             "\tWASH_VALVE_LOWER_SEAT_TIME=1000,\n"
@@ -226,9 +335,33 @@ TEST( PAC_info, save_device )
             "\t{\n"
             "\t0, \n"
             "\t},\n"
+            "\tNODE_RECV_P99 = \n"
+            "\t{\n"
+            "\t0, \n"
+            "\t},\n"
+            "\tNODE_RECV_MAX = \n"
+            "\t{\n"
+            "\t0, \n"
+            "\t},\n"
             "\tP_IS_OPC_UA_SERVER_ACTIVE=1,\n"
             "\tP_IS_OPC_UA_SERVER_CONTROL=0,\n"
             "\tP_BK_ANSWER_MAX_WAIT_TIME=6000,\n"
+            "\tP_IO_PIPELINED_EXCHANGE=0,\n"
+            "\tP_IO_THREAD=0,\n"
+            "\tP_IO_OUTPUTS_REFRESH_TIME=0,\n"
+            "\tP_IO_COMBINED_EXCHANGE=0,\n"
+            "\tP_MAIN_CYCLE_PERIOD=0,\n"
+            "\tP_FAST_TASKS_PERIOD=0,\n"
+            "\tP_NORMAL_TASKS_PERIOD=0,\n"
+            "\tP_SLOW_TASKS_PERIOD=0,\n"
+            "\tP_COMM_THREAD=0,\n"
+            "\tP_LUA_GC_ADAPTIVE=0,\n"
+            "\tP_LUA_GC_FULL_THRESHOLD=0,\n"
+            "\tP_COMPRESSION_LEVEL=0,\n"
+            "\tP_COMPRESSION_STRATEGY=0,\n"
+            "\tP_COMPRESSION_DICTIONARY=0,\n"
+            "\tP_TCP_MAX_OUT_QUEUE=4096,\n"
+            "\tP_TCP_SLOW_CLIENT_TIMEOUT=10000,\n"
             "\tNODES_COMM_ERROR=0,\n"
             "\tWATCHDOG_ERROR=0,\n"
             "\tCOMMUN_ERROR=0,\n"
@@ -419,3 +419,30 @@ TEST( io_manager, get_node )
     auto const_res3 = IO_MNGR->get_node( 0 );
     EXPECT_NE( const_res3, &IO_MNGR->IO_NODE_STUB );
     }
+
+TEST( io_manager, pack_unpack_bits )
+    {
+    const u_int CNT = 21;
+    u_char values[ CNT ] = { 0 };
+    for ( u_int i = 0; i < CNT; i++ )
+        {
+        values[ i ] = i % 3 == 0 ? 1 : 0;
+        }
+    // Учитывается только младший бит.
+    values[ 1 ] = 2;
+
+    u_char bits[ 3 ] = { 0xFF, 0xFF, 0xFF };
+    io_manager::pack_bits( values, bits, CNT );
+    EXPECT_EQ( bits[ 0 ], 0b01001001 );
+    EXPECT_EQ( bits[ 1 ], 0b10010010 );
+    EXPECT_EQ( bits[ 2 ], 0b00000100 );  // Лишние биты обнулены.
+
+    u_char res[ CNT + 1 ] = { 0 };
+    res[ CNT ] = 5;
+    io_manager::unpack_bits( bits, res, CNT );
+    for ( u_int i = 0; i < CNT; i++ )
+        {
+        EXPECT_EQ( res[ i ], i % 3 == 0 ? 1 : 0 );
+        }
+    EXPECT_EQ( res[ CNT ], 5 );          // За пределами не изменяется.
+    }
@@ -0,0 +1,160 @@
+#include "cycle_profiler_tests.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+TEST( cycle_profiler, end_cycle )
+    {
+    auto profiler = G_CYCLE_PROFILER();
+    profiler->reset();
+
+    // Окончание цикла без начала - ничего не добавляется.
+    profiler->end_cycle();
+    EXPECT_EQ( 0u, profiler->get_cycle_hist().get_count() );
+
+    profiler->start_cycle();
+    profiler->end_phase( cycle_profiler::PH_LUA_GC );
+    std::this_thread::sleep_for( 2ms );
+    profiler->end_phase( cycle_profiler::PH_READ_INPUTS );
+    std::this_thread::sleep_for( 1ms );
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
+    std::this_thread::sleep_for( 1ms );
+    profiler->end_phase( cycle_profiler::PH_SLEEP );
+    profiler->end_cycle();
+
+    EXPECT_EQ( 1u, profiler->get_cycle_hist().get_count() );
+    EXPECT_GE( profiler->get_cycle_hist().get_max(), 4'000u );
+    EXPECT_GE( profiler->get_phase_hist(
+        cycle_profiler::PH_READ_INPUTS ).get_max(), 2'000u );
+    // Время этапа, который встречается несколько раз, суммируется.
+    EXPECT_GE( profiler->get_phase_hist(
+        cycle_profiler::PH_SLEEP ).get_max(), 2'000u );
+    // Этапы, которые не выполнялись, учитываются с нулевым временем.
+    EXPECT_EQ( 1u, profiler->get_phase_hist(
+        cycle_profiler::PH_OPC_UA ).get_count() );
+    EXPECT_EQ( 0u, profiler->get_phase_hist(
+        cycle_profiler::PH_OPC_UA ).get_max() );
+    // Время работы цикла - без ожидания.
+    EXPECT_GE( profiler->get_last_cycle_work_time(), 2'000u );
+    EXPECT_LT( profiler->get_last_cycle_work_time(),
+        profiler->get_cycle_hist().get_max() );
+
+    // Время этапов самого долгого цикла.
+    auto worst_read_time = profiler->get_worst_cycle_phase_time(
+        cycle_profiler::PH_READ_INPUTS );
+    EXPECT_GE( worst_read_time, 2'000u );
+
+    profiler->start_cycle();
+    profiler->end_phase( cycle_profiler::PH_READ_INPUTS );
+    profiler->end_cycle();
+    EXPECT_EQ( 2u, profiler->get_cycle_hist().get_count() );
+    EXPECT_EQ( worst_read_time, profiler->get_worst_cycle_phase_time(
+        cycle_profiler::PH_READ_INPUTS ) );
+
+    profiler->reset();
+    EXPECT_EQ( 0u, profiler->get_cycle_hist().get_count() );
+    EXPECT_EQ( 0u, profiler->get_phase_hist(
+        cycle_profiler::PH_READ_INPUTS ).get_count() );
+    EXPECT_EQ( 0u, profiler->get_worst_cycle_phase_time(
+        cycle_profiler::PH_READ_INPUTS ) );
+    }
+
+TEST( cycle_profiler, get_phase_name )
+    {
+    EXPECT_STREQ( "LUA_GC",
+        cycle_profiler::get_phase_name( cycle_profiler::PH_LUA_GC ) );
+    EXPECT_STREQ( "SLEEP",
+        cycle_profiler::get_phase_name( cycle_profiler::PH_SLEEP ) );
+    EXPECT_STREQ( "?",
+        cycle_profiler::get_phase_name( cycle_profiler::PHASES_COUNT ) );
+    }
+
+TEST( cycle_profiler, task_classes )
+    {
+    auto profiler = G_CYCLE_PROFILER();
+    auto scheduler = G_CYCLE_SCHEDULER();
+    profiler->reset();
+
+    EXPECT_EQ( cycle_scheduler::TC_FAST, cycle_profiler::get_phase_task_class(
+        cycle_profiler::PH_READ_INPUTS ) );
+    EXPECT_EQ( cycle_scheduler::TC_NORMAL,
+        cycle_profiler::get_phase_task_class( cycle_profiler::PH_TECH_OBJECTS ) );
+    EXPECT_EQ( cycle_scheduler::TC_SLOW, cycle_profiler::get_phase_task_class(
+        cycle_profiler::PH_ERRORS ) );
+    EXPECT_EQ( cycle_scheduler::TASK_CLASSES_COUNT,
+        cycle_profiler::get_phase_task_class( cycle_profiler::PH_SLEEP ) );
+
+    // Класс задач выполняется каждый цикл, класс обслуживания - нет.
+    scheduler->set_task_period( cycle_scheduler::TC_SLOW, 1000 );
+    for ( int i = 0; i < 2; i++ )
+        {
+        scheduler->is_task_due( cycle_scheduler::TC_FAST );
+        scheduler->is_task_due( cycle_scheduler::TC_NORMAL );
+        scheduler->is_task_due( cycle_scheduler::TC_SLOW );
+
+        profiler->start_cycle();
+        std::this_thread::sleep_for( 1ms );
+        profiler->end_phase( cycle_profiler::PH_READ_INPUTS );
+        std::this_thread::sleep_for( 1ms );
+        profiler->end_phase( cycle_profiler::PH_WRITE_OUTPUTS );
+        profiler->end_phase( cycle_profiler::PH_ERRORS );
+        profiler->end_cycle();
+        }
+
+    // Время класса - сумма времени его этапов.
+    EXPECT_EQ( 2u, profiler->get_task_hist(
+        cycle_scheduler::TC_FAST ).get_count() );
+    EXPECT_GE( profiler->get_task_hist(
+        cycle_scheduler::TC_FAST ).get_min(), 2'000u );
+    EXPECT_GE( profiler->get_worst_cycle_task_time(
+        cycle_scheduler::TC_FAST ), 2'000u );
+    EXPECT_EQ( 2u, profiler->get_task_hist(
+        cycle_scheduler::TC_NORMAL ).get_count() );
+    EXPECT_EQ( 1u, profiler->get_task_hist(
+        cycle_scheduler::TC_SLOW ).get_count() );
+
+    profiler->reset();
+    EXPECT_EQ( 0u, profiler->get_task_hist(
+        cycle_scheduler::TC_FAST ).get_count() );
+    EXPECT_EQ( 0u, profiler->get_worst_cycle_task_time(
+        cycle_scheduler::TC_FAST ) );
+
+    scheduler->set_task_period( cycle_scheduler::TC_SLOW, 0 );
+    scheduler->reset();
+    }
+
+TEST( cycle_profiler, save_as_Lua_str )
+    {
+    auto profiler = G_CYCLE_PROFILER();
+    profiler->reset();
+
+    const int BUFF_SIZE = 2000;
+    char buff[ BUFF_SIZE ] = { 0 };
+    auto size = profiler->save_as_Lua_str( buff, BUFF_SIZE );
+    EXPECT_EQ( static_cast<size_t>( size ), strlen( buff ) );
+
+    const auto ZERO_STAT = "={P50=0, P95=0, P99=0, MAX=0, AVG=0, WORST=0},\n";
+    std::string ref = "t.CYCLE_PROFILE = \n\t{\n\tCYCLES=0,\n";
+    ref += std::string( "\tCYCLE" ) + ZERO_STAT;
+    for ( int i = 0; i < cycle_profiler::PHASES_COUNT; i++ )
+        {
+        ref += std::string( "\t" ) + cycle_profiler::get_phase_name(
+            static_cast<cycle_profiler::PHASES>( i ) ) + ZERO_STAT;
+        }
+    ref += std::string( "\tTASK_FAST" ) + ZERO_STAT;
+    ref += std::string( "\tTASK_NORMAL" ) + ZERO_STAT;
+    ref += std::string( "\tTASK_SLOW" ) + ZERO_STAT;
+    ref += "\t}\n";
+    EXPECT_EQ( ref, buff );
+
+    // Недостаточный размер буфера - строка обрезается.
+    const int SMALL_BUFF_SIZE = 50;
+    size = profiler->save_as_Lua_str( buff, SMALL_BUFF_SIZE );
+    EXPECT_EQ( SMALL_BUFF_SIZE - 1, size );
+    EXPECT_EQ( static_cast<size_t>( size ), strlen( buff ) );
+
+    EXPECT_EQ( 0, profiler->save_as_Lua_str( buff, 0 ) );
+    }
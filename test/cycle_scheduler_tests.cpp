@@ -0,0 +1,129 @@
+#include "cycle_scheduler_tests.h"
+
+#include <chrono>
+#include <thread>
+
+#if defined LINUX_OS
+#include <pthread.h>
+#endif // defined LINUX_OS
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+TEST( cycle_scheduler, set_period )
+    {
+    auto scheduler = G_CYCLE_SCHEDULER();
+    scheduler->set_period( 0 );
+    scheduler->reset();
+    EXPECT_FALSE( scheduler->is_active() );
+
+    // Планировщик отключен - ожидания нет.
+    auto start = std::chrono::steady_clock::now();
+    scheduler->wait_next_cycle();
+    EXPECT_LT( std::chrono::steady_clock::now() - start, 5ms );
+    EXPECT_EQ( 0u, scheduler->get_jitter_hist().get_count() );
+
+    scheduler->set_period( 10 );
+    EXPECT_TRUE( scheduler->is_active() );
+    EXPECT_EQ( 10u, scheduler->get_period() );
+
+    scheduler->set_period( 0 );
+    }
+
+TEST( cycle_scheduler, wait_next_cycle )
+    {
+    auto scheduler = G_CYCLE_SCHEDULER();
+    scheduler->set_period( 5 );
+    scheduler->reset();
+
+    // Период не зависит от времени выполнения цикла.
+    auto start = std::chrono::steady_clock::now();
+    for ( int i = 0; i < 4; i++ )
+        {
+        std::this_thread::sleep_for( 1ms );
+        scheduler->wait_next_cycle();
+        }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE( elapsed, 20ms );
+    EXPECT_LT( elapsed, 40ms );
+    EXPECT_EQ( 4u, scheduler->get_jitter_hist().get_count() );
+    EXPECT_EQ( 0u, scheduler->get_overruns_count() );
+
+    // Цикл опоздал - ожидание пропускается, превышение учитывается.
+    std::this_thread::sleep_for( 12ms );
+    start = std::chrono::steady_clock::now();
+    scheduler->wait_next_cycle();
+    EXPECT_LT( std::chrono::steady_clock::now() - start, 2ms );
+    EXPECT_EQ( 1u, scheduler->get_overruns_count() );
+    EXPECT_GE( scheduler->get_max_overrun(), 7'000u );
+
+    // После пропуска периода расписание сдвигается - следующий цикл
+    // ожидает полный период.
+    start = std::chrono::steady_clock::now();
+    scheduler->wait_next_cycle();
+    EXPECT_GE( std::chrono::steady_clock::now() - start, 4ms );
+    EXPECT_EQ( 1u, scheduler->get_overruns_count() );
+
+    scheduler->reset();
+    EXPECT_EQ( 0u, scheduler->get_overruns_count() );
+    EXPECT_EQ( 0u, scheduler->get_max_overrun() );
+    EXPECT_EQ( 0u, scheduler->get_jitter_hist().get_count() );
+
+    scheduler->set_period( 0 );
+    }
+
+TEST( cycle_scheduler, is_task_due )
+    {
+    auto scheduler = G_CYCLE_SCHEDULER();
+    scheduler->reset();
+
+    // Период не задан - класс задач выполняется каждый цикл.
+    EXPECT_TRUE( scheduler->is_task_due( cycle_scheduler::TC_FAST ) );
+    EXPECT_TRUE( scheduler->is_task_executed( cycle_scheduler::TC_FAST ) );
+    EXPECT_TRUE( scheduler->is_task_due( cycle_scheduler::TC_FAST ) );
+    EXPECT_EQ( 2u, scheduler->get_task_runs_count( cycle_scheduler::TC_FAST ) );
+
+    // Первое выполнение - сразу, затем не чаще периода.
+    scheduler->set_task_period( cycle_scheduler::TC_SLOW, 10 );
+    EXPECT_TRUE( scheduler->is_task_due( cycle_scheduler::TC_SLOW ) );
+    EXPECT_FALSE( scheduler->is_task_due( cycle_scheduler::TC_SLOW ) );
+    EXPECT_FALSE( scheduler->is_task_executed( cycle_scheduler::TC_SLOW ) );
+    std::this_thread::sleep_for( 11ms );
+    EXPECT_TRUE( scheduler->is_task_due( cycle_scheduler::TC_SLOW ) );
+    EXPECT_EQ( 2u, scheduler->get_task_runs_count( cycle_scheduler::TC_SLOW ) );
+    EXPECT_EQ( 0u,
+        scheduler->get_task_overruns_count( cycle_scheduler::TC_SLOW ) );
+
+    // Пропущен целый период класса - превышение, расписание сдвигается.
+    std::this_thread::sleep_for( 25ms );
+    EXPECT_TRUE( scheduler->is_task_due( cycle_scheduler::TC_SLOW ) );
+    EXPECT_EQ( 1u,
+        scheduler->get_task_overruns_count( cycle_scheduler::TC_SLOW ) );
+    EXPECT_FALSE( scheduler->is_task_due( cycle_scheduler::TC_SLOW ) );
+
+    scheduler->reset();
+    EXPECT_EQ( 0u, scheduler->get_task_runs_count( cycle_scheduler::TC_SLOW ) );
+    EXPECT_EQ( 0u,
+        scheduler->get_task_overruns_count( cycle_scheduler::TC_SLOW ) );
+
+    EXPECT_STREQ( "FAST",
+        cycle_scheduler::get_task_class_name( cycle_scheduler::TC_FAST ) );
+    EXPECT_STREQ( "?", cycle_scheduler::get_task_class_name(
+        cycle_scheduler::TASK_CLASSES_COUNT ) );
+
+    scheduler->set_task_period( cycle_scheduler::TC_SLOW, 0 );
+    }
+
+TEST( cycle_scheduler, setup_current_thread )
+    {
+    // Без привязки и изменения приоритета - ничего не выполняется.
+    EXPECT_EQ( 0, cycle_scheduler::setup_current_thread( -1, 0 ) );
+#if defined LINUX_OS
+    cpu_set_t prev_cpuset;
+    ASSERT_EQ( 0, pthread_getaffinity_np( pthread_self(),
+        sizeof( prev_cpuset ), &prev_cpuset ) );
+    EXPECT_EQ( 0, cycle_scheduler::setup_current_thread( 0, 0 ) );
+    pthread_setaffinity_np( pthread_self(), sizeof( prev_cpuset ),
+        &prev_cpuset );
+#endif // defined LINUX_OS
+    }
@@ -0,0 +1,4 @@
+#pragma once
+#include "includes.h"
+
+#include "cycle_scheduler.h"
@@ -1510,10 +1510,25 @@ TEST( device, save_device )
     temperature_e_analog t1( "T1" );
     const int BUFF_SIZE = 200;
     char buff[ BUFF_SIZE ] = { 0 };
+    auto size = t1.save_device( buff );
+    const auto REF_STR =
+        "T1={M=0, ST=1, V=0, E=0, M_EXP=20.0, S_DEV=2.0, P_CZ=0, "
+        "P_ERR=0, P_MIN_V=0, P_MAX_V=0},\n";
+    EXPECT_STREQ( REF_STR, buff );
+
+    // Без изменений - копируется сохраненная строка.
+    std::fill( buff, buff + BUFF_SIZE, 0 );
+    EXPECT_EQ( size, t1.save_device( buff ) );
+    EXPECT_STREQ( REF_STR, buff );
+
+    // Изменение параметра и режима - строка формируется заново.
+    t1.set_par( 2, 0, 5 );
+    t1.set_cmd( "M", 0, 1 );
+    std::fill( buff, buff + BUFF_SIZE, 0 );
     t1.save_device( buff );
     EXPECT_STREQ(
-        "T1={M=0, ST=1, V=0, E=0, M_EXP=20.0, S_DEV=2.0, P_CZ=0, "
-        "P_ERR=0, P_MIN_V=0, P_MAX_V=0},\n", buff );
+        "T1={M=1, ST=1, V=0, E=0, M_EXP=20.0, S_DEV=2.0, P_CZ=0, "
+        "P_ERR=5, P_MIN_V=0, P_MAX_V=0},\n", buff );
     }
 
 TEST( device, set_article )
@@ -7091,11 +7106,32 @@ TEST( node_dev, basic_functionality )
     node->evaluate_io();
 
     // Сохранение устройства.
-    const int BUFF_SIZE = 200;
+    const int BUFF_SIZE = 300;
     std::array <char, BUFF_SIZE> buff{};
     node->save_device( buff.data() );
     EXPECT_STREQ( buff.data(),
-        "A100={ST=-1, WEB=0, STARTUP=0, IP='127.0.0.10'},\n" );
+        "A100={ST=-1, WEB=0, STARTUP=0, IP='127.0.0.10', "
+        "RECV_P50=0, RECV_P95=0, RECV_P99=0, RECV_MAX=0, "
+        "SEND_P99=0, SEND_MAX=0, CONNECT_P99=0, CONNECT_MAX=0},\n" );
+
+    // Статистика обмена с узлом.
+    for ( uint32_t i = 1; i <= 100; i++ )
+        {
+        nd.recv_hist.add( i * 10 );
+        }
+    nd.send_hist.add( 20 );
+    nd.connect_hist.add( 1'000 );
+    node->save_device( buff.data() );
+    EXPECT_STREQ( buff.data(),
+        "A100={ST=-1, WEB=0, STARTUP=0, IP='127.0.0.10', "
+        "RECV_P50=511, RECV_P95=1000, RECV_P99=1000, RECV_MAX=1000, "
+        "SEND_P99=20, SEND_MAX=20, CONNECT_P99=1000, CONNECT_MAX=1000},\n" );
+
+    // Сброс статистики выполняется при следующем обмене с узлом.
+    EXPECT_EQ( 0, node->set_cmd( "STAT_RESET", 0, 1 ) );
+    nd.check_stat_reset();
+    EXPECT_EQ( 0u, nd.recv_hist.get_count() );
+    EXPECT_EQ( 0u, nd.connect_hist.get_count() );
 
     // Очистка после теста.
     G_DEVICE_MANAGER()->clear_io_devices();
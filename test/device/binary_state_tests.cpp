@@ -0,0 +1,118 @@
+#include "binary_state_tests.h"
+
+#include <cstring>
+
+#include "device/device.h"
+
+using namespace ::testing;
+
+TEST( binary_state_writer, write_varint )
+    {
+    char buff[ 10 ]{};
+    uint32_t value = 0;
+
+    EXPECT_EQ( 1, binary_state_writer::write_varint( buff, 127 ) );
+    EXPECT_EQ( 1, binary_state_writer::read_varint( buff, value ) );
+    EXPECT_EQ( 127u, value );
+
+    EXPECT_EQ( 2, binary_state_writer::write_varint( buff, 300 ) );
+    EXPECT_EQ( '\xAC', buff[ 0 ] );
+    EXPECT_EQ( '\x02', buff[ 1 ] );
+    EXPECT_EQ( 2, binary_state_writer::read_varint( buff, value ) );
+    EXPECT_EQ( 300u, value );
+
+    EXPECT_EQ( 5, binary_state_writer::write_varint( buff, UINT32_MAX ) );
+    EXPECT_EQ( 5, binary_state_writer::read_varint( buff, value ) );
+    EXPECT_EQ( UINT32_MAX, value );
+    }
+
+TEST( binary_state_writer, write )
+    {
+    char buff[ 100 ]{};
+    std::vector< std::string > fields;
+    binary_state_writer writer( buff, &fields );
+
+    writer.write_uint( "M", 1 );
+    writer.write_int( "ST", -1 );
+    writer.write_float( "V", 12.5f );
+    EXPECT_EQ( 6, writer.get_size() );
+    EXPECT_EQ( 3, writer.get_fields_count() );
+    EXPECT_EQ( 1, buff[ 0 ] );
+    EXPECT_EQ( 1, buff[ 1 ] );      // Zigzag: -1 -> 1.
+    float v;
+    memcpy( &v, buff + 2, sizeof( v ) );
+    EXPECT_EQ( 12.5f, v );
+
+    const std::vector< std::string > REF_FIELDS = { "M:u", "ST:i", "V:f" };
+    EXPECT_EQ( REF_FIELDS, fields );
+
+    fields.clear();
+    binary_state_writer array_writer( buff, &fields );
+    array_writer.write_bool( "READY", true );
+    array_writer.write_ints( "ST_CH", { 1, -1 } );
+    array_writer.write_floats( "CH", { 1.f, 2.f } );
+    EXPECT_EQ( 11, array_writer.get_size() );
+    EXPECT_EQ( 5, array_writer.get_fields_count() );
+    const std::vector< std::string > REF_ARRAY_FIELDS =
+        { "READY:u", "ST_CH[1]:i", "ST_CH[2]:i", "CH[1]:f", "CH[2]:f" };
+    EXPECT_EQ( REF_ARRAY_FIELDS, fields );
+
+    // Без схемы записываются только значения.
+    binary_state_writer writer_without_schema( buff );
+    writer_without_schema.write_int( "ST", 64 );
+    EXPECT_EQ( 2, writer_without_schema.get_size() );
+    EXPECT_EQ( 1, writer_without_schema.get_fields_count() );
+    }
+
+TEST( binary_state_writer, write_Lua_fields )
+    {
+    char buff[ 100 ]{};
+    std::vector< std::string > fields;
+    binary_state_writer writer( buff, &fields );
+
+    writer.write_Lua_fields(
+        "ABS_V=10, F=1.50, CH={1.00,2.50}, IP='127.0.0.1', ERR=-1, " );
+    const std::vector< std::string > REF_FIELDS =
+        { "ABS_V:f", "F:f", "CH[1]:f", "CH[2]:f", "ERR:f" };
+    EXPECT_EQ( REF_FIELDS, fields );
+    EXPECT_EQ( 20, writer.get_size() );
+
+    float v;
+    memcpy( &v, buff + 12, sizeof( v ) );
+    EXPECT_EQ( 2.5f, v );
+    memcpy( &v, buff + 16, sizeof( v ) );
+    EXPECT_EQ( -1.f, v );
+
+    // Окончание описания устройства ("}},") пропускается.
+    fields.clear();
+    binary_state_writer node_writer( buff, &fields );
+    node_writer.write_Lua_fields( "ST=1, WEB=0}},\n" );
+    EXPECT_EQ( 2, node_writer.get_fields_count() );
+
+    // Логические значения и нечисловые значения, за которыми следуют
+    // другие поля.
+    fields.clear();
+    binary_state_writer bool_writer( buff, &fields );
+    bool_writer.write_Lua_fields(
+        "RESULT=0, READY=true, MODE=auto, CH={1,x,2}, OK=false}," );
+    const std::vector< std::string > REF_BOOL_FIELDS =
+        { "RESULT:f", "READY:u", "CH[1]:f", "CH[2]:f", "OK:u" };
+    EXPECT_EQ( REF_BOOL_FIELDS, fields );
+    EXPECT_EQ( 14, bool_writer.get_size() );
+    EXPECT_EQ( 1, buff[ 4 ] );
+    EXPECT_EQ( 0, buff[ 13 ] );
+    }
+
+TEST( binary_state_writer, camera )
+    {
+    char buff[ 100 ]{};
+    std::vector< std::string > fields;
+    binary_state_writer writer( buff, &fields );
+
+    camera test_dev( "test_CAM1", device::DST_CAM_DO1_DI1 );
+    test_dev.save_device_binary( writer );
+    const std::vector< std::string > REF_FIELDS =
+        { "M:u", "ST:i", "V:f", "RESULT:i", "READY:u" };
+    EXPECT_EQ( REF_FIELDS, fields );
+    EXPECT_EQ( 1, buff[ writer.get_size() - 1 ] );  // READY=true.
+    }
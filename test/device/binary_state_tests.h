@@ -0,0 +1,4 @@
+#pragma once
+#include "../includes.h"
+
+#include "device/binary_state.h"
@@ -1,8 +1,13 @@
+#include <algorithm>
+
 #include "g_device_tests.h"
 #include "tcp_cmctr.h"
 #include "lua_manager.h"
 #include "device/manager.h"
 #include "g_errors.h"
+#include "cycle_profiler.h"
+#include "PAC_info.h"
+#include "mock_tcp_communicator.h"
 
 using namespace ::testing;
 
@@ -56,6 +61,398 @@ TEST( device_communicator, write_devices_states_service )
     tcp_communicator::clear_instance();
     }
 
+TEST( device_communicator, get_cycle_profile )
+    {
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    unsigned char data[] = { device_communicator::CMD_GET_CYCLE_PROFILE, 0 };
+
+    G_CYCLE_PROFILER()->reset();
+    G_CYCLE_PROFILER()->start_cycle();
+    G_CYCLE_PROFILER()->end_cycle();
+
+    device_communicator::switch_off_compression();
+    auto size = device_communicator::write_devices_states_service(
+        sizeof( data ), data, out_data.data() );
+    auto str = reinterpret_cast<const char*>( out_data.data() );
+    EXPECT_EQ( static_cast<size_t>( size ), strlen( str ) + 1 );
+    EXPECT_EQ( str, strstr( str, "t.CYCLE_PROFILE = \n\t{\n\tCYCLES=1,\n" ) );
+    EXPECT_EQ( 1u, G_CYCLE_PROFILER()->get_cycle_hist().get_count() );
+
+    // Получение со сбросом статистики.
+    data[ 1 ] = 1;
+    device_communicator::write_devices_states_service(
+        sizeof( data ), data, out_data.data() );
+    EXPECT_EQ( 0u, G_CYCLE_PROFILER()->get_cycle_hist().get_count() );
+
+    device_communicator::switch_on_compression();
+    }
+
+TEST( device_communicator, get_devices_states_delta )
+    {
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    unsigned char data[ 9 ] =
+        { device_communicator::CMD_GET_DEVICES_STATES_DELTA };
+    uint32_t session_id = 0;
+    uint32_t seq = 0;
+    auto str = reinterpret_cast<const char*>( out_data.data() + 11 );
+
+    auto request = [ & ]()
+        {
+        memcpy( data + 1, &session_id, sizeof( session_id ) );
+        memcpy( data + 5, &seq, sizeof( seq ) );
+        auto size = device_communicator::write_devices_states_service(
+            sizeof( data ), data, out_data.data() );
+        memcpy( &session_id, out_data.data() + 2, sizeof( session_id ) );
+        memcpy( &seq, out_data.data() + 6, sizeof( seq ) );
+        EXPECT_EQ( static_cast<size_t>( size ), 11 + strlen( str ) + 1 );
+        return out_data[ 10 ];  // Признак полного состояния.
+        };
+
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "DELTA_V1", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "DELTA_V1" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    device_communicator::switch_off_compression();
+
+    // Первый запрос - полное состояние, как для CMD_GET_DEVICES_STATES.
+    EXPECT_EQ( 1, request() );
+    EXPECT_EQ( str, strstr( str, "t=\n\t{\n" ) );
+    EXPECT_NE( nullptr, strstr( str, "\tDELTA_V1={M=0, " ) );
+    EXPECT_NE( 0u, seq );
+
+    // Нет изменений - пустой ответ.
+    auto prev_seq = seq;
+    EXPECT_EQ( 0, request() );
+    EXPECT_STREQ( "", str );
+    EXPECT_EQ( prev_seq, seq );
+
+    // Только изменившиеся устройства.
+    v1->set_cmd( "ST", 0, 1 );
+    EXPECT_EQ( 0, request() );
+    EXPECT_EQ( str, strstr( str, "t_delta=\n\t{\n\tDELTA_V1={M=0, " ) );
+    EXPECT_NE( nullptr, strstr( str,
+        "\t}\nfor k, v in pairs( t_delta ) do t[ k ] = v end\n" ) );
+    EXPECT_EQ( prev_seq + 1, seq );
+
+    // Неизвестный сеанс - полное состояние.
+    session_id++;
+    EXPECT_EQ( 1, request() );
+    EXPECT_EQ( str, strstr( str, "t=\n\t{\n" ) );
+
+    // Изменение состава устройств - полное состояние.
+    prev_seq = seq;
+    G_DEVICE_CMMCTR->add_device( G_PAC_INFO() );
+    EXPECT_EQ( 1, request() );
+    EXPECT_NE( nullptr, strstr( str, "t.SYSTEM = " ) );
+    EXPECT_EQ( prev_seq + 1, seq );
+
+    v1->set_cmd( "ST", 0, 0 );
+    G_DEVICE_CMMCTR->clear_devices();
+    device_communicator::switch_on_compression();
+    }
+
+TEST( device_communicator, get_devices_states_binary )
+    {
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    auto str = reinterpret_cast<const char*>( out_data.data() );
+
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "BIN_V1", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "BIN_V1" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    device_communicator::switch_off_compression();
+
+    // Состояние до получения схемы - схема устарела.
+    unsigned char states_cmd[] = { device_communicator::CMD_GET_DEVICES_STATES,
+        device_communicator::ENC_BINARY };
+    device_communicator::write_devices_states_service( sizeof( states_cmd ),
+        states_cmd, out_data.data() );
+    uint32_t schema_id = 1;
+    memcpy( &schema_id, out_data.data() + 2, sizeof( schema_id ) );
+    EXPECT_EQ( 0u, schema_id );
+
+    // Схема передается вместе с описанием устройств.
+    unsigned char devices_cmd[] = { device_communicator::CMD_GET_DEVICES,
+        0, 0, device_communicator::ENC_BINARY };
+    device_communicator::write_devices_states_service( sizeof( devices_cmd ),
+        devices_cmd, out_data.data() );
+    auto schema = strstr( str + 2, "t_states_schema=\n\t{\n" );
+    ASSERT_NE( nullptr, schema );
+    EXPECT_NE( nullptr, strstr( schema, "\t{ 'BIN_V1', 'M:u', 'ST:i', " ) );
+    auto schema_id_str = strstr( schema, "t_states_schema_id=" );
+    ASSERT_NE( nullptr, schema_id_str );
+    auto REF_SCHEMA_ID = static_cast<uint32_t>(
+        strtoul( schema_id_str + strlen( "t_states_schema_id=" ), nullptr, 10 ) );
+
+    v1->set_cmd( "M", 0, 1 );
+    auto size = device_communicator::write_devices_states_service(
+        sizeof( states_cmd ), states_cmd, out_data.data() );
+    memcpy( &schema_id, out_data.data() + 2, sizeof( schema_id ) );
+    EXPECT_EQ( REF_SCHEMA_ID, schema_id );
+
+    // Поиск записи устройства: номер, M, ST.
+    auto data = reinterpret_cast<const char*>( out_data.data() );
+    uint32_t count = 0;
+    auto pos = 6 + binary_state_writer::read_varint( data + 6, count );
+    EXPECT_EQ( G_DEVICE_MANAGER()->get_device_count(), count );
+    auto index = v1->get_serial_n();
+    char ref_record[ 10 ]{};
+    auto ref_size = binary_state_writer::write_varint( ref_record, index );
+    ref_record[ ref_size++ ] = 1;   // M
+    auto it = std::search( data + pos, data + size,
+        ref_record, ref_record + ref_size );
+    EXPECT_NE( data + size, it );
+    v1->set_cmd( "M", 0, 0 );
+
+    // Устройство заменено другим с тем же количеством полей - схема
+    // устарела.
+    G_DEVICE_MANAGER()->clear_io_devices();
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "BIN_V1", "Test valve", "Gea" );
+    device_communicator::write_devices_states_service( sizeof( devices_cmd ),
+        devices_cmd, out_data.data() );
+    device_communicator::write_devices_states_service( sizeof( states_cmd ),
+        states_cmd, out_data.data() );
+    memcpy( &schema_id, out_data.data() + 2, sizeof( schema_id ) );
+    EXPECT_NE( 0u, schema_id );
+
+    G_DEVICE_MANAGER()->clear_io_devices();
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "BIN_V2", "Test valve", "Gea" );
+    device_communicator::write_devices_states_service( sizeof( states_cmd ),
+        states_cmd, out_data.data() );
+    memcpy( &schema_id, out_data.data() + 2, sizeof( schema_id ) );
+    EXPECT_EQ( 0u, schema_id );
+
+    G_DEVICE_MANAGER()->clear_io_devices();
+    G_DEVICE_CMMCTR->clear_devices();
+    device_communicator::switch_on_compression();
+    }
+
+TEST( device_communicator, get_devices_states_compression_dictionary )
+    {
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    std::vector< char > str( tcp_communicator::BUFSIZE );
+    unsigned char data[ 1 ] = { device_communicator::CMD_GET_COMPRESSION_DICTIONARY };
+
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "DICT_V1", "Test valve", "Gea" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    device_communicator::switch_on_compression();
+    auto& par = G_PAC_INFO()->par;
+    par[ PAC_info::P_COMPRESSION_LEVEL ] = 1;
+    par[ PAC_info::P_COMPRESSION_STRATEGY ] = Z_RLE;
+    par[ PAC_info::P_COMPRESSION_DICTIONARY ] = 1;
+
+    // Словарь сжимается без словаря.
+    auto size = device_communicator::write_devices_states_service(
+        sizeof( data ), data, out_data.data() );
+    EXPECT_EQ( 0, out_data[ 1 ] & 0x20 );   // FDICT.
+    uLongf str_size = tcp_communicator::BUFSIZE;
+    ASSERT_EQ( Z_OK, uncompress( reinterpret_cast<Bytef*>( str.data() ),
+        &str_size, out_data.data(), size ) );
+    uint32_t dictionary_id = 0;
+    memcpy( &dictionary_id, str.data(), sizeof( dictionary_id ) );
+    std::string dictionary( str.data() + sizeof( dictionary_id ) );
+    EXPECT_NE( std::string::npos, dictionary.find( "\tDICT_V1={M=0, " ) );
+
+    // Состояние устройств сжимается со словарем.
+    data[ 0 ] = device_communicator::CMD_GET_DEVICES_STATES;
+    size = device_communicator::write_devices_states_service(
+        sizeof( data ), data, out_data.data() );
+    EXPECT_NE( 0, out_data[ 1 ] & 0x20 );   // FDICT.
+
+    z_stream strm{};
+    ASSERT_EQ( Z_OK, inflateInit( &strm ) );
+    strm.next_in = out_data.data();
+    strm.avail_in = static_cast<uInt>( size );
+    strm.next_out = reinterpret_cast<Bytef*>( str.data() );
+    strm.avail_out = tcp_communicator::BUFSIZE;
+    EXPECT_EQ( Z_NEED_DICT, inflate( &strm, Z_FINISH ) );
+    EXPECT_EQ( dictionary_id, strm.adler );
+    EXPECT_EQ( Z_OK, inflateSetDictionary( &strm,
+        reinterpret_cast<const Bytef*>( dictionary.c_str() ),
+        static_cast<uInt>( dictionary.size() ) ) );
+    EXPECT_EQ( Z_STREAM_END, inflate( &strm, Z_FINISH ) );
+    inflateEnd( &strm );
+    EXPECT_NE( nullptr, strstr( str.data() + 2, "\tDICT_V1={M=0, " ) );
+
+    par[ PAC_info::P_COMPRESSION_LEVEL ] = 0;
+    par[ PAC_info::P_COMPRESSION_STRATEGY ] = 0;
+    par[ PAC_info::P_COMPRESSION_DICTIONARY ] = 0;
+    G_DEVICE_CMMCTR->clear_devices();
+    }
+
+TEST( device_communicator, subscribe_devices_states )
+    {
+    auto tcp_mock = new mock_tcp_communicator();
+    test_tcp_communicator::replaceEntity( tcp_mock );
+
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    unsigned char data[] = { device_communicator::CMD_SUBSCRIBE_DEVICES_STATES,
+        0, 0, 'S', 'U', 'B', '_', 'V', '1', 0 };
+
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "SUB_V1", "Test valve", "Gea" );
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "SUB_V2", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "SUB_V1" );
+    auto v2 = G_DEVICE_MANAGER()->get_device( "SUB_V2" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    G_DEVICE_CMMCTR->add_device( G_PAC_INFO() );
+    device_communicator::switch_off_compression();
+
+    auto push_count = 0;
+    auto push_res = static_cast<int>( tcp_communicator::PUSH_OK );
+    auto is_full = false;
+    std::string str;
+    EXPECT_CALL( *tcp_mock, push( 5, device_communicator::C_SERVICE_N, _, _ ) )
+        .WillRepeatedly( Invoke( [ & ]( u_int, u_char, const u_char* d, u_int )
+            {
+            push_count++;
+            is_full = d[ 8 ] != 0;
+            str = reinterpret_cast<const char*>( d + 9 );
+            return push_res;
+            } ) );
+
+    // Вне соединения (передача по инициативе PAC не поддерживается).
+    device_communicator::write_devices_states_service( sizeof( data ), data,
+        out_data.data() );
+    EXPECT_EQ( 1, out_data[ 0 ] );
+
+    test_tcp_communicator::set_service_connection_id( 5 );
+    device_communicator::write_devices_states_service( sizeof( data ), data,
+        out_data.data() );
+    test_tcp_communicator::set_service_connection_id( 0 );
+    EXPECT_EQ( 0, out_data[ 0 ] );
+
+    // Первая передача - полное состояние устройств фильтра.
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 1, push_count );
+    EXPECT_TRUE( is_full );
+    EXPECT_NE( std::string::npos, str.find( "\tSUB_V1={M=0, " ) );
+    EXPECT_EQ( std::string::npos, str.find( "SUB_V2" ) );
+    EXPECT_EQ( std::string::npos, str.find( "t.SYSTEM" ) );
+
+    // Нет изменений - нет передачи.
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 1, push_count );
+
+    // Изменения устройств вне фильтра не передаются.
+    v2->set_cmd( "ST", 0, 1 );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 1, push_count );
+
+    // Соединение занято - изменения передаются позже.
+    push_res = tcp_communicator::PUSH_BUSY;
+    v1->set_cmd( "ST", 0, 1 );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 2, push_count );
+    push_res = tcp_communicator::PUSH_OK;
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 3, push_count );
+    EXPECT_FALSE( is_full );
+    EXPECT_EQ( 0u, str.find( "t_delta=\n\t{\n\tSUB_V1={M=0, " ) );
+
+    // Соединение еще передает данные - передача не выполняется.
+    EXPECT_CALL( *tcp_mock, is_push_busy( 5 ) )
+        .WillRepeatedly( Return( true ) );
+    v1->set_cmd( "ST", 0, 0 );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 3, push_count );
+    EXPECT_CALL( *tcp_mock, is_push_busy( 5 ) )
+        .WillRepeatedly( Return( false ) );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 4, push_count );
+    EXPECT_EQ( 0u, str.find( "t_delta=\n\t{\n\tSUB_V1={M=0, " ) );
+
+    // Соединение закрыто - подписка удаляется.
+    push_res = tcp_communicator::PUSH_NO_CONNECTION;
+    v1->set_cmd( "ST", 0, 1 );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 5, push_count );
+    v1->set_cmd( "ST", 0, 0 );
+    G_DEVICE_CMMCTR->evaluate_subscriptions();
+    EXPECT_EQ( 5, push_count );
+
+    v1->set_cmd( "ST", 0, 0 );
+    v2->set_cmd( "ST", 0, 0 );
+    G_DEVICE_CMMCTR->clear_devices();
+    device_communicator::switch_on_compression();
+    test_tcp_communicator::removeObject();
+    }
+
+TEST( device_set_cmd, parse )
+    {
+    device_set_cmd cmd;
+    EXPECT_TRUE( cmd.parse( "V1:set_cmd( \"ST\", 0, 1 )" ) );
+    EXPECT_TRUE( cmd.parse( "__V1:set_cmd('ST',0,1);" ) );
+    EXPECT_TRUE( cmd.parse( " t.TANK1:set_cmd( \"CMD\", 0, 1001 ) \n" ) );
+    EXPECT_TRUE( cmd.parse( "V1:set_cmd( \"P_ON_TIME\", 0, -2.5 )" ) );
+
+    EXPECT_FALSE( cmd.parse( "" ) );
+    EXPECT_FALSE( cmd.parse( "V1:set_cmd( \"ST\", 0, 1 ) V2:on()" ) );
+    EXPECT_FALSE( cmd.parse( "V1:set_cmd( \"DESCR\", 0, \"text\" )" ) );
+    EXPECT_FALSE( cmd.parse( "V1:set_cmd( \"ST\", -1, 1 )" ) );
+    EXPECT_FALSE( cmd.parse( "V1:set_cmd( \"ST\", 0, inf )" ) );
+    EXPECT_FALSE( cmd.parse( "V1:set_cmd( \"ST\", 0, 1" ) );
+    EXPECT_FALSE( cmd.parse( "V1.set_cmd( \"ST\", 0, 1 )" ) );
+    EXPECT_FALSE( cmd.parse( "V1:on()" ) );
+    EXPECT_FALSE( cmd.parse( "__RECMAN[1]:set_cmd( \"hello\", 1, 2.5 )" ) );
+    }
+
+TEST( device_communicator, exec_device_commands )
+    {
+    auto L = lua_open();
+    G_LUA_MANAGER->set_Lua( L );
+
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "CMD_V1", "Test valve", "Gea" );
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "CMD_V2", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "CMD_V1" );
+    auto v2 = G_DEVICE_MANAGER()->get_device( "CMD_V2" );
+    device_communicator::switch_off_compression();
+
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    std::string cmd( 1, static_cast<char>(
+        device_communicator::CMD_EXEC_DEVICE_COMMAND ) );
+    cmd += "__CMD_V1:set_cmd( \"M\", 0, 1 )";
+    cmd += '\0';
+    std::vector< unsigned char > data( cmd.begin(), cmd.end() );
+    device_communicator::write_devices_states_service( data.size(),
+        data.data(), out_data.data() );
+    EXPECT_EQ( 0, out_data[ 0 ] );
+    EXPECT_TRUE( v1->get_manual_mode() );
+
+    // Несколько команд, неизвестная команда выполняется Lua (с ошибкой).
+    cmd.assign( 1, static_cast<char>(
+        device_communicator::CMD_EXEC_DEVICE_COMMANDS ) );
+    cmd += "CMD_V1:set_cmd( \"M\", 0, 0 )";
+    cmd += '\0';
+    cmd += "CMD_V2:set_cmd( 'M', 0, 1 )";
+    cmd += '\0';
+    cmd += "NO_SUCH_OBJECT:set_cmd( \"M\", 0, 1 )";
+    cmd += '\0';
+    data.assign( cmd.begin(), cmd.end() );
+    auto size = device_communicator::write_devices_states_service(
+        data.size(), data.data(), out_data.data() );
+    EXPECT_EQ( 2, size );
+    u_int_2 errors_count = 0;
+    memcpy( &errors_count, out_data.data(), sizeof( errors_count ) );
+    EXPECT_EQ( 1, errors_count );
+    EXPECT_FALSE( v1->get_manual_mode() );
+    EXPECT_TRUE( v2->get_manual_mode() );
+
+    v2->set_cmd( "M", 0, 0 );
+    device_communicator::switch_on_compression();
+    G_LUA_MANAGER->free_Lua();
+    }
+
 TEST( device_communicator, print )
     {
     std::string STR_check = R"(Device communicator. Dev count = 0.
@@ -147,3 +544,68 @@ suppress=false
 
     G_DEVICE_MANAGER()->clear_io_devices();
     }
+
+TEST( device_communicator, answers_cache )
+    {
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "CACHE_V1", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "CACHE_V1" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    device_communicator::switch_off_compression();
+
+    // Как и в tcp_communicator, ответ записывается в тот же буфер со
+    // смещением на байт назад относительно запроса.
+    std::vector< unsigned char > buff( tcp_communicator::BUFSIZE );
+    auto str = reinterpret_cast<const char*>( buff.data() + 2 );
+    auto service = [ & ]( const std::string& request )
+        {
+        memcpy( buff.data() + 1, request.data(), request.size() );
+        return device_communicator::write_devices_states_service(
+            request.size(), buff.data() + 1, buff.data() );
+        };
+    const std::string get_states_cmd( 1, static_cast<char>(
+        device_communicator::CMD_GET_DEVICES_STATES ) );
+    auto get_states = [ & ]()
+        {
+        return service( get_states_cmd );
+        };
+
+    G_DEVICE_CMMCTR->start_answers_cache();
+    auto size = get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+
+    // Повторный запрос в том же обмене - сохраненный ответ.
+    v1->set_cmd( "M", 0, 1 );
+    EXPECT_EQ( size, get_states() );
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+
+    // Другой запрос не получает сохраненный ответ на первый.
+    std::string get_errors_cmd( 1, static_cast<char>(
+        device_communicator::CMD_GET_PAC_ERRORS ) );
+    get_errors_cmd += '\0';
+    service( get_errors_cmd );
+    EXPECT_EQ( 0, strncmp( reinterpret_cast<const char*>( buff.data() ),
+        "alarms[", 7 ) );
+    EXPECT_EQ( size, get_states() );
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+
+    // Команда изменяет состояние - кэш очищается.
+    std::string cmd( 1, static_cast<char>(
+        device_communicator::CMD_EXEC_DEVICE_COMMAND ) );
+    cmd += "CACHE_V1:set_cmd( \"M\", 0, 0 )";
+    cmd += '\0';
+    service( cmd );
+    v1->set_cmd( "M", 0, 1 );
+    get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=1, " ) );
+
+    // После окончания обмена кэш не используется.
+    G_DEVICE_CMMCTR->stop_answers_cache();
+    v1->set_cmd( "M", 0, 0 );
+    get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+
+    G_DEVICE_CMMCTR->clear_devices();
+    device_communicator::switch_on_compression();
+    }
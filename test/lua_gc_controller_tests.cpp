@@ -0,0 +1,67 @@
+#include "lua_gc_controller_tests.h"
+#include "PAC_info.h"
+#include "lauxlib.h"
+
+using namespace ::testing;
+
+TEST( lua_gc_controller, step )
+    {
+    auto L = lua_open();
+    lua_gc( L, LUA_GCSTOP, 0 );
+    auto gc = G_LUA_GC_CONTROLLER();
+    gc->reset();
+    auto& par = G_PAC_INFO()->par;
+    par[ PAC_info::P_LUA_GC_ADAPTIVE ] = 0;
+    par[ PAC_info::P_LUA_GC_FULL_THRESHOLD ] = 0;
+
+    // Без адаптивного режима - фиксированный шаг.
+    gc->step( L );
+    EXPECT_EQ( lua_gc_controller::C_DEFAULT_STEP_KB, gc->get_last_step() );
+    EXPECT_EQ( lua_gc_controller::read_heap_size( L ), gc->get_heap_size() );
+    EXPECT_GT( gc->get_heap_size(), 0u );
+    EXPECT_EQ( 1u, gc->get_gc_time_hist().get_count() );
+
+    // Адаптивный режим - шаг по приросту кучи.
+    par[ PAC_info::P_LUA_GC_ADAPTIVE ] = 1;
+    gc->step( L );
+    EXPECT_EQ( lua_gc_controller::C_MIN_STEP_KB, gc->get_last_step() );
+
+    const char* ALLOC_SCRIPT =
+        "t = {} for i = 1, 50000 do t[ i ] = { i } end t = nil";
+    ASSERT_EQ( 0, luaL_dostring( L, ALLOC_SCRIPT ) );
+    gc->step( L );
+    EXPECT_EQ( lua_gc_controller::C_MAX_STEP_KB, gc->get_last_step() );
+
+    // Нет свободного времени цикла - минимальный шаг.
+    ASSERT_EQ( 0, luaL_dostring( L, ALLOC_SCRIPT ) );
+    gc->step( L, 0 );
+    EXPECT_EQ( lua_gc_controller::C_MIN_STEP_KB, gc->get_last_step() );
+
+    // Превышение порога - полная сборка мусора.
+    par[ PAC_info::P_LUA_GC_FULL_THRESHOLD ] = 1;
+    ASSERT_EQ( 0, luaL_dostring( L, ALLOC_SCRIPT ) );
+    gc->step( L );
+    EXPECT_EQ( 0u, gc->get_last_step() );
+    EXPECT_EQ( 1u, gc->get_full_collections_count() );
+
+    // Живой объем кучи выше порога - без повторной полной сборки.
+    gc->step( L );
+    EXPECT_NE( 0u, gc->get_last_step() );
+    EXPECT_EQ( 1u, gc->get_full_collections_count() );
+
+    // Прирост сверх живого объема - снова полная сборка.
+    ASSERT_EQ( 0, luaL_dostring( L, ALLOC_SCRIPT ) );
+    gc->step( L );
+    EXPECT_EQ( 0u, gc->get_last_step() );
+    EXPECT_EQ( 2u, gc->get_full_collections_count() );
+    EXPECT_EQ( 7u, gc->get_gc_time_hist().get_count() );
+
+    gc->reset();
+    EXPECT_EQ( 0u, gc->get_heap_size() );
+    EXPECT_EQ( 0u, gc->get_full_collections_count() );
+    EXPECT_EQ( 0u, gc->get_gc_time_hist().get_count() );
+
+    par[ PAC_info::P_LUA_GC_ADAPTIVE ] = 0;
+    par[ PAC_info::P_LUA_GC_FULL_THRESHOLD ] = 0;
+    lua_close( L );
+    }
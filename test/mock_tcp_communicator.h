@@ -6,6 +6,9 @@ class mock_tcp_communicator : public tcp_communicator
 {
     public:
     MOCK_METHOD(srv_ptr, reg_service, (u_char srv_id, srv_ptr fk));
+    MOCK_METHOD(int, push, (u_int connection_id, u_char srv_id,
+        const u_char* data, u_int size));
+    MOCK_METHOD(bool, is_push_busy, (u_int connection_id), (const));
 
     int evaluate() { return 0; };
 };
@@ -24,4 +27,9 @@ class test_tcp_communicator
         tcp_communicator::instance = NULL;
         tcp_communicator::is_init = false;
     }
+
+    static void set_service_connection_id(u_int id)
+    {
+        tcp_communicator::instance->service_connection_id = id;
+    }
 };
@@ -1,5 +1,6 @@
 #include "modbus_serv_tests.h"
 #include "lua_manager.h"
+#include "tcp_cmctr.h"
 
 extern int isMsa;
 void InitCipDevices();
@@ -89,3 +90,72 @@ end)";
 
     G_LUA_MANAGER->free_Lua();
     }
+
+TEST( ModbusServ, get_device )
+    {
+    G_LUA_MANAGER->set_Lua( lua_open() );
+    InitCipDevices();
+    cipline_tech_object cip1( "CIP1", 1, 1, "CIP1", 1, 1, 200, 200, 200, 200 );
+    cip1.initline();
+    auto stub = G_DEVICE_MANAGER()->get_stub_device();
+
+    ModbusServ::update_devices_map();
+    EXPECT_EQ( (device*)V( "LINE1V1" ), ModbusServ::get_device( C_V, 101 ) );
+    EXPECT_NE( stub, ModbusServ::get_device( C_V, 101 ) );
+    EXPECT_EQ( stub, ModbusServ::get_device( C_V, 114 ) );
+    EXPECT_EQ( stub, ModbusServ::get_device( C_V, 201 ) );
+    EXPECT_EQ( stub, ModbusServ::get_device( C_LINE1VALVES, 1001 ) );
+
+    // Карта перестраивается при изменении состава устройств.
+    auto v1001 = G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_VIRT, "LINE1V1001", "", "" );
+    ModbusServ::update_devices_map();
+    EXPECT_EQ( dynamic_cast<device*>( v1001 ),
+        ModbusServ::get_device( C_LINE1VALVES, 1001 ) );
+    EXPECT_EQ( stub, ModbusServ::get_device( C_LINE1VALVES, 1003 ) );
+
+    G_DEVICE_MANAGER()->clear_io_devices();
+    G_LUA_MANAGER->free_Lua();
+    }
+
+TEST( ModbusServ, ModbusService_clears_answers_cache )
+    {
+    G_LUA_MANAGER->set_Lua( lua_open() );
+    G_DEVICE_MANAGER()->add_io_device( device::DT_V,
+        device::DST_V_DO1_DI1_FB_OFF, "CACHE_V1", "Test valve", "Gea" );
+    auto v1 = G_DEVICE_MANAGER()->get_device( "CACHE_V1" );
+    G_DEVICE_CMMCTR->clear_devices();
+    G_DEVICE_CMMCTR->add_device( G_DEVICE_MANAGER() );
+    device_communicator::switch_off_compression();
+
+    std::vector< unsigned char > out_data( tcp_communicator::BUFSIZE );
+    auto str = reinterpret_cast<const char*>( out_data.data() + 2 );
+    unsigned char data[] = { device_communicator::CMD_GET_DEVICES_STATES };
+    auto get_states = [ & ]()
+        {
+        return device_communicator::write_devices_states_service(
+            sizeof( data ), data, out_data.data() );
+        };
+
+    G_DEVICE_CMMCTR->start_answers_cache();
+    get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+    v1->set_cmd( "M", 0, 1 );
+    get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=0, " ) );
+
+    // Запись по Modbus изменяет состояние - кэш очищается.
+    isMsa = 0;
+    const auto BUFSIZE = 100;
+    u_char buf[ BUFSIZE ] = { 0 };
+    buf[ 1 ] = 0x05;    // Write Single Coil.
+    ModbusServ::ModbusService( BUFSIZE, buf, buf );
+    get_states();
+    EXPECT_NE( nullptr, strstr( str, "\tCACHE_V1={M=1, " ) );
+
+    G_DEVICE_CMMCTR->stop_answers_cache();
+    G_DEVICE_CMMCTR->clear_devices();
+    device_communicator::switch_on_compression();
+    G_DEVICE_MANAGER()->clear_io_devices();
+    G_LUA_MANAGER->free_Lua();
+    }
@@ -0,0 +1,178 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "uni_bus_coupler_io.h"
+#include "PAC_info.h"
+#include "modbus_coupler_simulator.h"
+
+int G_DEBUG = 0;            // Вывод дополнительной отладочной информации.
+bool G_NO_IO_NODES = false;
+bool G_READ_ONLY_IO_NODES = false;
+
+namespace
+    {
+    const uint16_t SIMULATOR_PORT = 10502;
+
+    /// @brief Профили симулятора узлов.
+    enum SIMULATOR_PROFILE
+        {
+        P_NO_LATENCY = 0,   ///< Ответ без задержки.
+        P_LATENCY,          ///< Задержка 1 мс, разброс до 0,5 мс.
+        P_LOSS,             ///< Задержка 1 мс, потеря 0,1% запросов.
+        };
+
+    std::unique_ptr< modbus_coupler_simulator > simulator;
+    int simulator_profile = -1;
+
+    void start_simulator( int profile )
+        {
+        if ( simulator && profile == simulator_profile )
+            {
+            return;
+            }
+
+        modbus_coupler_simulator::config cfg;
+        cfg.port = SIMULATOR_PORT;
+        if ( profile != P_NO_LATENCY )
+            {
+            cfg.latency_us = 1'000;
+            }
+        if ( P_LATENCY == profile )
+            {
+            cfg.jitter_us = 500;
+            }
+        if ( P_LOSS == profile )
+            {
+            cfg.loss = 0.001;
+            }
+
+        simulator = nullptr;
+        simulator = std::make_unique< modbus_coupler_simulator >( cfg );
+        simulator->start();
+        simulator_profile = profile;
+        }
+
+    /// @brief Создание узлов и подключение к симулятору.
+    ///
+    /// @return - true - подключение ко всем узлам выполнено.
+    bool init_nodes( uni_io_manager& mngr, u_int nodes_count,
+        io_manager::io_node::TYPES type )
+        {
+        mngr.set_port( SIMULATOR_PORT );
+        mngr.init( nodes_count );
+        for ( u_int i = 0; i < nodes_count; i++ )
+            {
+            auto name = "A" + std::to_string( 100 * ( i + 1 ) );
+            if ( io_manager::io_node::PHOENIX_BK_ETH == type )
+                {
+                // 8 регистров входов (в том числе 128 DI) и выходов.
+                mngr.add_node( i, type, i + 1, "127.0.0.1", name.c_str(),
+                    128, 128, 8, 16, 8, 16 );
+                }
+            else
+                {
+                mngr.add_node( i, type, i + 1, "127.0.0.1", name.c_str(),
+                    16, 16, 4, 8, 4, 8 );
+                }
+            }
+
+        for ( int i = 0; i < 100; i++ )
+            {
+            mngr.read_inputs();
+
+            u_int connected = 0;
+            for ( u_int j = 0; j < nodes_count; j++ )
+                {
+                if ( mngr.get_node( j )->state == io_manager::io_node::ST_OK )
+                    {
+                    connected++;
+                    }
+                }
+            if ( connected == nodes_count )
+                {
+                return true;
+                }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            }
+
+        return false;
+        }
+
+    /// @brief Обмен с узлами: args - количество узлов, профиль симулятора,
+    /// конвейерный обмен (0/1).
+    void io_exchange( benchmark::State& state,
+        io_manager::io_node::TYPES type, bool is_read )
+        {
+        auto nodes_count = static_cast<u_int>( state.range( 0 ) );
+        start_simulator( static_cast<int>( state.range( 1 ) ) );
+        G_PAC_INFO()->par[ PAC_info::P_IO_PIPELINED_EXCHANGE ] =
+            static_cast<u_int_4>( state.range( 2 ) );
+
+        uni_io_manager mngr;
+        if ( !init_nodes( mngr, nodes_count, type ) )
+            {
+            state.SkipWithError( "Connection to the simulator failed" );
+            return;
+            }
+
+        auto errors = 0;
+        u_int_2 value = 0;
+        for ( auto _ : state )
+            {
+            if ( is_read )
+                {
+                errors += mngr.read_inputs();
+                }
+            else
+                {
+                // Изменение выходов, чтобы они записывались каждый цикл.
+                value++;
+                for ( u_int i = 0; i < nodes_count; i++ )
+                    {
+                    mngr.get_node( i )->AO_[ 0 ] = value;
+                    }
+                errors += mngr.write_outputs();
+                }
+            }
+
+        for ( u_int i = 0; i < nodes_count; i++ )
+            {
+            mngr.disconnect( mngr.get_node( i ) );
+            }
+
+        state.counters.insert( { { "Nodes", nodes_count },
+            { "Errors", errors } } );
+        G_PAC_INFO()->par[ PAC_info::P_IO_PIPELINED_EXCHANGE ] = 0;
+        }
+
+    void io_args( benchmark::internal::Benchmark* b )
+        {
+        for ( auto profile : { P_NO_LATENCY, P_LATENCY, P_LOSS } )
+            {
+            for ( auto nodes_count : { 1, 10, 50, 100 } )
+                {
+                for ( auto is_pipelined : { 0, 1 } )
+                    {
+                    b->Args( { nodes_count, profile, is_pipelined } );
+                    }
+                }
+            }
+        b->ArgNames( { "nodes", "profile", "pipelined" } );
+        b->Unit( benchmark::kMicrosecond );
+        b->UseRealTime();
+        }
+    }
+
+BENCHMARK_CAPTURE( io_exchange, "Phoenix read_inputs",
+    io_manager::io_node::PHOENIX_BK_ETH, true )->Apply( io_args );
+BENCHMARK_CAPTURE( io_exchange, "Phoenix write_outputs",
+    io_manager::io_node::PHOENIX_BK_ETH, false )->Apply( io_args );
+BENCHMARK_CAPTURE( io_exchange, "WAGO read_inputs",
+    io_manager::io_node::WAGO_750_XXX_ETHERNET, true )->Apply( io_args );
+BENCHMARK_CAPTURE( io_exchange, "WAGO write_outputs",
+    io_manager::io_node::WAGO_750_XXX_ETHERNET, false )->Apply( io_args );
+
+BENCHMARK_MAIN();
@@ -1,8 +1,11 @@
 #include <benchmark/benchmark.h>
 #include <clocale>
+#include <algorithm>
+#include <vector>
 
 #include "g_device.h"
 #include "lua_manager.h"
+#include "PAC_info.h"
 #include "log.h"
 
 int G_DEBUG = 0;            // Вывод дополнительной отладочной информации.
@@ -11,7 +14,8 @@ bool G_READ_ONLY_IO_NODES = false;
 
 lua_State* L = nullptr;
 u_char in_data_devices[] = { device_communicator::CMD_GET_DEVICES };
-u_char out_data[ 5 * 1024 ] = { 0 };
+u_char in_data_states[] = { device_communicator::CMD_GET_DEVICES_STATES };
+u_char out_data[ tcp_communicator::BUFSIZE ] = { 0 };
 
 static void DoSetup( const benchmark::State& state )
     {
@@ -46,10 +50,72 @@ static void write_devices_service( benchmark::State& state, bool use_compression
     state.counters.insert( { {"Size", size} } );
     }
 
+static void write_states_service( benchmark::State& state, int level,
+    int strategy, bool use_dictionary )
+    {
+    device_communicator::switch_on_compression();
+    auto& par = G_PAC_INFO()->par;
+    par[ PAC_info::P_COMPRESSION_LEVEL ] = level;
+    par[ PAC_info::P_COMPRESSION_STRATEGY ] = strategy;
+    par[ PAC_info::P_COMPRESSION_DICTIONARY ] = use_dictionary;
+
+    auto size = G_DEVICE_CMMCTR->write_devices_states_service( 1,
+        in_data_states, out_data );
+
+    for ( auto _ : state )
+        G_DEVICE_CMMCTR->write_devices_states_service( 1,
+            in_data_states, out_data );
+
+    state.counters.insert( { {"Size", size} } );
+
+    par[ PAC_info::P_COMPRESSION_LEVEL ] = 0;
+    par[ PAC_info::P_COMPRESSION_STRATEGY ] = 0;
+    par[ PAC_info::P_COMPRESSION_DICTIONARY ] = 0;
+    }
+
+static void write_states_service_cached( benchmark::State& state )
+    {
+    device_communicator::switch_on_compression();
+    G_DEVICE_CMMCTR->start_answers_cache();
+
+    // Как и в tcp_communicator, ответ записывается в тот же буфер со
+    // смещением на байт назад относительно запроса.
+    auto request_states = []()
+        {
+        out_data[ 1 ] = device_communicator::CMD_GET_DEVICES_STATES;
+        return G_DEVICE_CMMCTR->write_devices_states_service( 1,
+            out_data + 1, out_data );
+        };
+
+    auto size = request_states();
+    std::vector< u_char > answer( out_data, out_data + size );
+    if ( request_states() != size ||
+        !std::equal( answer.begin(), answer.end(), out_data ) )
+        {
+        state.SkipWithError( "Cached answer differs from the first one" );
+        }
+
+    for ( auto _ : state )
+        request_states();
+
+    state.counters.insert( { {"Size", size} } );
+
+    G_DEVICE_CMMCTR->stop_answers_cache();
+    }
+
 // Register the function as a benchmark
 BENCHMARK_CAPTURE( write_devices_service, "no compression", false )->
     Setup( DoSetup )->Unit( benchmark::kMicrosecond );
 BENCHMARK_CAPTURE( write_devices_service, "with compression", true )->
     Setup( DoSetup )->Unit( benchmark::kMicrosecond );
 
+BENCHMARK_CAPTURE( write_states_service, "states, default compression",
+    0, Z_DEFAULT_STRATEGY, false )->Setup( DoSetup )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( write_states_service, "states, level 1, Z_RLE",
+    1, Z_RLE, false )->Setup( DoSetup )->Unit( benchmark::kMicrosecond );
+BENCHMARK_CAPTURE( write_states_service, "states, level 1, dictionary",
+    1, Z_DEFAULT_STRATEGY, true )->Setup( DoSetup )->Unit( benchmark::kMicrosecond );
+BENCHMARK( write_states_service_cached )->Setup( DoSetup )->
+    Unit( benchmark::kMicrosecond );
+
 BENCHMARK_MAIN();
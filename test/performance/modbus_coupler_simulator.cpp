@@ -0,0 +1,325 @@
+#include "modbus_coupler_simulator.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+    {
+    /// @brief Получение заданного количества байт.
+    ///
+    /// @return - true - данные получены, false - подключение закрыто.
+    bool recv_all( int sock, uint8_t* buff, int len )
+        {
+        int cnt = 0;
+        while ( cnt < len )
+            {
+            auto res = recv( sock, buff + cnt, len - cnt, 0 );
+            if ( res <= 0 )
+                {
+                return false;
+                }
+            cnt += static_cast<int>( res );
+            }
+
+        return true;
+        }
+
+    uint16_t get_u16( const uint8_t* buff )
+        {
+        return static_cast<uint16_t>( buff[ 0 ] << 8 | buff[ 1 ] );
+        }
+
+    void set_u16( uint8_t* buff, uint16_t value )
+        {
+        buff[ 0 ] = static_cast<uint8_t>( value >> 8 );
+        buff[ 1 ] = static_cast<uint8_t>( value & 0xFF );
+        }
+    }
+//-----------------------------------------------------------------------------
+modbus_coupler_simulator::modbus_coupler_simulator( const config& cfg ) :
+    cfg( cfg ), holding_registers( REGISTERS_COUNT ), coils( REGISTERS_COUNT )
+    {
+    }
+//-----------------------------------------------------------------------------
+modbus_coupler_simulator::~modbus_coupler_simulator()
+    {
+    stop();
+    }
+//-----------------------------------------------------------------------------
+bool modbus_coupler_simulator::start()
+    {
+    listen_sock = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if ( listen_sock < 0 )
+        {
+        return false;
+        }
+
+    int on = 1;
+    setsockopt( listen_sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof( on ) );
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( cfg.port );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if ( bind( listen_sock, reinterpret_cast<sockaddr*>( &addr ),
+        sizeof( addr ) ) != 0 || listen( listen_sock, SOMAXCONN ) != 0 )
+        {
+        close( listen_sock );
+        listen_sock = -1;
+        return false;
+        }
+
+    is_running = true;
+    accept_thread = std::thread( &modbus_coupler_simulator::accept_loop, this );
+    return true;
+    }
+//-----------------------------------------------------------------------------
+void modbus_coupler_simulator::stop()
+    {
+    if ( !is_running )
+        {
+        return;
+        }
+
+    is_running = false;
+    shutdown( listen_sock, SHUT_RDWR );
+    close( listen_sock );
+    listen_sock = -1;
+    if ( accept_thread.joinable() )
+        {
+        accept_thread.join();
+        }
+
+    std::vector< std::thread > tmp_threads;
+        {
+        std::lock_guard< std::mutex > lock( mtx );
+        for ( auto sock : socks )
+            {
+            shutdown( sock, SHUT_RDWR );
+            }
+        tmp_threads.swap( threads );
+        }
+    for ( auto& thr : tmp_threads )
+        {
+        thr.join();
+        }
+
+    std::lock_guard< std::mutex > lock( mtx );
+    for ( auto sock : socks )
+        {
+        close( sock );
+        }
+    socks.clear();
+    }
+//-----------------------------------------------------------------------------
+uint64_t modbus_coupler_simulator::get_requests_count() const
+    {
+    return requests_count;
+    }
+//-----------------------------------------------------------------------------
+void modbus_coupler_simulator::accept_loop()
+    {
+    while ( is_running )
+        {
+        auto sock = accept( listen_sock, nullptr, nullptr );
+        if ( sock < 0 )
+            {
+            continue;
+            }
+
+        int on = 1;
+        setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof( on ) );
+
+        std::lock_guard< std::mutex > lock( mtx );
+        if ( !is_running )
+            {
+            close( sock );
+            break;
+            }
+        socks.push_back( sock );
+        threads.emplace_back( &modbus_coupler_simulator::serve, this, sock );
+        }
+    }
+//-----------------------------------------------------------------------------
+void modbus_coupler_simulator::serve( int sock )
+    {
+    uint8_t req[ BUFF_SIZE ];
+    uint8_t ans[ BUFF_SIZE ];
+
+    while ( is_running )
+        {
+        // Заголовок Modbus TCP (MBAP): байты 4-5 - длина оставшейся части.
+        if ( !recv_all( sock, req, MBAP_SIZE - 1 ) )
+            {
+            break;
+            }
+        int len = get_u16( req + 4 );
+        if ( len < 2 || len + MBAP_SIZE - 1 > BUFF_SIZE ||
+            !recv_all( sock, req + MBAP_SIZE - 1, len ) )
+            {
+            break;
+            }
+        requests_count++;
+
+        if ( is_lost() )
+            {
+            continue;
+            }
+
+        auto ans_len = process_request( req, len + MBAP_SIZE - 1, ans );
+        if ( auto delay = get_delay_us(); delay )
+            {
+            std::this_thread::sleep_for( std::chrono::microseconds( delay ) );
+            }
+        if ( send( sock, ans, ans_len, MSG_NOSIGNAL ) != ans_len )
+            {
+            break;
+            }
+        }
+    }
+//-----------------------------------------------------------------------------
+int modbus_coupler_simulator::process_request( const uint8_t* req,
+    int req_len, uint8_t* ans )
+    {
+    std::lock_guard< std::mutex > lock( mtx );
+
+    memcpy( ans, req, MBAP_SIZE );
+    auto fun_code = req[ MBAP_SIZE ];
+    ans[ MBAP_SIZE ] = fun_code;
+    int pdu_len = 1;
+
+    // Входные регистры узлов Phoenix (с 8000) - значения выходных
+    // регистров (с 9000), узлов WAGO - значения выходных регистров с тем
+    // же адресом. Дискретные входы WAGO - значения дискретных выходов.
+    auto get_input_register = [ this ]( uint16_t address ) -> uint16_t
+        {
+        if ( PHOENIX_STATUS_REGISTER_ADDRESS == address )
+            {
+            return cfg.status_register;
+            }
+        if ( address >= 8000 && address < 9000 )
+            {
+            return holding_registers[ address + 1000 ];
+            }
+        return holding_registers[ address ];
+        };
+
+    auto address = get_u16( req + 8 );
+    auto quantity = get_u16( req + 10 );
+    auto is_valid = address + quantity <= REGISTERS_COUNT;
+
+    switch ( fun_code )
+        {
+        case 0x02:
+            if ( !is_valid || quantity > 2000 ) break;
+            ans[ 8 ] = static_cast<uint8_t>( ( quantity + 7 ) / 8 );
+            memset( ans + 9, 0, ans[ 8 ] );
+            for ( int i = 0; i < quantity; i++ )
+                {
+                ans[ 9 + i / 8 ] |= ( coils[ address + i ] & 1 ) << i % 8;
+                }
+            pdu_len = 2 + ans[ 8 ];
+            break;
+
+        case 0x04:
+            if ( !is_valid || quantity > 125 ) break;
+            ans[ 8 ] = static_cast<uint8_t>( quantity * 2 );
+            for ( int i = 0; i < quantity; i++ )
+                {
+                set_u16( ans + 9 + i * 2, get_input_register(
+                    static_cast<uint16_t>( address + i ) ) );
+                }
+            pdu_len = 2 + ans[ 8 ];
+            break;
+
+        case 0x0F:
+            if ( !is_valid || req_len < 13 + ( quantity + 7 ) / 8 ) break;
+            for ( int i = 0; i < quantity; i++ )
+                {
+                coils[ address + i ] = ( req[ 13 + i / 8 ] >> i % 8 ) & 1;
+                }
+            memcpy( ans + 8, req + 8, 4 );
+            pdu_len = 5;
+            break;
+
+        case 0x10:
+            if ( !is_valid || req_len < 13 + quantity * 2 ) break;
+            for ( int i = 0; i < quantity; i++ )
+                {
+                holding_registers[ address + i ] = get_u16( req + 13 + i * 2 );
+                }
+            memcpy( ans + 8, req + 8, 4 );
+            pdu_len = 5;
+            break;
+
+        case 0x17:
+            {
+            if ( !cfg.is_rw_registers || !is_valid || quantity > 125 ) break;
+            auto write_address = get_u16( req + 12 );
+            auto write_quantity = get_u16( req + 14 );
+            if ( write_address + write_quantity > REGISTERS_COUNT ||
+                req_len < 17 + write_quantity * 2 ) break;
+
+            for ( int i = 0; i < write_quantity; i++ )
+                {
+                holding_registers[ write_address + i ] =
+                    get_u16( req + 17 + i * 2 );
+                }
+            ans[ 8 ] = static_cast<uint8_t>( quantity * 2 );
+            for ( int i = 0; i < quantity; i++ )
+                {
+                set_u16( ans + 9 + i * 2, get_input_register(
+                    static_cast<uint16_t>( address + i ) ) );
+                }
+            pdu_len = 2 + ans[ 8 ];
+            break;
+            }
+
+        default:
+            break;
+        }
+
+    if ( 1 == pdu_len )
+        {
+        // Исключение - неподдерживаемая функция или неверный запрос.
+        ans[ MBAP_SIZE ] = fun_code | 0x80;
+        ans[ 8 ] = fun_code == 0x02 || fun_code == 0x04 || fun_code == 0x0F ||
+            fun_code == 0x10 || ( fun_code == 0x17 && cfg.is_rw_registers ) ?
+            0x03 : 0x01;
+        pdu_len = 2;
+        }
+
+    set_u16( ans + 4, static_cast<uint16_t>( pdu_len + 1 ) );
+    return MBAP_SIZE + pdu_len;
+    }
+//-----------------------------------------------------------------------------
+uint32_t modbus_coupler_simulator::get_delay_us()
+    {
+    if ( 0 == cfg.jitter_us )
+        {
+        return cfg.latency_us;
+        }
+
+    std::lock_guard< std::mutex > lock( mtx );
+    std::uniform_int_distribution< uint32_t > dist( 0, cfg.jitter_us );
+    return cfg.latency_us + dist( rnd );
+    }
+//-----------------------------------------------------------------------------
+bool modbus_coupler_simulator::is_lost()
+    {
+    if ( cfg.loss <= 0 )
+        {
+        return false;
+        }
+
+    std::lock_guard< std::mutex > lock( mtx );
+    std::uniform_real_distribution< double > dist( 0, 1 );
+    return dist( rnd ) < cfg.loss;
+    }
@@ -0,0 +1,107 @@
+/// @file modbus_coupler_simulator.h
+/// @brief Симулятор узлов I/O (WAGO 750-xxx, Phoenix BK ETH) - локальный
+/// сервер Modbus TCP для измерения производительности обмена без
+/// реального оборудования.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+/// @brief Симулятор узлов I/O.
+///
+/// Принимает подключения на 127.0.0.1:port, каждое подключение
+/// обслуживается отдельным потоком (как отдельный узел). Поддерживаются
+/// функции Modbus, используемые @ref uni_io_manager:
+/// 0x02 - чтение дискретных входов (WAGO), 0x04 - чтение входных
+/// регистров (WAGO, Phoenix, в том числе регистр статуса 7996),
+/// 0x0F - запись дискретных выходов (WAGO), 0x10 - запись регистров
+/// (WAGO, Phoenix), 0x17 - чтение/запись регистров (Phoenix). Остальные
+/// функции - ответ с исключением 0x01.
+///
+/// Входы повторяют записанные выходы: входные регистры Phoenix (с 8000) -
+/// выходные регистры (с 9000), входные регистры WAGO - выходные регистры
+/// с тем же адресом, дискретные входы WAGO - дискретные выходы. Все
+/// подключения работают с общими регистрами.
+///
+/// Задержка ответа, ее разброс и потеря запросов задаются
+/// конфигурацией (@ref config).
+class modbus_coupler_simulator
+    {
+    public:
+        struct config
+            {
+            uint16_t port = 10502;      ///< Порт сервера.
+            uint32_t latency_us = 0;    ///< Задержка ответа, мкс.
+            uint32_t jitter_us = 0;     ///< Максимальный разброс задержки, мкс.
+            double loss = 0;            ///< Доля потерянных запросов (0..1).
+            uint16_t status_register = 0;   ///< Значение регистра 7996.
+            bool is_rw_registers = true;    ///< Поддержка функции 0x17.
+            };
+
+        explicit modbus_coupler_simulator( const config& cfg );
+
+        ~modbus_coupler_simulator();
+
+        modbus_coupler_simulator( const modbus_coupler_simulator& ) = delete;
+        modbus_coupler_simulator& operator=(
+            const modbus_coupler_simulator& ) = delete;
+
+        /// @brief Запуск сервера.
+        ///
+        /// @return - true - сервер запущен.
+        bool start();
+
+        /// @brief Останов сервера, закрытие всех подключений.
+        void stop();
+
+        /// @brief Количество обработанных запросов.
+        uint64_t get_requests_count() const;
+
+        enum CONSTANTS
+            {
+            PHOENIX_STATUS_REGISTER_ADDRESS = 7996,
+            REGISTERS_COUNT = 65536,
+            BUFF_SIZE = 262,
+            MBAP_SIZE = 7,
+            };
+
+    private:
+        void accept_loop();
+        void serve( int sock );
+
+        /// @brief Формирование ответа на запрос.
+        ///
+        /// @param req     - запрос (кадр Modbus TCP).
+        /// @param req_len - размер запроса.
+        /// @param ans     - буфер ответа.
+        ///
+        /// @return - размер ответа.
+        int process_request( const uint8_t* req, int req_len, uint8_t* ans );
+
+        /// @brief Задержка ответа (с учетом разброса), мкс.
+        uint32_t get_delay_us();
+
+        /// @brief Признак потери запроса.
+        bool is_lost();
+
+        config cfg;
+
+        int listen_sock = -1;
+        std::atomic< bool > is_running{ false };
+        std::atomic< uint64_t > requests_count{ 0 };
+
+        std::thread accept_thread;
+        std::mutex mtx;     ///< Защищает данные ниже.
+        std::vector< std::thread > threads;
+        std::vector< int > socks;
+        std::mt19937 rnd{ 42 };
+
+        std::vector< uint16_t > holding_registers;
+        std::vector< uint8_t > coils;
+    };
@@ -206,6 +206,8 @@ Usage:
       --path arg         Path (default: .)
       --extra_paths arg  Extra paths (default: ./dairy-sys)
       --sleep_time arg   Sleep time, ms (default: 2)
+      --cpu_core arg     Main thread CPU core (default: -1)
+      --rt_priority arg  Main thread RT priority (default: 0)
 )";
 #else
         R"(Main control program
@@ -224,6 +226,8 @@ Usage:
       --path arg         Path (default: .)
       --extra_paths arg  Extra paths (default: ./dairy-sys)
       --sleep_time arg   Sleep time, ms (default: 2)
+      --cpu_core arg     Main thread CPU core (default: -1)
+      --rt_priority arg  Main thread RT priority (default: 0)
 )";
 #endif // defined WIN_OS
 
@@ -182,3 +182,65 @@ TEST( sys, get_fixed_time_consistency )
     EXPECT_EQ( time1.tm_sec, time2.tm_sec );
     }
 #endif  // PTUSA_TEST
+
+TEST( sys, get_microsec )
+    {
+    auto time1 = get_microsec();
+    std::this_thread::sleep_for( 1ms );
+    auto time2 = get_microsec();
+    EXPECT_GE( time2 - time1, 1000u );
+    }
+
+TEST( time_histogram, get_bucket )
+    {
+    EXPECT_EQ( 0u, time_histogram::get_bucket( 0 ) );
+    EXPECT_EQ( 3u, time_histogram::get_bucket( 3 ) );
+    EXPECT_EQ( 7u, time_histogram::get_bucket( 7 ) );
+    EXPECT_EQ( 8u, time_histogram::get_bucket( 8 ) );
+    EXPECT_EQ( 9u, time_histogram::get_bucket( 10 ) );
+    EXPECT_EQ( time_histogram::C_BUCKETS_CNT - 1,
+        time_histogram::get_bucket( UINT32_MAX ) );
+
+    // Интервалы идут подряд, без пропусков.
+    for ( u_int i = 0; i < time_histogram::C_BUCKETS_CNT - 1; i++ )
+        {
+        auto max = time_histogram::get_bucket_max( i );
+        EXPECT_EQ( i, time_histogram::get_bucket( max ) );
+        EXPECT_EQ( i + 1, time_histogram::get_bucket( max + 1 ) );
+        }
+    EXPECT_EQ( UINT32_MAX, time_histogram::get_bucket_max(
+        time_histogram::C_BUCKETS_CNT - 1 ) );
+    }
+
+TEST( time_histogram, get_percentile )
+    {
+    time_histogram hist;
+    EXPECT_EQ( 0u, hist.get_percentile( 50 ) );
+    EXPECT_EQ( 0u, hist.get_count() );
+    EXPECT_EQ( 0u, hist.get_avg() );
+
+    for ( uint32_t i = 1; i <= 100; i++ )
+        {
+        hist.add( i );
+        }
+    EXPECT_EQ( 100u, hist.get_count() );
+    EXPECT_EQ( 1u, hist.get_min() );
+    EXPECT_EQ( 100u, hist.get_max() );
+    EXPECT_EQ( 50u, hist.get_avg() );
+
+    // 50 - в интервале [48, 55], 99 - в интервале [96, 111].
+    EXPECT_EQ( 55u, hist.get_percentile( 50 ) );
+    EXPECT_EQ( 100u, hist.get_percentile( 99 ) );
+    EXPECT_EQ( 100u, hist.get_percentile( 100 ) );
+    EXPECT_EQ( 1u, hist.get_percentile( 0 ) );
+
+    hist.add( 1'000'000 );
+    EXPECT_EQ( 1'000'000u, hist.get_percentile( 100 ) );
+    // Верхняя граница интервала, максимум больше.
+    EXPECT_EQ( 111u, hist.get_percentile( 99 ) );
+
+    hist.clear();
+    EXPECT_EQ( 0u, hist.get_count() );
+    EXPECT_EQ( 0u, hist.get_max() );
+    EXPECT_EQ( 0u, hist.get_percentile( 99 ) );
+    }
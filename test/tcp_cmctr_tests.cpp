@@ -1,6 +1,12 @@
 #include "tcp_cmctr_tests.h"
 #include "PAC_info.h"
 
+#include <thread>
+
+#ifdef LINUX_OS
+#include <poll.h>
+#endif
+
 using namespace ::testing;
 
 #ifndef WIN_OS // For linux to deal with __stdcall.
@@ -88,6 +94,369 @@ TEST( tcp_communicator, evaluate )
     tcp_communicator::clear_instance();
     }
 
+#ifdef LINUX_OS
+namespace
+    {
+    std::thread::id service_thread_id;
+
+    long test_service( long, u_char* data, u_char* outdata )
+        {
+        service_thread_id = std::this_thread::get_id();
+        outdata[ 0 ] = data[ 0 ] + 1;
+        return 1;
+        }
+
+    /// @brief Проверка наличия данных для чтения из сокета.
+    ///
+    /// @param timeout_ms - время ожидания данных, мс.
+    bool is_readable( int s, int timeout_ms = 0 )
+        {
+        pollfd pfd{ s, POLLIN, 0 };
+        return poll( &pfd, 1, timeout_ms ) > 0;
+        }
+
+    /// @brief Вызов evaluate() до выполнения условия (время ограничено,
+    /// чтобы не зависеть от загрузки машины).
+    template < class F > bool evaluate_until( F is_done,
+        uint32_t timeout_ms = 5000 )
+        {
+        auto start_time = get_millisec();
+        while ( !is_done() )
+            {
+            if ( get_delta_millisec( start_time ) > timeout_ms ) return false;
+            G_CMMCTR->evaluate();
+            sleep_ms( 1 );
+            }
+        return true;
+        }
+
+    /// @brief Все сокеты имеют данные для чтения.
+    template < size_t N > bool are_readable( const int ( &sockets )[ N ] )
+        {
+        for ( auto s : sockets )
+            {
+            if ( !is_readable( s ) ) return false;
+            }
+        return true;
+        }
+    }
+
+TEST( tcp_communicator, evaluate_comm_thread )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_COMM_THREAD ] = 1;
+    tcp_communicator::init_instance( "Тест", "Test" );
+    const u_char SERVICE_N = 2;
+    G_CMMCTR->reg_service( SERVICE_N, test_service );
+    EXPECT_EQ( 0, G_CMMCTR->evaluate() );
+
+    auto s = socket( AF_INET, SOCK_STREAM, 0 );
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( tcp_communicator::get_port() );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    ASSERT_EQ( 0, connect( s, reinterpret_cast<sockaddr*>( &addr ),
+        sizeof( addr ) ) );
+
+    // Подключение обрабатывается потоком обмена без вызова evaluate().
+    timeval tv{ 1, 0 };
+    setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+    char accept_msg[ 20 ] = { 0 };
+    ASSERT_EQ( 10, recv( s, accept_msg, 10, 0 ) );
+    EXPECT_STREQ( "PAC accept", accept_msg );
+
+    // Запрос: 's', номер сервиса, FRAME_SINGLE, номер пакета, длина данных,
+    // данные.
+    u_char request[] = { 's', SERVICE_N, 1, 5, 0, 1, 41 };
+    ASSERT_EQ( static_cast<ssize_t>( sizeof( request ) ),
+        send( s, request, sizeof( request ), 0 ) );
+
+    // Сервис выполняется управляющим потоком при вызове evaluate().
+    u_char answer[ 10 ] = { 0 };
+    ssize_t size = 0;
+    for ( int i = 0; i < 1000 && size <= 0; i++ )
+        {
+        G_CMMCTR->evaluate();
+        sleep_ms( 1 );
+        size = recv( s, answer, sizeof( answer ), MSG_DONTWAIT );
+        }
+    ASSERT_EQ( 6, size );
+    EXPECT_EQ( 5, answer[ 2 ] );
+    EXPECT_EQ( 1, answer[ 4 ] );
+    EXPECT_EQ( 42, answer[ 5 ] );
+    EXPECT_EQ( std::this_thread::get_id(), service_thread_id );
+
+    close( s );
+    tcp_communicator::clear_instance();
+    G_PAC_INFO()->par[ PAC_info::P_COMM_THREAD ] = 0;
+    }
+
+TEST( tcp_communicator, evaluate_comm_thread_many_clients )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_COMM_THREAD ] = 1;
+    tcp_communicator::init_instance( "Тест", "Test" );
+    auto cmctr = dynamic_cast<tcp_communicator_linux*>( G_CMMCTR );
+    ASSERT_NE( nullptr, cmctr );
+    const u_char SERVICE_N = 2;
+    cmctr->reg_service( SERVICE_N, test_service );
+    EXPECT_EQ( 0, cmctr->evaluate() );
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( tcp_communicator::get_port() );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    const int CLIENTS_CNT = 10;
+    int sockets[ CLIENTS_CNT ];
+    for ( auto& s : sockets )
+        {
+        s = socket( AF_INET, SOCK_STREAM, 0 );
+        ASSERT_EQ( 0, connect( s, reinterpret_cast<sockaddr*>( &addr ),
+            sizeof( addr ) ) );
+        timeval tv{ 5, 0 };
+        setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+        }
+    for ( auto s : sockets )
+        {
+        char accept_msg[ 20 ] = { 0 };
+        ASSERT_EQ( 10, recv( s, accept_msg, 10, 0 ) );
+        }
+
+    for ( int i = 0; i < CLIENTS_CNT; i++ )
+        {
+        u_char request[] = { 's', SERVICE_N, 1, 5, 0, 1,
+            static_cast<u_char>( i ) };
+        ASSERT_EQ( static_cast<ssize_t>( sizeof( request ) ),
+            send( sockets[ i ], request, sizeof( request ), 0 ) );
+        }
+
+    // Поток обмена принимает запросы всех клиентов, не ожидая их
+    // выполнения.
+    auto start_time = get_millisec();
+    while ( cmctr->get_service_requests_count() < CLIENTS_CNT &&
+        get_delta_millisec( start_time ) < 5000 )
+        {
+        sleep_ms( 1 );
+        }
+    ASSERT_EQ( static_cast<size_t>( CLIENTS_CNT ),
+        cmctr->get_service_requests_count() );
+
+    // Все запросы выполняются за один цикл управляющей программы.
+    service_thread_id = std::thread::id();
+    cmctr->evaluate();
+    EXPECT_EQ( 0u, cmctr->get_service_requests_count() );
+    EXPECT_EQ( std::this_thread::get_id(), service_thread_id );
+    for ( int i = 0; i < CLIENTS_CNT; i++ )
+        {
+        u_char answer[ 10 ] = { 0 };
+        ASSERT_EQ( 6, recv( sockets[ i ], answer, sizeof( answer ), 0 ) );
+        EXPECT_EQ( 5, answer[ 2 ] );
+        EXPECT_EQ( i + 1, answer[ 5 ] );
+        }
+
+    for ( auto s : sockets )
+        {
+        close( s );
+        }
+    tcp_communicator::clear_instance();
+    G_PAC_INFO()->par[ PAC_info::P_COMM_THREAD ] = 0;
+    }
+
+TEST( tcp_communicator, evaluate_many_connections )
+    {
+    tcp_communicator::init_instance( "Тест", "Test" );
+    const u_char SERVICE_N = 2;
+    G_CMMCTR->reg_service( SERVICE_N, test_service );
+    EXPECT_EQ( 0, G_CMMCTR->evaluate() );
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( tcp_communicator::get_port() );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    const int CONNECTIONS_CNT = 20;
+    int sockets[ CONNECTIONS_CNT ];
+    for ( auto& s : sockets )
+        {
+        s = socket( AF_INET, SOCK_STREAM, 0 );
+        ASSERT_EQ( 0, connect( s, reinterpret_cast<sockaddr*>( &addr ),
+            sizeof( addr ) ) );
+        timeval tv{ 1, 0 };
+        setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+        }
+
+    // Все ожидающие подключения принимаются.
+    ASSERT_TRUE( evaluate_until( [ & ] { return are_readable( sockets ); } ) );
+    for ( auto s : sockets )
+        {
+        char accept_msg[ 20 ] = { 0 };
+        ASSERT_EQ( 10, recv( s, accept_msg, 10, 0 ) );
+        EXPECT_STREQ( "PAC accept", accept_msg );
+        }
+
+    // Запросы всех соединений обрабатываются.
+    for ( int i = 0; i < CONNECTIONS_CNT; i++ )
+        {
+        u_char request[] = { 's', SERVICE_N, 1, 5, 0, 1,
+            static_cast<u_char>( i ) };
+        ASSERT_EQ( static_cast<ssize_t>( sizeof( request ) ),
+            send( sockets[ i ], request, sizeof( request ), 0 ) );
+        }
+    ASSERT_TRUE( evaluate_until( [ & ] { return are_readable( sockets ); } ) );
+    for ( int i = 0; i < CONNECTIONS_CNT; i++ )
+        {
+        u_char answer[ 10 ] = { 0 };
+        ASSERT_EQ( 6, recv( sockets[ i ], answer, sizeof( answer ),
+            MSG_DONTWAIT ) );
+        EXPECT_EQ( i + 1, answer[ 5 ] );
+        }
+
+    for ( auto s : sockets )
+        {
+        close( s );
+        }
+    EXPECT_EQ( 0, G_CMMCTR->evaluate() );
+    tcp_communicator::clear_instance();
+    }
+
+TEST( tcp_communicator, evaluate_partial_frames )
+    {
+    tcp_communicator::init_instance( "Тест", "Test" );
+    const u_char SERVICE_N = 2;
+    G_CMMCTR->reg_service( SERVICE_N, test_service );
+    EXPECT_EQ( 0, G_CMMCTR->evaluate() );
+
+    auto s = socket( AF_INET, SOCK_STREAM, 0 );
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( tcp_communicator::get_port() );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    ASSERT_EQ( 0, connect( s, reinterpret_cast<sockaddr*>( &addr ),
+        sizeof( addr ) ) );
+    timeval tv{ 1, 0 };
+    setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+    ASSERT_TRUE( evaluate_until( [ & ] { return is_readable( s ); } ) );
+    char accept_msg[ 20 ] = { 0 };
+    ASSERT_EQ( 10, recv( s, accept_msg, 10, 0 ) );
+
+    // Кадр, переданный частями, обрабатывается после приема полностью.
+    u_char request[] = { 's', SERVICE_N, 1, 5, 0, 1, 41 };
+    ASSERT_EQ( 4, send( s, request, 4, 0 ) );
+    for ( int i = 0; i < 10; i++ )
+        {
+        G_CMMCTR->evaluate();
+        sleep_ms( 1 );
+        }
+    u_char answer[ 20 ] = { 0 };
+    EXPECT_EQ( -1, recv( s, answer, sizeof( answer ), MSG_DONTWAIT ) );
+
+    ASSERT_EQ( 3, send( s, request + 4, 3, 0 ) );
+    ASSERT_TRUE( evaluate_until( [ & ] { return is_readable( s ); } ) );
+    ASSERT_EQ( 6, recv( s, answer, sizeof( answer ), 0 ) );
+    EXPECT_EQ( 42, answer[ 5 ] );
+
+    // Два кадра в одной передаче - по одному за вызов evaluate().
+    u_char requests[] = { 's', SERVICE_N, 1, 6, 0, 1, 10,
+        's', SERVICE_N, 1, 7, 0, 1, 20 };
+    ASSERT_EQ( static_cast<ssize_t>( sizeof( requests ) ),
+        send( s, requests, sizeof( requests ), 0 ) );
+    ASSERT_TRUE( evaluate_until( [ & ] { return is_readable( s ); } ) );
+    ASSERT_EQ( 6, recv( s, answer, sizeof( answer ), 0 ) );
+    EXPECT_EQ( 6, answer[ 2 ] );
+    EXPECT_EQ( 11, answer[ 5 ] );
+    G_CMMCTR->evaluate();
+    ASSERT_EQ( 6, recv( s, answer, sizeof( answer ), 0 ) );
+    EXPECT_EQ( 7, answer[ 2 ] );
+    EXPECT_EQ( 21, answer[ 5 ] );
+
+    close( s );
+    G_CMMCTR->evaluate();
+    tcp_communicator::clear_instance();
+    }
+
+namespace
+    {
+    const long BIG_ANSWER_SIZE = 400000;
+
+    long big_answer_service( long, u_char* data, u_char* outdata )
+        {
+        memset( outdata, data[ 0 ], BIG_ANSWER_SIZE );
+        return BIG_ANSWER_SIZE;
+        }
+    }
+
+TEST( tcp_communicator, evaluate_slow_client )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_TCP_SLOW_CLIENT_TIMEOUT ] = 1000;
+    tcp_communicator::init_instance( "Тест", "Test" );
+    auto cmctr = dynamic_cast<tcp_communicator_linux*>( G_CMMCTR );
+    ASSERT_NE( nullptr, cmctr );
+    const u_char SERVICE_N = 2;
+    const u_char BIG_SERVICE_N = 3;
+    cmctr->reg_service( SERVICE_N, test_service );
+    cmctr->reg_service( BIG_SERVICE_N, big_answer_service );
+    EXPECT_EQ( 0, cmctr->evaluate() );
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( tcp_communicator::get_port() );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    int sockets[ 2 ];
+    for ( auto& s : sockets )
+        {
+        s = socket( AF_INET, SOCK_STREAM, 0 );
+        int rcv_buff_size = 4096;
+        setsockopt( s, SOL_SOCKET, SO_RCVBUF, &rcv_buff_size,
+            sizeof( rcv_buff_size ) );
+        ASSERT_EQ( 0, connect( s, reinterpret_cast<sockaddr*>( &addr ),
+            sizeof( addr ) ) );
+        timeval tv{ 1, 0 };
+        setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+        }
+    ASSERT_TRUE( evaluate_until( [ & ] { return are_readable( sockets ); } ) );
+    for ( auto s : sockets )
+        {
+        char accept_msg[ 20 ] = { 0 };
+        ASSERT_EQ( 10, recv( s, accept_msg, 10, 0 ) );
+        }
+
+    // Первый клиент не читает большие ответы - после заполнения буфера
+    // сокета ответ остается в очереди, обмен не блокируется (иначе
+    // evaluate() не вернет управление).
+    u_char big_request[] = { 's', BIG_SERVICE_N, 1, 5, 0, 1, 7 };
+    for ( int i = 0; i < 30 && 0 == cmctr->get_max_out_queue_size(); i++ )
+        {
+        ASSERT_EQ( static_cast<ssize_t>( sizeof( big_request ) ),
+            send( sockets[ 0 ], big_request, sizeof( big_request ), 0 ) );
+        evaluate_until( [ & ] { return cmctr->get_max_out_queue_size() > 0; },
+            50 );
+        }
+    EXPECT_GT( cmctr->get_max_out_queue_size(), 0u );
+
+    // Второй клиент обслуживается.
+    u_char request[] = { 's', SERVICE_N, 1, 5, 0, 1, 41 };
+    ASSERT_EQ( static_cast<ssize_t>( sizeof( request ) ),
+        send( sockets[ 1 ], request, sizeof( request ), 0 ) );
+    ASSERT_TRUE( evaluate_until(
+        [ & ] { return is_readable( sockets[ 1 ] ); } ) );
+    u_char answer[ 10 ] = { 0 };
+    ASSERT_EQ( 6, recv( sockets[ 1 ], answer, sizeof( answer ),
+        MSG_DONTWAIT ) );
+    EXPECT_EQ( 42, answer[ 5 ] );
+    EXPECT_EQ( 0u, cmctr->get_slow_clients_count() );
+
+    // Медленный клиент отключается по таймауту.
+    EXPECT_TRUE( evaluate_until(
+        [ & ] { return cmctr->get_slow_clients_count() > 0; } ) );
+    EXPECT_EQ( 1u, cmctr->get_slow_clients_count() );
+
+    for ( auto s : sockets )
+        {
+        close( s );
+        }
+    cmctr->evaluate();
+    tcp_communicator::clear_instance();
+    G_PAC_INFO()->par[ PAC_info::P_TCP_SLOW_CLIENT_TIMEOUT ] = 10000;
+    }
+#endif // LINUX_OS
+
 TEST( tcp_communicator, checkBuff )
     {
     int s = socket( AF_INET, SOCK_STREAM, 0 );
@@ -7,6 +7,7 @@
 
 #ifdef LINUX_OS
 #include "l_tcp_client.h"
+#include "l_tcp_cmctr.h"
 #else
 #include "w_tcp_client.h"
 #endif
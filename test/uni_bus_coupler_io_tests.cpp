@@ -143,6 +143,56 @@ TEST( uni_io_manager, net_init )
     subhook_free( getsockopt_0_hook );
     }
 
+TEST( uni_io_manager, async_connect )
+    {
+    uni_io_manager mngr;
+    mngr.init( 1 );
+    mngr.add_node( 0, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        1, "127.0.0.1", "A100", 1, 1, 1, 1, 1, 1 );
+    auto node = mngr.get_node( 0 );
+    io_manager::io_node* nodes[] = { node };
+
+    // Ошибка начала подключения - увеличивается время до повторного
+    // подключения.
+    subhook_t socket_hook = subhook_new( reinterpret_cast<void*>( socket ),
+        reinterpret_cast<void*>( fail_socket ), SUBHOOK_64BIT_OFFSET );
+    subhook_install( socket_hook );
+    mngr.start_connections( nodes, 1 );
+    subhook_remove( socket_hook );
+    subhook_free( socket_hook );
+    EXPECT_EQ( node->state, io_manager::io_node::ST_NO_CONNECT );
+    EXPECT_EQ( node->delay_time,
+        2u * io_manager::io_node::C_INITIAL_RECONNECT_DELAY );
+
+    // Не истекло время до повторного подключения.
+    mngr.start_connections( nodes, 1 );
+    EXPECT_EQ( node->state, io_manager::io_node::ST_NO_CONNECT );
+
+    // Подключение начато, но еще не завершено.
+    node->last_init_time = 0;
+    node->delay_time = 0;
+    mngr.start_connections( nodes, 1 );
+    EXPECT_EQ( node->state, io_manager::io_node::ST_CONNECTING );
+    EXPECT_NE( node->sock, 0 );
+
+    subhook_t select_0_hook = subhook_new( reinterpret_cast<void*>( select ),
+        reinterpret_cast<void*>( fail_select_0 ), SUBHOOK_64BIT_OFFSET );
+    subhook_install( select_0_hook );
+    EXPECT_EQ( mngr.net_init_check( node, false ),
+        uni_io_manager::C_CONNECT_IN_PROGRESS );
+    EXPECT_EQ( node->state, io_manager::io_node::ST_CONNECTING );
+
+    // Истекло время подключения.
+    DeltaMilliSecSubHooker::set_millisec(
+        io_manager::io_node::C_CNT_TIMEOUT_US / 1000 );
+    EXPECT_EQ( mngr.net_init_check( node, false ), 6 );
+    DeltaMilliSecSubHooker::set_default_time();
+    subhook_remove( select_0_hook );
+    subhook_free( select_0_hook );
+    EXPECT_EQ( node->state, io_manager::io_node::ST_NO_CONNECT );
+    EXPECT_EQ( node->sock, 0 );
+    }
+
 class test_uni_io_manager : public uni_io_manager
     {
     public:
@@ -355,6 +405,199 @@ TEST( uni_io_manager, read_write_data )
     io_manager::replace_instance( prev_mngr );
     }
 
+TEST( uni_io_manager, get_queries_count )
+    {
+    EXPECT_EQ( uni_io_manager::get_queries_count( 0 ), 0u );
+    EXPECT_EQ( uni_io_manager::get_queries_count( 1 ), 1u );
+    EXPECT_EQ( uni_io_manager::get_queries_count(
+        uni_io_manager::MAX_MODBUS_REGISTERS_PER_QUERY ), 1u );
+    EXPECT_EQ( uni_io_manager::get_queries_count(
+        uni_io_manager::MAX_MODBUS_REGISTERS_PER_QUERY + 1 ), 2u );
+    }
+
+TEST( uni_io_manager, is_answer_complete )
+    {
+    uni_io_manager::pipeline_state st;
+
+    // Нет заголовка.
+    st.rcv_count = 5;
+    EXPECT_FALSE( uni_io_manager::is_answer_complete( st ) );
+
+    // Длина оставшейся части - 5 байт (адрес, функция, размер, 2 байта).
+    st.rcv_buff[ 4 ] = 0;
+    st.rcv_buff[ 5 ] = 5;
+    st.rcv_count = 10;
+    EXPECT_FALSE( uni_io_manager::is_answer_complete( st ) );
+    st.rcv_count = 11;
+    EXPECT_TRUE( uni_io_manager::is_answer_complete( st ) );
+
+    // Некорректная длина - ограничение размером буфера.
+    st.rcv_buff[ 4 ] = 0xFF;
+    st.rcv_count = uni_io_manager::BUFF_SIZE - 1;
+    EXPECT_FALSE( uni_io_manager::is_answer_complete( st ) );
+    st.rcv_count = uni_io_manager::BUFF_SIZE;
+    EXPECT_TRUE( uni_io_manager::is_answer_complete( st ) );
+    }
+
+TEST( uni_io_manager, pipelined_exchange )
+    {
+    uni_io_manager mngr;
+    io_manager* prev_mngr = io_manager::replace_instance( &mngr );
+    G_PAC_INFO()->par[ PAC_info::P_IO_PIPELINED_EXCHANGE ] = 1;
+
+    mngr.init( 2 );
+    mngr.add_node( 0, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        1, "127.0.0.1", "A100", 1, 1, 1, 1, 1, 1 );
+    mngr.add_node( 1, io_manager::io_node::TYPES::WAGO_750_XXX_ETHERNET,
+        2, "127.0.0.1", "A200", 1, 1, 1, 1, 1, 1 );
+    mngr.get_node( 1 )->is_active = false;
+
+    // Неактивные узлы не опрашиваются.
+    mngr.get_node( 0 )->is_active = false;
+    EXPECT_EQ( mngr.read_inputs(), 0 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+
+    // Не истекло время до повторного подключения - ошибка чтения без
+    // попытки обмена, запись выходов не выполняется.
+    auto nd = mngr.get_node( 0 );
+    nd->is_active = true;
+    nd->state = io_manager::io_node::ST_NO_CONNECT;
+    nd->last_poll_time = get_millisec();
+    nd->last_init_time = get_millisec();
+    nd->delay_time = io_manager::io_node::C_MAX_DELAY;
+    EXPECT_EQ( mngr.read_inputs(), 1 );
+    EXPECT_TRUE( nd->read_io_error_flag );
+    EXPECT_EQ( mngr.write_outputs(), 1 );
+    EXPECT_FALSE( mngr.pipeline[ 0 ].is_waiting );
+
+    G_PAC_INFO()->par[ PAC_info::P_IO_PIPELINED_EXCHANGE ] = 0;
+    io_manager::replace_instance( prev_mngr );
+    }
+
+TEST( uni_io_manager, clone_node )
+    {
+    uni_io_manager mngr;
+    mngr.init( 1 );
+    mngr.add_node( 0, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        1, "127.0.0.1", "A100", 16, 16, 2, 4, 2, 4 );
+    mngr.init_node_AO( 0, 1, 2688527, 1 );
+    mngr.init_node_AI( 0, 1, 1027843, 1 );
+    auto nd = mngr.get_node( 0 );
+    nd->state = io_manager::io_node::ST_OK;
+    nd->DO_[ 3 ] = 1;
+    nd->AO_[ 1 ] = 100;
+    nd->DI[ 2 ] = 1;
+    nd->AI[ 1 ] = 200;
+
+    auto copy = uni_io_manager::clone_node( nd );
+    EXPECT_EQ( copy->state, io_manager::io_node::ST_NO_CONNECT );
+    EXPECT_EQ( copy->AO_types[ 1 ], 2688527u );
+    EXPECT_EQ( copy->AI_types[ 1 ], 1027843u );
+    EXPECT_EQ( copy->DO_[ 3 ], 1 );
+    EXPECT_EQ( copy->AO_[ 1 ], 100 );
+    EXPECT_EQ( copy->DI[ 2 ], 1 );
+    EXPECT_EQ( copy->AI[ 1 ], 200 );
+
+    // Выходы из управляющего потока, входы и состояние - из потока обмена.
+    nd->AO_[ 1 ] = 101;
+    nd->is_active = false;
+    uni_io_manager::copy_outputs( nd, copy );
+    EXPECT_EQ( copy->AO_[ 1 ], 101 );
+    EXPECT_FALSE( copy->is_active );
+
+    copy->AI[ 1 ] = 201;
+    copy->read_io_error_flag = true;
+    uni_io_manager::copy_inputs( copy, nd );
+    EXPECT_EQ( nd->AI[ 1 ], 201 );
+    EXPECT_TRUE( nd->read_io_error_flag );
+    EXPECT_EQ( nd->state, io_manager::io_node::ST_NO_CONNECT );
+
+    // Статистика собирается потоком обмена, сброс запрашивается
+    // управляющим потоком.
+    copy->recv_hist.add( 100 );
+    uni_io_manager::copy_inputs( copy, nd );
+    EXPECT_EQ( nd->recv_hist.get_max(), 100u );
+    nd->reset_stat();
+    uni_io_manager::copy_outputs( nd, copy );
+    copy->check_stat_reset();
+    uni_io_manager::copy_inputs( copy, nd );
+    EXPECT_EQ( nd->recv_hist.get_count(), 0u );
+    EXPECT_EQ( nd->stat_reset_done, nd->stat_reset_request );
+
+    delete copy;
+    }
+
+TEST( uni_io_manager, poll_period )
+    {
+    uni_io_manager mngr;
+    mngr.init( 3 );
+    mngr.add_node( 0, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        1, "127.0.0.1", "A100", 1, 1, 1, 1, 1, 1 );
+    mngr.add_node( 1, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        2, "127.0.0.1", "A200", 1, 1, 1, 1, 1, 1, 2 );
+    mngr.add_node( 2, io_manager::io_node::TYPES::PHOENIX_BK_ETH,
+        3, "127.0.0.1", "A300", 1, 1, 1, 1, 1, 1, 2 );
+
+    auto nd1 = mngr.get_node( 0 );
+    auto nd2 = mngr.get_node( 1 );
+    auto nd3 = mngr.get_node( 2 );
+    EXPECT_EQ( nd1->poll_period, 1u );
+    EXPECT_EQ( nd2->poll_period, 2u );
+    EXPECT_EQ( nd2->poll_phase, 0u );
+    // Узлы с одинаковым периодом опрашиваются в разных циклах.
+    EXPECT_EQ( nd3->poll_phase, 1u );
+
+    mngr.poll_cycle = 0;
+    EXPECT_TRUE( mngr.check_poll_time( nd1 ) );
+    EXPECT_TRUE( mngr.check_poll_time( nd2 ) );
+    EXPECT_FALSE( mngr.check_poll_time( nd3 ) );
+    mngr.poll_cycle = 1;
+    EXPECT_TRUE( mngr.check_poll_time( nd1 ) );
+    EXPECT_FALSE( mngr.check_poll_time( nd2 ) );
+    EXPECT_TRUE( mngr.check_poll_time( nd3 ) );
+
+    // Интервал между циклами опроса учитывается при контроле связи.
+    DeltaMilliSecSubHooker::set_millisec( 1000UL );
+    mngr.poll_cycle = 2;
+    EXPECT_TRUE( mngr.check_poll_time( nd2 ) );
+    EXPECT_EQ( nd2->poll_interval, 1000u );
+    EXPECT_EQ( nd1->poll_interval, 0u );
+    DeltaMilliSecSubHooker::set_default_time();
+
+    // Нулевой период соответствует опросу каждый цикл.
+    mngr.set_node_poll_period( 2, 0 );
+    EXPECT_EQ( nd3->poll_period, 1u );
+    mngr.set_node_poll_period( 10, 5 );
+    }
+
+TEST( uni_io_manager, io_thread )
+    {
+    uni_io_manager mngr;
+    G_PAC_INFO()->par[ PAC_info::P_IO_THREAD ] = 1;
+
+    mngr.init( 1 );
+    mngr.add_node( 0, io_manager::io_node::TYPES::WAGO_750_XXX_ETHERNET,
+        1, "127.0.0.1", "A100", 1, 1, 1, 1, 1, 1 );
+    auto nd = mngr.get_node( 0 );
+    nd->is_active = false;
+
+    EXPECT_EQ( mngr.read_inputs(), 0 );
+    EXPECT_TRUE( mngr.io_thread.joinable() );
+    ASSERT_EQ( mngr.shared_nodes.size(), 1u );
+
+    nd->DO_[ 0 ] = 1;
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+        {
+        std::lock_guard<std::mutex> lock( mngr.io_mutex );
+        EXPECT_EQ( mngr.shared_nodes[ 0 ]->DO_[ 0 ], 1 );
+        }
+
+    G_PAC_INFO()->par[ PAC_info::P_IO_THREAD ] = 0;
+    EXPECT_EQ( mngr.read_inputs(), 0 );
+    EXPECT_FALSE( mngr.io_thread.joinable() );
+    EXPECT_TRUE( mngr.shared_nodes.empty() );
+    }
+
 TEST( uni_io_manager, e_communicate )
     {
     uni_io_manager mngr;
@@ -456,6 +699,141 @@ TEST_F( UniBusCouplerIoTest, write_outputs_PHOENIX_BK_ETH )
     EXPECT_EQ( output, "" ); //Здесь уже не должно быть сообщения.
     }
 
+TEST_F( UniBusCouplerIoTest, write_outputs_only_changed )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_IO_OUTPUTS_REFRESH_TIME ] = 1'000;
+    ON_CALL( mngr, e_communicate( _, _, _ ) ).WillByDefault(
+        [this]( const io_manager::io_node*, int, int )
+        {
+        mngr.buff[ 7 ] = 0x10;
+        return 0;
+        } );
+
+    // Первая запись - всех выходов.
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    // Выходы не изменились - записи нет.
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 0 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    // Изменился аналоговый выход.
+    node->AO_[ 2 ] = 10;
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+    EXPECT_EQ( node->AO[ 2 ], 10 );
+
+    // Изменился дискретный выход.
+    node->DO_[ 5 ] = 1;
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+    EXPECT_EQ( node->DO[ 5 ], 1 );
+
+    // После переподключения записываются все выходы.
+    mngr.disconnect( node );
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    // Периодическая запись всех выходов.
+    DeltaMilliSecSubHooker::set_millisec( 1'000 );
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+    DeltaMilliSecSubHooker::set_default_time();
+
+    G_PAC_INFO()->par[ PAC_info::P_IO_OUTPUTS_REFRESH_TIME ] = 0;
+    }
+
+TEST_F( UniBusCouplerIoTest, combined_exchange )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_IO_COMBINED_EXCHANGE ] = 1;
+    ON_CALL( mngr, e_communicate( _, _, _ ) ).WillByDefault(
+        [this]( const io_manager::io_node*, int bytes_to_send,
+            int bytes_to_receive )
+        {
+        // Запись 6 выходных регистров, чтение регистра статуса,
+        // 3 промежуточных и 1 входного регистра.
+        EXPECT_EQ( mngr.buff[ 7 ], 0x17 );
+        EXPECT_EQ( bytes_to_send, 6 * 2 + 17 );
+        EXPECT_EQ( bytes_to_receive, 5 * 2 + 9 );
+
+        mngr.buff[ 8 ] = 5 * 2;
+        std::fill( mngr.buff + 9, mngr.buff + 17, 0 );
+        mngr.buff[ 17 ] = 0x01;
+        mngr.buff[ 18 ] = 0x02;
+        return 0;
+        } );
+
+    // Входы читаются вместе с записью выходов.
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 0 );
+    EXPECT_EQ( mngr.read_inputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    node->AO_[ 2 ] = 10;
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 0 );
+    Mock::VerifyAndClearExpectations( &mngr );
+    EXPECT_EQ( node->AO[ 2 ], 10 );
+    EXPECT_EQ( node->AI[ 0 ], 0x0102 );
+    EXPECT_EQ( node->DI[ 0 ], 1 );
+    EXPECT_EQ( node->DI[ 9 ], 1 );
+    EXPECT_FALSE( node->read_io_error_flag );
+
+    // Узел не поддерживает функцию 0x17 - переход на отдельные транзакции.
+    node->AO_[ 2 ] = 11;
+    ON_CALL( mngr, e_communicate( _, _, _ ) ).WillByDefault(
+        [this]( const io_manager::io_node*, int, int )
+        {
+        mngr.buff[ 7 ] = 0x80 | 0x17;
+        return 0;
+        } );
+    EXPECT_EQ( mngr.write_outputs(), 1 );
+    EXPECT_TRUE( node->is_rw_registers_unsupported );
+    EXPECT_FALSE( uni_io_manager::is_combined_exchange( node ) );
+    EXPECT_EQ( node->AO[ 2 ], 10 );
+
+    // Чтение входов и регистра статуса.
+    EXPECT_CALL( mngr, e_communicate( _, _, _ ) ).Times( 2 );
+    mngr.read_inputs();
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    G_PAC_INFO()->par[ PAC_info::P_IO_COMBINED_EXCHANGE ] = 0;
+    }
+
+TEST_F( UniBusCouplerIoTest, combined_exchange_write_error )
+    {
+    G_PAC_INFO()->par[ PAC_info::P_IO_COMBINED_EXCHANGE ] = 1;
+    // Опрос входов в этом цикле не выполняется - только запись выходов.
+    node->poll_period = 2;
+    node->poll_phase = ( mngr.poll_cycle + 1 ) % 2;
+    ON_CALL( mngr, e_communicate( _, _, _ ) ).WillByDefault(
+        [this]( const io_manager::io_node*, int, int )
+        {
+        EXPECT_EQ( mngr.buff[ 7 ], 0x10 );
+        mngr.buff[ 7 ] = 0x80 | 0x10;
+        mngr.buff[ 8 ] = 2;
+        return 0;
+        } );
+
+    // Ошибка записи выводится один раз, флаги чтения не изменяются.
+    EXPECT_CALL( mngr, add_err_to_log( ::testing::StrEq( "Write AO" ),
+        _, _, 0x80 | 0x10, 0x10, 2, 6 ) ).Times( 1 );
+    EXPECT_EQ( mngr.write_outputs(), 1 );
+    EXPECT_TRUE( node->flag_error_write_message );
+    EXPECT_FALSE( node->flag_error_read_message );
+    EXPECT_FALSE( node->read_io_error_flag );
+
+    EXPECT_EQ( mngr.write_outputs(), 1 );
+    Mock::VerifyAndClearExpectations( &mngr );
+
+    G_PAC_INFO()->par[ PAC_info::P_IO_COMBINED_EXCHANGE ] = 0;
+    }
+
 // Test that status register field exists and can be set/read for
 // different node types.
 TEST( io_node, status_register_only_for_phoenix )